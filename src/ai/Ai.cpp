@@ -0,0 +1,43 @@
+#include "ai/Ai.h"
+
+#include <chrono>
+
+#include "ai/AiMeter.h"
+
+static void dispatch_ai(hl::GameState &gs, hl::PlayerState &player)
+{
+    using namespace hl;
+
+    switch (player.ai)
+    {
+    case AiKind::Human:
+        break;
+    case AiKind::Albert:
+        update_albert_ai(gs, player);
+        break;
+    case AiKind::Table:
+        update_table_ai(gs, player);
+        break;
+    case AiKind::Rollout:
+        update_rollout_ai(gs, player);
+        break;
+    // TODO: Add other AIs (Beatrix, Chloe, Dimitri) later
+    }
+}
+
+void update_ai(hl::GameState &gs, hl::PlayerState &player)
+{
+    if (!gs.ai_meter || player.ai == hl::AiKind::Human)
+    {
+        dispatch_ai(gs, player);
+        return;
+    }
+    const uint64_t draws0 = gs.rng_draws, cells0 = gs.cells_swept;
+    const auto t0 = std::chrono::steady_clock::now();
+    dispatch_ai(gs, player);
+    hl::AiCost cost;
+    cost.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    cost.rng_draws = static_cast<uint32_t>(gs.rng_draws - draws0);
+    cost.cells = static_cast<uint32_t>(gs.cells_swept - cells0);
+    gs.ai_meter->record(player, cost);
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "core/Game.h"
+
+// ----------------- AI Update -----------------
+// Runs the AI assigned to player (no-op for humans); called once per tick
+void update_ai(hl::GameState &gs, hl::PlayerState &player);
+
+// Albert: rotate Next every rotation_average +/- rotation_half_interval ticks
+void update_albert_ai(hl::GameState &gs, hl::PlayerState &player);
+
+// Table: O(1) per tick; rotates when the win table rates one rotation
+// higher than staying (see ai/WinTable.h)
+void update_table_ai(hl::GameState &gs, hl::PlayerState &player);
+
+// Rollout: plays both choices out in copies of gs; the reference the
+// table is measured against, thousands of times slower
+void update_rollout_ai(hl::GameState &gs, hl::PlayerState &player);
@@ -0,0 +1,136 @@
+#include "ai/AiMeter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace hl
+{
+    std::string ai_label(AiKind kind, const AlbertConfig &albert)
+    {
+        switch (kind)
+        {
+        case AiKind::Albert:
+            return "albert " + std::to_string(albert.rotation_average) + ":" +
+                   std::to_string(albert.rotation_half_interval);
+        case AiKind::Table:
+            return "table";
+        case AiKind::Rollout:
+            return "rollout";
+        case AiKind::Human:
+            break;
+        }
+        return "human";
+    }
+
+    // Values below 16 get a bucket each, then 8 buckets per doubling
+    void AiMeter::Histogram::add(double v)
+    {
+        int b = static_cast<int>(v);
+        if (v >= 16.0)
+            b = 16 + static_cast<int>(8.0 * std::log2(v / 16.0));
+        counts[std::clamp(b, 0, BUCKETS - 1)]++;
+        n++;
+        sum += v;
+        max = std::max(max, v);
+    }
+
+    void AiMeter::Histogram::merge(const Histogram &o)
+    {
+        for (int b = 0; b < BUCKETS; ++b)
+            counts[b] += o.counts[b];
+        n += o.n;
+        sum += o.sum;
+        max = std::max(max, o.max);
+    }
+
+    double AiMeter::Histogram::quantile(double q) const
+    {
+        if (n == 0)
+            return 0.0;
+        const uint64_t rank = static_cast<uint64_t>(std::ceil(q * n));
+        uint64_t seen = 0;
+        for (int b = 0; b < BUCKETS; ++b)
+        {
+            seen += counts[b];
+            if (seen >= std::max<uint64_t>(rank, 1))
+            {
+                // Upper edge of the bucket, never above what was seen
+                const double hi = b < 16 ? b : 16.0 * std::exp2((b - 15) / 8.0);
+                return std::min(hi, max);
+            }
+        }
+        return max;
+    }
+
+    AiMeter::Entry &AiMeter::entry(AiKind kind, const AlbertConfig &albert)
+    {
+        for (auto &e : entries_)
+        {
+            if (e.kind == kind && e.albert.rotation_average == albert.rotation_average &&
+                e.albert.rotation_half_interval == albert.rotation_half_interval)
+                return e;
+        }
+        Entry e;
+        e.kind = kind;
+        e.albert = albert;
+        e.name = ai_label(kind, albert);
+        entries_.push_back(e);
+        return entries_.back();
+    }
+
+    void AiMeter::record(const PlayerState &player, const AiCost &cost)
+    {
+        Entry &e = entry(player.ai, player.albert);
+        const double us = cost.seconds * 1e6;
+        e.ns.add(cost.seconds * 1e9);
+        e.draws.add(cost.rng_draws);
+        e.cells.add(cost.cells);
+
+        if (!enforce || failed())
+            return;
+        char buf[160];
+        if (budget.max_us > 0.0 && us > budget.max_us)
+            std::snprintf(buf, sizeof(buf), "%.1f us > %.1f us budget", us, budget.max_us);
+        else if (budget.max_draws > 0 && cost.rng_draws > budget.max_draws)
+            std::snprintf(buf, sizeof(buf), "%u RNG draws > %u budget", cost.rng_draws, budget.max_draws);
+        else if (budget.max_cells > 0 && cost.cells > budget.max_cells)
+            std::snprintf(buf, sizeof(buf), "%u cells > %u budget", cost.cells, budget.max_cells);
+        else
+            return;
+        violation_ = e.name + " (player " + std::to_string(player.id.v) + "): " + buf;
+    }
+
+    void AiMeter::merge(const AiMeter &other)
+    {
+        std::lock_guard<std::mutex> lock(merge_mutex_);
+        for (const auto &o : other.entries_)
+        {
+            Entry &e = entry(o.kind, o.albert);
+            e.ns.merge(o.ns);
+            e.draws.merge(o.draws);
+            e.cells.merge(o.cells);
+        }
+        if (violation_.empty())
+            violation_ = other.violation_;
+    }
+
+    void AiMeter::report(std::FILE *out) const
+    {
+        std::fprintf(out, "%-18s %-9s %10s %10s %10s %10s %12s\n", "ai", "per tick", "p50", "p99", "max", "mean",
+                     "updates");
+        for (const auto &e : entries_)
+        {
+            auto row = [&](const char *what, const Histogram &h, double scale)
+            {
+                std::fprintf(out, "%-18s %-9s %10.1f %10.1f %10.1f %10.2f %12llu\n", e.name.c_str(), what,
+                             h.quantile(0.5) * scale, h.quantile(0.99) * scale, h.max * scale,
+                             h.n ? h.sum / h.n * scale : 0.0, static_cast<unsigned long long>(h.n));
+            };
+            row("us", e.ns, 1e-3);
+            row("rng draws", e.draws, 1.0);
+            row("cells", e.cells, 1.0);
+        }
+        if (failed())
+            std::fprintf(out, "AI BUDGET EXCEEDED: %s\n", violation_.c_str());
+    }
+}
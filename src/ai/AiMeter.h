@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/Game.h"
+
+// ----------------- AI Cost Accounting -----------------
+namespace hl
+{
+    // Cost of one AI update: wall time, game RNG draws and grid cells
+    // visited (rotation repaints sweep the whole grid)
+    struct AiCost
+    {
+        double seconds{0.0};
+        uint32_t rng_draws{0};
+        uint32_t cells{0};
+    };
+
+    // Largest cost one update may have; 0 leaves a measure unchecked
+    struct AiBudget
+    {
+        double max_us{0.0};
+        uint32_t max_draws{0};
+        uint32_t max_cells{0};
+    };
+
+    // Per-AI cost histograms, keyed by AI kind and tuning. update_ai records
+    // into gs.ai_meter once per player and tick. Percentiles come from
+    // log-spaced buckets (exact below 16, rounded up by at most ~9% above)
+    // clipped to the observed max. With enforce on, the first update over
+    // budget is kept as the violation and tools fail the run.
+    class AiMeter
+    {
+    public:
+        AiBudget budget{};
+        bool enforce{false};
+
+        void record(const PlayerState &player, const AiCost &cost);
+
+        // Adds another meter's samples (e.g. one game's); thread-safe
+        void merge(const AiMeter &other);
+
+        bool failed() const { return !violation_.empty(); }
+        const std::string &violation() const { return violation_; }
+
+        // One row per AI and measure: p50, p99, max and mean per tick
+        void report(std::FILE *out) const;
+
+        struct Histogram
+        {
+            static constexpr int BUCKETS = 320;
+            std::array<uint64_t, BUCKETS> counts{};
+            uint64_t n{0};
+            double sum{0.0};
+            double max{0.0};
+
+            void add(double v);
+            void merge(const Histogram &o);
+            double quantile(double q) const;
+        };
+
+    private:
+        struct Entry
+        {
+            AiKind kind{AiKind::Human};
+            AlbertConfig albert{};
+            std::string name;
+            Histogram ns, draws, cells;
+        };
+
+        Entry &entry(AiKind kind, const AlbertConfig &albert);
+
+        std::vector<Entry> entries_;
+        std::string violation_;
+        std::mutex merge_mutex_;
+    };
+
+    // "albert 58:43", "table", "rollout", "human"
+    std::string ai_label(AiKind kind, const AlbertConfig &albert);
+}
@@ -0,0 +1,37 @@
+#include "ai/Ai.h"
+
+#include <algorithm>
+
+#include "util/Rng.h"
+
+void update_albert_ai(hl::GameState &gs, hl::PlayerState &player)
+{
+    using namespace hl;
+    
+    // Albert: rotate based on configurable interval
+    if (player.rot_period == 0) {
+        // Initialize random rotation period using configured parameters
+        uint16_t r = rngu(gs);
+        int min_interval = player.albert.rotation_average - player.albert.rotation_half_interval;
+        int max_interval = player.albert.rotation_average + player.albert.rotation_half_interval;
+        // Ensure minimum of 1 tick
+        min_interval = std::max(1, min_interval);
+        int range = max_interval - min_interval + 1;
+        player.rot_period = min_interval + (r % range);
+    }
+    
+    // Check if it's time to rotate
+    if (gs.tick - player.last_rot_tick >= player.rot_period) {
+        // Rotate to next piece
+        rotate_player(gs, player);
+        
+        // Pick new random interval for next rotation using configured parameters
+        uint16_t r = rngu(gs);
+        int min_interval = player.albert.rotation_average - player.albert.rotation_half_interval;
+        int max_interval = player.albert.rotation_average + player.albert.rotation_half_interval;
+        // Ensure minimum of 1 tick
+        min_interval = std::max(1, min_interval);
+        int range = max_interval - min_interval + 1;
+        player.rot_period = min_interval + (r % range);
+    }
+}
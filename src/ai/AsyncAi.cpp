@@ -0,0 +1,201 @@
+#include "ai/AsyncAi.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+#include "ai/Ai.h"
+#include "util/Rng.h"
+
+namespace hl
+{
+    AiDecision decide_ai(GameState snapshot, int player, uint64_t seed)
+    {
+        snapshot.profiler = nullptr;
+        snapshot.async_ai = nullptr;
+        snapshot.ai_meter = nullptr;
+        // Reseed the copy's RNG from (seed, tick, player), so the AI's draws
+        // are unrelated to the pairs the live game draws next, however many
+        // it takes. The copy keeps the game's generator kind and stride.
+        Rng64 mix{seed ^ (snapshot.tick * 0xD1B54A32D192ED03ull) ^
+                  (static_cast<uint64_t>(player) * 0x8CB92BA72F3D8DD7ull)};
+        const uint64_t r = mix.next();
+        snapshot.rng16 = static_cast<uint16_t>(r) ? static_cast<uint16_t>(r) : 0xACE1; // zero locks the LFSR
+        std::seed_seq seq{static_cast<uint32_t>(r >> 16), static_cast<uint32_t>(r >> 48)};
+        snapshot.system_rng.seed(seq);
+
+        PlayerState &p = snapshot.players[player];
+        const int before = static_cast<int>(p.current);
+        const uint64_t draws0 = snapshot.rng_draws, cells0 = snapshot.cells_swept;
+        const auto t0 = std::chrono::steady_clock::now();
+        update_ai(snapshot, p);
+
+        AiDecision d;
+        d.cost.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        d.cost.rng_draws = static_cast<uint32_t>(snapshot.rng_draws - draws0);
+        d.cost.cells = static_cast<uint32_t>(snapshot.cells_swept - cells0);
+        d.rotations = (static_cast<int>(p.current) - before + 3) % 3;
+        d.rot_period = p.rot_period;
+        d.accel_ctr = p.accel_ctr;
+        return d;
+    }
+
+    AiScheduler::AiScheduler(const AsyncAiConfig &cfg) : cfg_(cfg)
+    {
+        cfg_.latency = std::max(1, cfg_.latency);
+        for (int t = 0; t < std::max(1, cfg_.threads); ++t)
+            workers_.emplace_back([this]() { worker(); });
+    }
+
+    AiScheduler::~AiScheduler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        work_cv_.notify_all();
+        for (auto &t : workers_)
+            t.join();
+    }
+
+    void AiScheduler::worker()
+    {
+        for (;;)
+        {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                work_cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+                if (stop_)
+                    return;
+                job = std::move(queue_.front());
+                queue_.pop_front();
+                if (job->cancelled)
+                    continue;
+            }
+            const AiDecision d = decide_ai(job->snapshot, job->player, cfg_.seed);
+            const double ms = d.cost.seconds * 1e3;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                job->decision = d;
+                job->compute_ms = ms;
+                job->done = true;
+            }
+            done_cv_.notify_all();
+        }
+    }
+
+    void AiScheduler::submit(const GameState &gs, int player)
+    {
+        auto job = std::make_shared<Job>();
+        job->snapshot = gs;
+        job->player = player;
+        Pending &p = pending_[player];
+        p.job = job;
+        p.submitted = gs.tick;
+        p.due = static_cast<uint16_t>(gs.tick + cfg_.latency);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(job));
+        }
+        work_cv_.notify_one();
+    }
+
+    void AiScheduler::cancel(Pending &p)
+    {
+        if (p.job)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            p.job->cancelled = true;
+            if (!p.job->done)
+            {
+                auto it = std::find(queue_.begin(), queue_.end(), p.job);
+                if (it != queue_.end())
+                    queue_.erase(it);
+            }
+        }
+        p = Pending{};
+    }
+
+    bool AiScheduler::wait_for(const Job &job, bool block)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (block)
+            done_cv_.wait(lock, [&job]() { return job.done; });
+        return job.done;
+    }
+
+    void AiScheduler::apply(GameState &gs, PlayerState &player, const AiDecision &d)
+    {
+        for (int r = 0; r < d.rotations; ++r)
+            rotate_player(gs, player);
+        player.rot_period = d.rot_period;
+        player.accel_ctr = d.accel_ctr;
+        if (gs.ai_meter)
+            gs.ai_meter->record(player, d.cost);
+    }
+
+    void AiScheduler::update(GameState &gs)
+    {
+        pending_.resize(gs.players.size());
+        for (size_t i = 0; i < gs.players.size(); ++i)
+        {
+            PlayerState &player = gs.players[i];
+            Pending &p = pending_[i];
+            if (player.ai == AiKind::Human)
+            {
+                cancel(p);
+                continue;
+            }
+            // The game restarted since the request was made
+            if (p.job && p.submitted > gs.tick)
+                cancel(p);
+
+            if (p.job && static_cast<uint16_t>(gs.tick - p.submitted) >= cfg_.latency)
+            {
+                const int id = static_cast<int>(i);
+                bool missed;
+                if (cfg_.timing == AiTiming::Lockstep)
+                {
+                    wait_for(*p.job, true);
+                    while (replay_next_ < replay_.size() && replay_[replay_next_].tick < p.due)
+                        replay_next_++;
+                    missed = false;
+                    for (size_t r = replay_next_; r < replay_.size() && replay_[r].tick == p.due; ++r)
+                        missed = missed || replay_[r].player == id;
+                }
+                else
+                    missed = !wait_for(*p.job, false) || p.job->compute_ms > cfg_.deadline_ms;
+
+                if (missed)
+                {
+                    misses_.push_back(AiMiss{p.due, id});
+                    cancel(p);
+                    if (cfg_.fallback == AiFallback::Inline)
+                        apply(gs, player, decide_ai(gs, id, cfg_.seed));
+                }
+                else
+                {
+                    apply(gs, player, p.job->decision);
+                    decisions_++;
+                }
+                p = Pending{};
+            }
+            if (!p.job)
+                submit(gs, static_cast<int>(i));
+        }
+    }
+
+    void AiScheduler::reset()
+    {
+        for (Pending &p : pending_)
+            cancel(p);
+        pending_.clear();
+    }
+
+    void AiScheduler::set_replay_misses(std::vector<AiMiss> misses)
+    {
+        replay_ = std::move(misses);
+        replay_next_ = 0;
+    }
+}
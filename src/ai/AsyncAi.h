@@ -0,0 +1,134 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ai/AiMeter.h"
+#include "core/Game.h"
+
+// ----------------- Asynchronous AI -----------------
+// AI decisions computed off the tick loop. At tick T the scheduler copies the
+// game state and runs the player's update_ai on the copy on a worker thread
+// (drawing from its own stream, see decide_ai). The decision - how many
+// times to rotate and the AI's timer fields - is applied at tick T + latency,
+// and the next request is made from that tick's state, so each AI has one
+// request in flight. A missed request is cancelled: dropped from the queue
+// if it has not started, its result ignored if it has. The live RNG is not
+// touched by async AIs.
+namespace hl
+{
+    enum class AiFallback : uint8_t
+    {
+        Hold,   // a missed decision does nothing; the AI keeps its timers
+        Inline, // compute the decision on the tick thread (blocks)
+    };
+
+    enum class AiTiming : uint8_t
+    {
+        // Never waits: a decision not ready at its tick, or that took longer
+        // than deadline_ms, is a miss and is logged
+        Live,
+        // Waits for every decision and misses exactly the logged ones, so a
+        // replay of a Live game with its log gives the same game
+        Lockstep,
+    };
+
+    struct AsyncAiConfig
+    {
+        int latency{2};          // ticks between a request and its decision (>= 1)
+        double deadline_ms{40.0}; // hard limit on one decision's compute time
+        AiFallback fallback{AiFallback::Hold};
+        AiTiming timing{AiTiming::Live};
+        int threads{1};
+        uint64_t seed{1}; // AI decision streams, mixed with tick and player
+    };
+
+    struct AiMiss
+    {
+        uint16_t tick{0}; // tick the decision was due
+        int player{0};
+        bool operator==(const AiMiss &o) const { return tick == o.tick && player == o.player; }
+    };
+
+    // What running an AI's update on a snapshot did to its player
+    struct AiDecision
+    {
+        int rotations{0};
+        uint8_t rot_period{0};
+        uint8_t accel_ctr{0};
+        AiCost cost; // of computing it, recorded in gs.ai_meter when applied
+    };
+
+    // Runs update_ai for snapshot.players[player] on the snapshot and reports
+    // its effect. The snapshot's RNG is first reseeded from (seed, tick,
+    // player), so the same snapshot and seed always give the same decision.
+    AiDecision decide_ai(GameState snapshot, int player, uint64_t seed);
+
+    class AiScheduler
+    {
+    public:
+        explicit AiScheduler(const AsyncAiConfig &cfg);
+        ~AiScheduler();
+        AiScheduler(const AiScheduler &) = delete;
+        AiScheduler &operator=(const AiScheduler &) = delete;
+
+        const AsyncAiConfig &config() const { return cfg_; }
+
+        // Called once per tick instead of update_ai for every AI player:
+        // applies the decisions due now (or their fallback), then submits
+        // new requests. Restarted games (tick went back) drop old requests.
+        void update(GameState &gs);
+
+        // Drops all requests in flight, e.g. when a level is reloaded
+        void reset();
+
+        // Misses so far, in tick order; Lockstep replays take them here
+        const std::vector<AiMiss> &misses() const { return misses_; }
+        void set_replay_misses(std::vector<AiMiss> misses);
+
+        long long decisions() const { return decisions_; }
+
+    private:
+        struct Job
+        {
+            GameState snapshot;
+            int player{0};
+            AiDecision decision;
+            double compute_ms{0.0};
+            bool done{false};
+            bool cancelled{false}; // missed or dropped: workers skip it if still queued
+        };
+        struct Pending
+        {
+            std::shared_ptr<Job> job;
+            uint16_t submitted{0};
+            uint16_t due{0};
+        };
+
+        void worker();
+        void submit(const GameState &gs, int player);
+        // Forgets p's job; takes it out of the queue if no worker has started
+        // it, so each player has at most one job queued
+        void cancel(Pending &p);
+        bool wait_for(const Job &job, bool block);
+        static void apply(GameState &gs, PlayerState &player, const AiDecision &d);
+
+        AsyncAiConfig cfg_;
+        std::vector<Pending> pending_; // by player index
+        std::vector<AiMiss> misses_;
+        std::vector<AiMiss> replay_;
+        size_t replay_next_{0};
+        long long decisions_{0};
+
+        std::mutex mutex_;
+        std::condition_variable work_cv_, done_cv_;
+        std::deque<std::shared_ptr<Job>> queue_;
+        std::vector<std::thread> workers_;
+        bool stop_{false};
+    };
+}
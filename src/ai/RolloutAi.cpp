@@ -0,0 +1,70 @@
+#include "ai/Ai.h"
+
+#include <algorithm>
+
+#include "util/Rng.h"
+
+// Player id's result of a rollout: 1 won, 0 lost, otherwise its share of
+// the two largest territories at the horizon
+static double rollout_score(const hl::GameState &sim, int id)
+{
+    using namespace hl;
+
+    if (sim.phase == Phase::Won)
+        return id == 0 ? 1.0 : 0.0;
+    if (sim.phase == Phase::Lost)
+        return id == 0 ? 0.0 : 1.0;
+    int rival = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        if (i != id)
+            rival = std::max(rival, sim.territory[i]);
+    }
+    const int own = sim.territory[id];
+    return own + rival > 0 ? static_cast<double>(own) / (own + rival) : 0.5;
+}
+
+void update_rollout_ai(hl::GameState &gs, hl::PlayerState &player)
+{
+    using namespace hl;
+
+    const RolloutConfig &cfg = player.rollout;
+    if (cfg.rollouts <= 0 || cfg.think_every <= 0 || gs.tick % cfg.think_every != 0 ||
+        static_cast<uint16_t>(gs.tick - player.last_rot_tick) < cfg.min_interval)
+        return;
+
+    // Seeds depend on the game so far but draw nothing from its RNG, so
+    // thinking does not change the game's own pair draws
+    Rng64 seeds{gs.rng_draws ^ (static_cast<uint64_t>(gs.tick) << 40) ^ (static_cast<uint64_t>(player.id.v) << 56)};
+    double score[2] = {0.0, 0.0};
+    for (int r = 0; r < cfg.rollouts; ++r)
+    {
+        const uint64_t seed = seeds.next();
+        for (int choice = 0; choice < 2; ++choice)
+        {
+            GameState sim = gs;
+            sim.profiler = nullptr;
+            sim.async_ai = nullptr;
+            sim.ai_meter = nullptr;
+            sim.use_system_rng = true;
+            sim.system_rng.seed(static_cast<uint32_t>(seed ^ (seed >> 32)));
+            for (PlayerState &p : sim.players)
+            {
+                if (p.ai != AiKind::Human)
+                {
+                    p.ai = AiKind::Albert;
+                    p.albert = AlbertConfig{};
+                }
+            }
+            PlayerState &self = sim.players[player.id.v];
+            if (choice)
+                rotate_player(sim, self);
+            self.rot_period = 0; // Albert draws a fresh interval from here
+            for (int t = 0; t < cfg.horizon && sim.phase == Phase::Playing; ++t)
+                step_fixed(sim);
+            score[choice] += rollout_score(sim, player.id.v);
+        }
+    }
+    if (score[1] > score[0])
+        rotate_player(gs, player);
+}
@@ -0,0 +1,18 @@
+#include "ai/Ai.h"
+
+#include "ai/WinTable.h"
+
+void update_table_ai(hl::GameState &gs, hl::PlayerState &player)
+{
+    using namespace hl;
+
+    const TableAiConfig &cfg = player.table;
+    if (!cfg.table || static_cast<uint16_t>(gs.tick - player.last_rot_tick) < cfg.min_interval)
+        return;
+    // One rotation is the only other move this tick; the one after that
+    // is considered again once the interval has passed
+    const int stay = win_table_index(gs, player, 0);
+    const int turn = win_table_index(gs, player, 1);
+    if (cfg.table->q(turn) > cfg.table->q(stay))
+        rotate_player(gs, player);
+}
@@ -0,0 +1,121 @@
+#include "ai/WinTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace hl
+{
+    int WinTable::index(int own, int opponent, int live_edges, int relation, int since)
+    {
+        const int total = own + opponent;
+        const int share = total > 0 ? std::min(SHARES - 1, own * SHARES / total) : SHARES / 2;
+        const int frontier = std::min(FRONTIERS - 1, live_edges / EDGES_PER_FRONTIER);
+        const int s = std::min(SINCES - 1, since / TICKS_PER_SINCE);
+        return ((share * FRONTIERS + frontier) * RELATIONS + relation) * SINCES + s;
+    }
+
+    void WinTable::set(int i, double p)
+    {
+        q_[i] = static_cast<uint8_t>(std::lround(std::clamp(p, 0.0, 1.0) * 255.0));
+    }
+
+    bool WinTable::load(const std::string &path, std::string &err)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            err = "cannot open " + path;
+            return false;
+        }
+        std::string line;
+        bool dims = false;
+        int n = 0;
+        while (std::getline(in, line))
+        {
+            if (line.empty() || line[0] == '#')
+                continue;
+            if (!dims)
+            {
+                std::istringstream ss(line);
+                std::string word;
+                int d[6] = {};
+                ss >> word >> d[0] >> d[1] >> d[2] >> d[3] >> d[4] >> d[5];
+                if (word != "dims" || d[0] != SHARES || d[1] != FRONTIERS || d[2] != RELATIONS ||
+                    d[3] != SINCES || d[4] != EDGES_PER_FRONTIER || d[5] != TICKS_PER_SINCE)
+                {
+                    err = path + ": expected \"dims 16 8 3 8 12 16\", got \"" + line + "\"";
+                    return false;
+                }
+                dims = true;
+                continue;
+            }
+            for (size_t c = 0; c + 1 < line.size(); c += 2)
+            {
+                unsigned v = 0;
+                if (n >= SIZE || std::sscanf(line.c_str() + c, "%2x", &v) != 1)
+                {
+                    err = path + ": bad table data";
+                    return false;
+                }
+                q_[n++] = static_cast<uint8_t>(v);
+            }
+        }
+        if (n != SIZE)
+        {
+            err = path + ": " + std::to_string(n) + " entries, expected " + std::to_string(SIZE);
+            return false;
+        }
+        return true;
+    }
+
+    bool WinTable::save(const std::string &path, const std::string &comment, std::string &err) const
+    {
+        std::FILE *f = std::fopen(path.c_str(), "w");
+        if (!f)
+        {
+            err = "cannot write " + path;
+            return false;
+        }
+        std::fprintf(f, "# Win table for the Table AI: P(win) x 255 for one side, indexed by\n"
+                        "# share (16 buckets of own / (own + opponent) symbols), frontier (live\n"
+                        "# edges / 12, last bucket open), relation (equal, own wins, opponent wins)\n"
+                        "# and ticks since the opponent rotated (/ 16, last bucket open).\n"
+                        "# One line per share and frontier. Regenerate with handlords_wintable --build.\n");
+        if (!comment.empty())
+            std::fprintf(f, "# %s\n", comment.c_str());
+        std::fprintf(f, "dims %d %d %d %d %d %d\n", SHARES, FRONTIERS, RELATIONS, SINCES, EDGES_PER_FRONTIER,
+                     TICKS_PER_SINCE);
+        const int row = RELATIONS * SINCES;
+        for (int i = 0; i < SIZE; i += row)
+        {
+            for (int j = 0; j < row; ++j)
+                std::fprintf(f, "%02x", q_[i + j]);
+            std::fprintf(f, "\n");
+        }
+        const bool ok = std::fclose(f) == 0;
+        if (!ok)
+            err = "cannot write " + path;
+        return ok;
+    }
+
+    int win_table_index(const GameState &gs, const PlayerState &player, int rotations)
+    {
+        const PlayerState *opponent = nullptr;
+        for (const PlayerState &p : gs.players)
+        {
+            if (p.id.v != player.id.v && p.id.v < 4 &&
+                (!opponent || gs.territory[p.id.v] > gs.territory[opponent->id.v]))
+                opponent = &p;
+        }
+        if (!opponent || player.id.v >= 4)
+            return 0;
+        const int own = static_cast<int>(player.current) + rotations;
+        const int relation = ((own - static_cast<int>(opponent->current)) % 3 + 3) % 3;
+        const int since = static_cast<uint16_t>(gs.tick - opponent->last_rot_tick);
+        return WinTable::index(gs.territory[player.id.v], gs.territory[opponent->id.v], gs.activity.live_edges(),
+                               relation, since);
+    }
+}
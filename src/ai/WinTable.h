@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "core/Game.h"
+
+// ----------------- Win-Probability Table -----------------
+// P(win) for one side of a two-player game, bucketed by what that side can
+// see cheaply every tick: its share of the two sides' symbols, the frontier
+// (live edges, kept by the activity map), how the pieces relate, and the
+// ticks since the opponent last rotated. One byte per bucket (P x 255),
+// 3 KB in all, so a lookup is a few integer ops and one load. Built offline
+// from batch games by handlords_wintable --build; data/wintable.txt ships
+// with the repo.
+namespace hl
+{
+    class WinTable
+    {
+    public:
+        static constexpr int SHARES = 16;             // own / (own + opponent) symbols
+        static constexpr int FRONTIERS = 8;           // live edges, EDGES_PER_FRONTIER per bucket
+        static constexpr int EDGES_PER_FRONTIER = 12;
+        static constexpr int RELATIONS = 3;           // 0 = equal, 1 = own piece wins, 2 = opponent's wins
+        static constexpr int SINCES = 8;              // ticks since the opponent rotated
+        static constexpr int TICKS_PER_SINCE = 16;
+        static constexpr int SIZE = SHARES * FRONTIERS * RELATIONS * SINCES;
+
+        WinTable() { q_.fill(128); }
+
+        // Bucket of a position; the last buckets of frontier and since are open-ended
+        static int index(int own, int opponent, int live_edges, int relation, int since);
+
+        uint8_t q(int i) const { return q_[i]; }
+        double p(int i) const { return q_[i] / 255.0; }
+        void set(int i, double p);
+
+        // Text file: '#' comments, a "dims" line, then one hex line per share and frontier
+        bool load(const std::string &path, std::string &err);
+        bool save(const std::string &path, const std::string &comment, std::string &err) const;
+
+    private:
+        std::array<uint8_t, SIZE> q_{};
+    };
+
+    // Bucket of player's position after the census of gs.tick, as if its
+    // piece were advanced `rotations` times; the opponent is the largest rival
+    int win_table_index(const GameState &gs, const PlayerState &player, int rotations);
+}
@@ -0,0 +1,17 @@
+#include "core/Activity.h"
+
+#include <climits>
+#include <cmath>
+
+namespace hl
+{
+    long long skip_draws(double p, double u)
+    {
+        if (p >= 1.0)
+            return 0;
+        if (p <= 0.0)
+            return LLONG_MAX;
+        const double g = std::floor(std::log(u) / std::log1p(-p));
+        return g >= static_cast<double>(LLONG_MAX) ? LLONG_MAX : static_cast<long long>(g);
+    }
+}
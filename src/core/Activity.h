@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ----------------- Activity Map -----------------
+// Coarse map of which square tiles of an arena can still change.
+//
+// An edge between two adjacent cells is "live" when its codes differ and
+// neither is a wall (see PackedGrid.h for codes): only live edges can do
+// anything under rules 1-6. Each tile counts the live edges touching its
+// cells; a tile with no live edges is quiescent. Every live edge therefore
+// has both ends in active tiles, and a pair drawn from a quiescent tile is a
+// no-op, so samplers may skip quiescent tiles as long as they account for
+// the skipped draws (see skip_draws()).
+namespace hl
+{
+    inline bool live_edge(uint8_t a, uint8_t b)
+    {
+        return a != b && a != 1 && b != 1; // 1 = PACKED_WALL
+    }
+
+    class ActivityMap
+    {
+    public:
+        ActivityMap() = default;
+        // With record_deactivated, tiles going quiescent are queued for take_deactivated()
+        ActivityMap(int tiles_x, int tiles_y, bool record_deactivated = false)
+            : tiles_x_(tiles_x), tiles_y_(tiles_y), record_(record_deactivated),
+              live_(static_cast<size_t>(tiles_x) * tiles_y, 0),
+              slot_(static_cast<size_t>(tiles_x) * tiles_y, -1)
+        {
+        }
+
+        int tiles_x() const { return tiles_x_; }
+        int tiles_y() const { return tiles_y_; }
+        int tile_count() const { return static_cast<int>(live_.size()); }
+        int active_count() const { return static_cast<int>(active_.size()); }
+        bool active(int tile) const { return slot_[tile] >= 0; }
+        uint32_t live(int tile) const { return live_[tile]; }
+        uint32_t live_edges() const { return live_edges_; } // the frontier: all live edges
+        int active_tile(int i) const { return active_[i]; }
+
+        // Adds delta live edges to a tile, moving it in or out of the active set
+        void add_live(int tile, int delta)
+        {
+            const uint32_t before = live_[tile];
+            live_[tile] = before + delta;
+            if (before == 0 && live_[tile] > 0)
+            {
+                slot_[tile] = static_cast<int>(active_.size());
+                active_.push_back(tile);
+                activations_++;
+            }
+            else if (before > 0 && live_[tile] == 0)
+            {
+                const int s = slot_[tile];
+                active_[s] = active_.back();
+                slot_[active_[s]] = s;
+                active_.pop_back();
+                slot_[tile] = -1;
+                if (record_)
+                    deactivated_.push_back(tile);
+            }
+        }
+
+        // Live-edge bookkeeping for one edge whose code pair changed
+        void edge_changed(int tile_a, int tile_b, bool was_live, bool is_live)
+        {
+            if (was_live == is_live)
+                return;
+            const int d = is_live ? 1 : -1;
+            live_edges_ += d;
+            add_live(tile_a, d);
+            if (tile_b != tile_a)
+                add_live(tile_b, d);
+        }
+
+        // Tiles that went quiescent since the last call (may have re-activated since)
+        std::vector<int> take_deactivated()
+        {
+            std::vector<int> out;
+            out.swap(deactivated_);
+            return out;
+        }
+
+        uint64_t activations() const { return activations_; }
+
+    private:
+        int tiles_x_{0};
+        int tiles_y_{0};
+        bool record_{false};
+        std::vector<uint32_t> live_;
+        uint32_t live_edges_{0};
+        std::vector<int> slot_;   // index into active_, -1 when quiescent
+        std::vector<int> active_; // dense list for O(1) uniform picks
+        std::vector<int> deactivated_;
+        uint64_t activations_{0};
+    };
+
+    // Number of full-arena draws that land outside the active area before the
+    // next one lands inside it: Geometric(p) with p = active cells / all cells.
+    // u must be uniform in (0, 1]. Skipping these draws keeps the pair rate
+    // exact, because each skipped draw would have been a no-op.
+    long long skip_draws(double p, double u);
+}
@@ -0,0 +1,150 @@
+#include "core/Game.h"
+
+#include "ai/Ai.h"
+#include "ai/AsyncAi.h"
+#include "core/Rules.h"
+#include "util/Profiler.h"
+
+// Phase id in gs.profiler, registered on first use
+static int profile_phase(hl::GameState &gs, const char *name)
+{
+    return gs.profiler ? gs.profiler->phase(name) : 0;
+}
+
+void rotate_player(hl::GameState &gs, hl::PlayerState &player)
+{
+    using namespace hl;
+
+    player.current = static_cast<Piece>((static_cast<int>(player.current) + 1) % 3);
+    player.last_rot_tick = gs.tick;
+
+    for (auto &cell : gs.grid.cells)
+    {
+        if (cell.kind == CellKind::Symbol && cell.owner.v == player.id.v)
+            cell.piece = player.current;
+    }
+    gs.cells_swept += gs.grid.cells.size();
+}
+
+void begin_tick(hl::GameState &gs)
+{
+    gs.tick++;
+
+    // Reset tick losses at START of tick
+    for (auto &player : gs.players)
+    {
+        player.tick_losses = 0;
+    }
+
+    gs.slice = hl::TickSlice{};
+    gs.slice.open = true;
+    gs.slice.total = pair_budget(gs);
+}
+
+int pair_budget(const hl::GameState &gs)
+{
+    using namespace hl;
+
+    switch (gs.cfg.pair_rate)
+    {
+    case PairRate::PerOpenCell:
+        return static_cast<int>(gs.cfg.pairs_per_open_cell * gs.open_cells + 0.5);
+    case PairRate::PerFrontier:
+        return static_cast<int>(gs.cfg.pairs_per_frontier_edge * gs.activity.live_edges() + 0.5);
+    case PairRate::Fixed:
+        break;
+    }
+    return gs.cfg.pairs_per_tick;
+}
+
+int resolve_tick_slice(hl::GameState &gs, int n)
+{
+    hl::Profiler::Scope s(gs.profiler, profile_phase(gs, "pairs"));
+    return resolve_pairs_slice(gs, gs.slice, n);
+}
+
+void finish_tick(hl::GameState &gs)
+{
+    using namespace hl;
+
+    resolve_tick_slice(gs, gs.slice.total);
+    gs.slice.open = false;
+
+    // Check win/lose conditions
+    int player_counts[4] = {0, 0, 0, 0};
+    {
+        Profiler::Scope s(gs.profiler, profile_phase(gs, "census"));
+        for (int y = 0; y < hl::ARENA_H; ++y) {
+            for (int x = 0; x < hl::ARENA_W; ++x) {
+                const auto &c = gs.grid.at(x, y);
+                if (c.kind == CellKind::Symbol && c.owner.v < 4) {
+                    player_counts[c.owner.v]++;
+                }
+            }
+        }
+    }
+    for (int i = 0; i < 4; ++i)
+        gs.territory[i] = player_counts[i];
+    
+    // Check if any player has won (controls all territory)
+    if (player_counts[0] == 0 && player_counts[1] > 0) {
+        gs.phase = Phase::Lost;
+    } else if (player_counts[1] == 0 && player_counts[0] > 0) {
+        gs.phase = Phase::Won;
+    }
+
+    // Run AI updates
+    {
+        Profiler::Scope s(gs.profiler, profile_phase(gs, "ai"));
+        if (gs.async_ai) {
+            gs.async_ai->update(gs);
+        } else {
+            for (auto &player : gs.players) {
+                update_ai(gs, player);
+            }
+        }
+    }
+
+    // Rotations requested during the tick land between it and the next
+    for (auto &player : gs.players)
+    {
+        if (player.rotate_pending)
+        {
+            player.rotate_pending = false;
+            rotate_player(gs, player);
+        }
+    }
+    if (gs.profiler)
+        gs.profiler->end_tick();
+}
+
+void request_rotation(hl::GameState &gs, hl::PlayerState &player)
+{
+    if (gs.slice.open)
+        player.rotate_pending = true;
+    else
+        rotate_player(gs, player);
+}
+
+void step_fixed(hl::GameState &gs)
+{
+    using namespace hl;
+
+    switch (gs.phase)
+    {
+    case Phase::Ready:
+        // Wait for key to start - handled in input
+        break;
+
+    case Phase::Playing:
+        begin_tick(gs);
+        finish_tick(gs);
+        break;
+
+    case Phase::Lost:
+    case Phase::Won:
+    case Phase::GameWon:
+        // Wait for key to continue - handled in input
+        break;
+    }
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "core/Activity.h"
+
+// ----------------- Basic Types -----------------
+namespace hl
+{
+    constexpr int ARENA_W = 40;
+    constexpr int ARENA_H = 24;
+    constexpr int ACTIVITY_BLOCK = 8; // side of an activity-map block, in cells
+    static_assert(ARENA_W % ACTIVITY_BLOCK == 0 && ARENA_H % ACTIVITY_BLOCK == 0, "blocks must tile the arena");
+
+    enum class CellKind : uint8_t
+    {
+        Empty = 0,
+        Wall = 1,
+        Symbol = 2
+    };
+    enum class Piece : uint8_t
+    {
+        Rock = 0,
+        Paper = 1,
+        Scissors = 2
+    };
+
+    struct PlayerId
+    {
+        uint8_t v{0};
+    };
+
+    struct Cell
+    {
+        CellKind kind{CellKind::Empty};
+        PlayerId owner{0};
+        Piece piece{Piece::Rock};
+    };
+
+    struct Grid
+    {
+        std::array<Cell, ARENA_W * ARENA_H> cells{}; // zero-initialized
+        static constexpr int idx(int x, int y) { return y * ARENA_W + x; }
+        Cell &at(int x, int y) { return cells[idx(x, y)]; }
+        const Cell &at(int x, int y) const { return cells[idx(x, y)]; }
+        void clear() { cells.fill(Cell{}); }
+    };
+
+    // How begin_tick sizes a tick's pair budget
+    enum class PairRate : uint8_t
+    {
+        Fixed = 0,       // pairs_per_tick
+        PerOpenCell = 1, // pairs_per_open_cell per non-wall cell
+        PerFrontier = 2  // pairs_per_frontier_edge per live edge (see Activity.h)
+    };
+
+    struct GameConfig
+    {
+        int pairs_per_tick{240};
+        int ticks_per_second{15};
+        PairRate pair_rate{PairRate::Fixed};
+        // Both defaults give 240 pairs on level 1 at the start (836 open cells, 22 live edges)
+        double pairs_per_open_cell{240.0 / 836};
+        double pairs_per_frontier_edge{240.0 / 22};
+    };
+
+    struct AlbertConfig
+    {
+        int rotation_average{58}; // Average rotation interval (default: 58 ticks)
+        int rotation_half_interval{43}; // Half interval size (default: 43, gives range 15-100)
+    };
+
+    // Who drives a player's rotations. Human players are driven by input.
+    enum class AiKind : uint8_t
+    {
+        Human = 0,
+        Albert = 1,
+        Table = 2,  // looks up a precomputed win table (ai/WinTable.h)
+        Rollout = 3 // plays both choices out in copies of the game
+    };
+
+    class WinTable;
+
+    // Table AI: rotates when its win table rates the rotated position higher
+    struct TableAiConfig
+    {
+        const WinTable *table{nullptr}; // not owned; without one the AI never rotates
+        int min_interval{15};           // ticks between own rotations, as Albert's default minimum
+    };
+
+    // Rollout AI: every think_every ticks, plays `rollouts` games of
+    // `horizon` ticks from both choices (rotate now or not) on common seeds,
+    // with both sides played by default Albert, and keeps the better one
+    struct RolloutConfig
+    {
+        int rollouts{8};
+        int horizon{40};
+        int think_every{5};
+        int min_interval{15};
+    };
+
+    struct PlayerState
+    {
+        PlayerId id{0};
+        Piece current{Piece::Rock};
+        uint16_t last_rot_tick{0};
+        // Minimal AI fields; more later
+        uint8_t tick_losses{0};
+        uint8_t rot_period{0};
+        uint8_t accel_ctr{0};
+        AiKind ai{AiKind::Human};
+        AlbertConfig albert{}; // Used when ai == AiKind::Albert
+        TableAiConfig table{}; // Used when ai == AiKind::Table
+        RolloutConfig rollout{}; // Used when ai == AiKind::Rollout
+        bool rotate_pending{false}; // request_rotation() during a sliced tick
+    };
+
+    enum class Phase
+    {
+        Ready,
+        Playing,
+        Lost,
+        Won,
+        GameWon
+    };
+
+    // Progress of the tick being resolved in slices (see begin_tick)
+    struct TickSlice
+    {
+        bool open{false};
+        int total{0}; // pair draws this tick, fixed at begin_tick
+        int done{0};  // draws resolved so far
+        int skip{-1}; // sparse sampler: draws still to skip (-1 = none drawn)
+        int battles{0}, same_player{0}, wall_empty{0}; // debug counters so far
+    };
+
+    class Profiler;
+    class AiScheduler;
+    class AiMeter;
+
+    struct GameState
+    {
+        Grid grid{};
+        GameConfig cfg{};
+        uint16_t tick{0};
+        uint16_t rng16{0xACE1};
+        std::vector<PlayerState> players; // 0 = human
+        int current_level{1};
+        Phase phase{Phase::Ready};
+        int last_battles{0}; // Track battles for debugging
+        bool use_system_rng{false}; // Option to use std::mt19937 instead of LFSR
+        uint8_t lfsr_stride{1}; // LFSR steps per draw: 1, 8 or 16 (table-driven, fresh bits per draw)
+        std::mt19937 system_rng{std::random_device{}()}; // System RNG
+        int last_attempts{0}; // Total pair attempts
+        int last_same_player{0}; // Same player pairs
+        int last_wall_empty{0}; // Wall/empty pairs
+        bool sparse_sampling{false}; // Draw pairs only from active blocks (same rate, other RNG stream)
+        bool batched_pairs{false}; // Resolve disjoint runs of a tick's pairs in lanes (same results)
+        ActivityMap activity{ARENA_W / ACTIVITY_BLOCK, ARENA_H / ACTIVITY_BLOCK}; // Kept by resolve_pair
+        Profiler *profiler{nullptr}; // Optional: step_fixed times its phases here (not owned)
+        TickSlice slice{};
+        AiScheduler *async_ai{nullptr}; // Optional: AIs decide on worker threads (not owned)
+        AiMeter *ai_meter{nullptr}; // Optional: per-AI cost of every update_ai (not owned)
+        uint64_t rng_draws{0}; // rngu() calls so far
+        uint64_t cells_swept{0}; // cells visited by rotate_player repaints so far
+        int open_cells{0}; // non-wall cells, counted by rebuild_activity (walls never change)
+        std::array<int, 4> territory{}; // symbols per owner at the last census, before the AIs run
+    };
+}
+
+// ----------------- Game Flow -----------------
+// One whole tick: begin_tick, all of its pairs, finish_tick
+void step_fixed(hl::GameState &gs);
+
+// A tick split so its pairs can be spread over several frames, with the
+// same result as step_fixed. Only valid while Playing.
+void begin_tick(hl::GameState &gs);
+// Pairs the next tick draws under gs.cfg.pair_rate; O(1), from counts kept
+// by rebuild_activity and resolve_pair
+int pair_budget(const hl::GameState &gs);
+// Resolves up to n more of the tick's pairs and returns how many remain
+int resolve_tick_slice(hl::GameState &gs, int n);
+// Resolves any pairs left, then the census, win check and AIs
+void finish_tick(hl::GameState &gs);
+
+// Rotates now, or at the end of the open sliced tick so the tick's pairs
+// all see the same pieces
+void request_rotation(hl::GameState &gs, hl::PlayerState &player);
+
+// Advances player's piece (Rock -> Paper -> Scissors) and repaints its symbols
+void rotate_player(hl::GameState &gs, hl::PlayerState &player);
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/Game.h"
+#include "core/Rules.h"
+#include "util/Rng.h"
+
+#if defined(__GNUC__)
+#define HL_PREFETCH_W(p) __builtin_prefetch((p), 1)
+#else
+#define HL_PREFETCH_W(p) ((void)(p))
+#endif
+
+// ----------------- Large-grid Engine -----------------
+// Arenas of arbitrary size for scaling experiments. The memory layout is a
+// policy so the same at(x, y) and resolution code runs on each of them:
+//   RowMajorLayout  y * w + x, like Grid (N/S neighbors are a row apart)
+//   TiledLayout     8x8 tiles of 64 cells; most neighbors share a tile
+//   MortonLayout    Z-order over a power-of-two square; locality at every scale
+namespace hl
+{
+    struct RowMajorLayout
+    {
+        static constexpr const char *name = "row-major";
+        int w{0}, h{0};
+
+        RowMajorLayout(int w_, int h_) : w(w_), h(h_) {}
+        size_t size() const { return static_cast<size_t>(w) * h; }
+        size_t index(int x, int y) const { return static_cast<size_t>(y) * w + x; }
+    };
+
+    struct TiledLayout
+    {
+        static constexpr const char *name = "tiled-8x8";
+        static constexpr int TILE_SHIFT = 3;
+        static constexpr int TILE = 1 << TILE_SHIFT;
+        int w{0}, h{0};
+        int tiles_x{0};
+
+        TiledLayout(int w_, int h_) : w(w_), h(h_), tiles_x((w_ + TILE - 1) >> TILE_SHIFT) {}
+        size_t size() const
+        {
+            return static_cast<size_t>(tiles_x) * ((h + TILE - 1) >> TILE_SHIFT) * TILE * TILE;
+        }
+        size_t index(int x, int y) const
+        {
+            const size_t tile = static_cast<size_t>(y >> TILE_SHIFT) * tiles_x + (x >> TILE_SHIFT);
+            return (tile << (2 * TILE_SHIFT)) | ((y & (TILE - 1)) << TILE_SHIFT) | (x & (TILE - 1));
+        }
+    };
+
+    struct MortonLayout
+    {
+        static constexpr const char *name = "morton";
+        int w{0}, h{0};
+        int side{1}; // padded power-of-two edge
+
+        MortonLayout(int w_, int h_) : w(w_), h(h_)
+        {
+            while (side < w || side < h)
+                side <<= 1;
+        }
+        size_t size() const { return static_cast<size_t>(side) * side; }
+
+        // Spreads the low 16 bits of v to the even bit positions
+        static uint32_t spread(uint32_t v)
+        {
+            v &= 0xFFFF;
+            v = (v | (v << 8)) & 0x00FF00FF;
+            v = (v | (v << 4)) & 0x0F0F0F0F;
+            v = (v | (v << 2)) & 0x33333333;
+            v = (v | (v << 1)) & 0x55555555;
+            return v;
+        }
+        size_t index(int x, int y) const { return spread(x) | (spread(y) << 1); }
+    };
+
+    template <typename Layout>
+    struct LargeGrid
+    {
+        Layout layout;
+        std::vector<Cell> cells;
+
+        LargeGrid(int w, int h) : layout(w, h), cells(layout.size()) {}
+        int width() const { return layout.w; }
+        int height() const { return layout.h; }
+        Cell &at(int x, int y) { return cells[layout.index(x, y)]; }
+        const Cell &at(int x, int y) const { return cells[layout.index(x, y)]; }
+        void set(int x, int y, const Cell &c) { at(x, y) = c; }
+        bool in_bounds(int x, int y) const { return x >= 0 && x < layout.w && y >= 0 && y < layout.h; }
+    };
+
+    // Neighbor offsets indexed by direction, same order as pick_neighbor (N, E, S, W)
+    constexpr int NEIGHBOR_DX[4] = {0, 1, 0, -1};
+    constexpr int NEIGHBOR_DY[4] = {-1, 0, 1, 0};
+
+    // Level 1 scaled up: outer wall, left half player 0 (Rock), right half player 1 (Scissors).
+    // Works on any grid with width()/height()/set().
+    template <typename G>
+    void fill_split_arena(G &grid)
+    {
+        const int w = grid.width(), h = grid.height();
+        for (int y = 0; y < h; ++y)
+        {
+            for (int x = 0; x < w; ++x)
+            {
+                if (x == 0 || y == 0 || x == w - 1 || y == h - 1)
+                    grid.set(x, y, Cell{CellKind::Wall, PlayerId{0}, Piece::Rock});
+                else if (x < w / 2)
+                    grid.set(x, y, Cell{CellKind::Symbol, PlayerId{0}, Piece::Rock});
+                else
+                    grid.set(x, y, Cell{CellKind::Symbol, PlayerId{1}, Piece::Scissors});
+            }
+        }
+    }
+
+    // One pair from one 64-bit draw: the high half scales to x, the low half
+    // to y, and the two lowest bits (which barely move the scaled y) pick the
+    // direction. Shared by every engine so they can be run in lockstep.
+    struct PairDraw
+    {
+        int x, y, dir;
+    };
+    inline PairDraw split_pair_draw(uint64_t r, uint32_t w, uint32_t h)
+    {
+        return {static_cast<int>(Rng64::scale(r, w)), static_cast<int>(Rng64::scale(r << 32, h)),
+                static_cast<int>(r & 3)};
+    }
+
+    // resolve_pairs for a large grid, one split_pair_draw per pair; the rule-5
+    // coin is one more draw. R is any generator with uint64_t next() (Rng64).
+    // losses[owner] counts lost cells.
+    template <typename G, typename R>
+    void resolve_pairs_large(G &grid, R &rng, long long count, std::vector<uint32_t> &losses)
+    {
+        const uint32_t w = grid.width(), h = grid.height();
+        for (long long i = 0; i < count; ++i)
+        {
+            const auto [x, y, dir] = split_pair_draw(rng.next(), w, h);
+            const int nx = x + NEIGHBOR_DX[dir];
+            const int ny = y + NEIGHBOR_DY[dir];
+            if (!grid.in_bounds(nx, ny))
+                continue;
+
+            resolve_cells(
+                grid.at(x, y), grid.at(nx, ny), [&]()
+                { return static_cast<uint16_t>(rng.next()); },
+                [&](PlayerId loser)
+                {
+                    if (loser.v < losses.size())
+                        losses[loser.v]++;
+                });
+        }
+    }
+
+    // ----------------- Pipelined Engines -----------------
+    // Draw-ahead queue for software-pipelined engines: holds up to K decoded
+    // pairs (Entry, made from one raw draw by make(), which also issues the
+    // prefetches). Draws are consumed in stream order, by pairs and rule-5
+    // coins alike, so results match the sequential engine; a queued draw
+    // that turns out to be a coin only wastes its prefetch. The queue never
+    // holds more draws than pairs left, so the generator ends where the
+    // sequential engine leaves it. Entry must have a uint64_t member r.
+    template <typename R, int K, typename Entry>
+    struct DrawAhead
+    {
+        static_assert(K > 0 && (K & (K - 1)) == 0, "K must be a power of two");
+
+        R &rng;
+        Entry ring[K];
+        int head{0};
+        int size{0};
+
+        explicit DrawAhead(R &r) : rng(r) {}
+
+        template <typename Make>
+        void top_up(long long pairs_left, Make &&make)
+        {
+            while (size < K && size < pairs_left)
+            {
+                ring[(head + size) & (K - 1)] = make(rng.next());
+                size++;
+            }
+        }
+
+        // Next pair; call top_up first so the queue is not empty
+        const Entry &pop()
+        {
+            const Entry &e = ring[head];
+            head = (head + 1) & (K - 1);
+            size--;
+            return e;
+        }
+
+        // Next raw draw, for a coin
+        uint64_t pop_raw() { return size == 0 ? rng.next() : pop().r; }
+    };
+
+    // resolve_pairs_large with the next K pairs' cells in flight while pair i
+    // resolves. Same results and final generator state as the plain engine.
+    template <int K = 16, typename G, typename R>
+    void resolve_pairs_large_pipelined(G &grid, R &rng, long long count, std::vector<uint32_t> &losses)
+    {
+        struct Entry
+        {
+            uint64_t r;
+            Cell *a;
+            Cell *b; // nullptr when the neighbor is off the grid
+        };
+        const uint32_t w = grid.width(), h = grid.height();
+        auto make = [&](uint64_t r)
+        {
+            const auto [x, y, dir] = split_pair_draw(r, w, h);
+            const int nx = x + NEIGHBOR_DX[dir], ny = y + NEIGHBOR_DY[dir];
+            Entry e{r, &grid.at(x, y), grid.in_bounds(nx, ny) ? &grid.at(nx, ny) : nullptr};
+            HL_PREFETCH_W(e.a);
+            if (e.b)
+                HL_PREFETCH_W(e.b);
+            return e;
+        };
+
+        DrawAhead<R, K, Entry> ahead(rng);
+        for (long long i = 0; i < count; ++i)
+        {
+            ahead.top_up(count - i, make);
+            const Entry e = ahead.pop();
+            if (!e.b)
+                continue;
+
+            resolve_cells(
+                *e.a, *e.b, [&]()
+                { return static_cast<uint16_t>(ahead.pop_raw()); },
+                [&](PlayerId loser)
+                {
+                    if (loser.v < losses.size())
+                        losses[loser.v]++;
+                });
+        }
+    }
+}
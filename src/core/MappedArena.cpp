@@ -0,0 +1,427 @@
+#include "core/MappedArena.h"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "core/LargeGrid.h"
+#include "core/PackedGrid.h"
+#include "core/Rules.h"
+
+namespace hl
+{
+    namespace
+    {
+        struct FileHeader
+        {
+            char magic[8];
+            uint32_t w;
+            uint32_t h;
+            uint8_t pieces[MappedArena::MAX_PLAYERS];
+        };
+        static_assert(sizeof(FileHeader) <= MappedArena::HEADER_BYTES, "header fits its page");
+
+        constexpr char MAGIC[8] = {'H', 'L', 'A', 'R', 'E', 'N', 'A', '1'};
+    }
+
+    MappedArena::~MappedArena() { close(); }
+
+    bool MappedArena::map_file(const std::string &path, size_t bytes, bool create, std::string &err)
+    {
+        fd_ = ::open(path.c_str(), create ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDWR, 0644);
+        if (fd_ < 0)
+        {
+            err = "cannot open " + path + ": " + std::strerror(errno);
+            return false;
+        }
+        if (create && ftruncate(fd_, static_cast<off_t>(bytes)) != 0)
+        {
+            err = "cannot size " + path + ": " + std::strerror(errno);
+            return false;
+        }
+        void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED)
+        {
+            err = "cannot map " + path + ": " + std::strerror(errno);
+            return false;
+        }
+        // Tiles are touched in no particular order, and readahead would bring
+        // evicted neighbours back into the page cache
+        madvise(p, bytes, MADV_RANDOM);
+        map_ = static_cast<uint8_t *>(p);
+        base_ = map_ + HEADER_BYTES;
+        map_bytes_ = bytes;
+        return true;
+    }
+
+    void MappedArena::init_tiles()
+    {
+        tiles_x_ = w_ / TILE;
+        tiles_y_ = h_ / TILE;
+        const size_t n = static_cast<size_t>(tiles_x_) * tiles_y_;
+        counts_.assign(n, {});
+        uniform_.assign(n, 0xFF);
+        evicted_.assign(n, 0);
+        activity_ = ActivityMap(tiles_x_, tiles_y_, true);
+    }
+
+    bool MappedArena::create(const std::string &path, int w, int h, std::string &err)
+    {
+        close();
+        if (w < TILE || h < TILE || w % TILE || h % TILE)
+        {
+            err = "arena size must be a non-zero multiple of " + std::to_string(TILE);
+            return false;
+        }
+        w_ = w;
+        h_ = h;
+        const size_t tiles = static_cast<size_t>(w / TILE) * (h / TILE);
+        if (!map_file(path, HEADER_BYTES + tiles * TILE_BYTES, true, err))
+        {
+            close();
+            return false;
+        }
+        init_tiles();
+
+        // Fill row by row inside each tile; rows without walls or the centre
+        // line are a single code and become one memset.
+        const uint8_t p0 = PACKED_OWNER0, p1 = PACKED_OWNER0 + 1;
+        uint8_t codes[TILE];
+        for (int t = 0; t < static_cast<int>(tiles); ++t)
+        {
+            const int x0 = (t % tiles_x_) * TILE, y0 = (t / tiles_x_) * TILE;
+            uint8_t *tile = base_ + static_cast<size_t>(t) * TILE_BYTES;
+            for (int ly = 0; ly < TILE; ++ly)
+            {
+                const int y = y0 + ly;
+                const bool wall_row = y == 0 || y == h - 1;
+                const bool simple = !wall_row && x0 > 0 && x0 + TILE < w && (x0 + TILE <= w / 2 || x0 >= w / 2);
+                uint8_t *row = tile + ly * (TILE / 2);
+                if (simple)
+                {
+                    const uint8_t c = x0 < w / 2 ? p0 : p1;
+                    std::memset(row, c | (c << 4), TILE / 2);
+                    continue;
+                }
+                for (int lx = 0; lx < TILE; ++lx)
+                {
+                    const int x = x0 + lx;
+                    codes[lx] = (wall_row || x == 0 || x == w - 1) ? PACKED_WALL : (x < w / 2 ? p0 : p1);
+                }
+                for (int lx = 0; lx < TILE; lx += 2)
+                    row[lx / 2] = static_cast<uint8_t>(codes[lx] | (codes[lx + 1] << 4));
+            }
+        }
+        pieces = {};
+        pieces[0] = Piece::Rock;
+        pieces[1] = Piece::Scissors;
+
+        rebuild_activity();
+        for (int t = 0; t < static_cast<int>(tiles); ++t)
+        {
+            if (!activity_.active(t) && uniform_[t] != 0xFF)
+                evict_tile(t);
+        }
+        activity_.take_deactivated();
+        return true;
+    }
+
+    bool MappedArena::open(const std::string &path, std::string &err)
+    {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            err = "cannot open " + path + ": " + std::strerror(errno);
+            return false;
+        }
+        FileHeader hdr{};
+        const bool ok = ::read(fd, &hdr, sizeof(hdr)) == static_cast<ssize_t>(sizeof(hdr));
+        struct stat st{};
+        fstat(fd, &st);
+        ::close(fd);
+        if (!ok || std::memcmp(hdr.magic, MAGIC, sizeof(MAGIC)) != 0 || hdr.w % TILE || hdr.h % TILE ||
+            hdr.w == 0 || hdr.h == 0)
+        {
+            err = path + " is not an arena file";
+            return false;
+        }
+        w_ = static_cast<int>(hdr.w);
+        h_ = static_cast<int>(hdr.h);
+        const size_t bytes = HEADER_BYTES + static_cast<size_t>(w_ / TILE) * (h_ / TILE) * TILE_BYTES;
+        if (static_cast<size_t>(st.st_size) < bytes)
+        {
+            err = path + " is truncated";
+            return false;
+        }
+        if (!map_file(path, bytes, false, err))
+        {
+            close();
+            return false;
+        }
+        init_tiles();
+        for (int p = 0; p < MAX_PLAYERS; ++p)
+            pieces[p] = static_cast<Piece>(hdr.pieces[p] % 3);
+
+        rebuild_activity();
+        for (int t = 0; t < activity_.tile_count(); ++t)
+        {
+            if (!activity_.active(t) && uniform_[t] != 0xFF)
+                evict_tile(t);
+        }
+        activity_.take_deactivated();
+        return true;
+    }
+
+    void MappedArena::close()
+    {
+        if (map_)
+        {
+            FileHeader hdr{};
+            std::memcpy(hdr.magic, MAGIC, sizeof(MAGIC));
+            hdr.w = static_cast<uint32_t>(w_);
+            hdr.h = static_cast<uint32_t>(h_);
+            for (int p = 0; p < MAX_PLAYERS; ++p)
+                hdr.pieces[p] = static_cast<uint8_t>(pieces[p]);
+            std::memcpy(map_, &hdr, sizeof(hdr));
+            msync(map_, map_bytes_, MS_SYNC);
+            munmap(map_, map_bytes_);
+        }
+        if (fd_ >= 0)
+            ::close(fd_);
+        map_ = base_ = nullptr;
+        map_bytes_ = 0;
+        fd_ = -1;
+    }
+
+    void MappedArena::rebuild_activity()
+    {
+        const int n = activity_.tile_count();
+        for (int t = 0; t < n; ++t)
+        {
+            uint32_t all[16] = {};
+            packed_census(base_ + static_cast<size_t>(t) * TILE_BYTES, TILE_BYTES, 4, 16, all);
+            uniform_[t] = 0xFF;
+            for (int c = 0; c < 16; ++c)
+            {
+                counts_[t][c] = static_cast<uint16_t>(all[c]);
+                if (all[c] == TILE_CELLS)
+                    uniform_[t] = static_cast<uint8_t>(c);
+            }
+        }
+
+        for (int t = 0; t < n; ++t)
+        {
+            const int x0 = (t % tiles_x_) * TILE, y0 = (t / tiles_x_) * TILE;
+            int live = 0;
+
+            // Edges inside the tile; none when it holds a single code
+            if (uniform_[t] == 0xFF)
+            {
+                for (int y = y0; y < y0 + TILE; ++y)
+                {
+                    for (int x = x0; x < x0 + TILE; ++x)
+                    {
+                        const uint8_t c = code(x, y);
+                        if (x + 1 < x0 + TILE && live_edge(c, code(x + 1, y)))
+                            live++;
+                        if (y + 1 < y0 + TILE && live_edge(c, code(x, y + 1)))
+                            live++;
+                    }
+                }
+            }
+            if (live)
+                activity_.add_live(t, live);
+
+            // Edges to the east and south neighbor tiles count for both tiles
+            if (x0 + TILE < w_)
+            {
+                const int e = t + 1;
+                int edge = 0;
+                if (uniform_[t] != 0xFF && uniform_[e] != 0xFF)
+                    edge = live_edge(uniform_[t], uniform_[e]) ? TILE : 0;
+                else
+                {
+                    for (int y = y0; y < y0 + TILE; ++y)
+                        edge += live_edge(code(x0 + TILE - 1, y), code(x0 + TILE, y));
+                }
+                if (edge)
+                {
+                    activity_.add_live(t, edge);
+                    activity_.add_live(e, edge);
+                }
+            }
+            if (y0 + TILE < h_)
+            {
+                const int s = t + tiles_x_;
+                int edge = 0;
+                if (uniform_[t] != 0xFF && uniform_[s] != 0xFF)
+                    edge = live_edge(uniform_[t], uniform_[s]) ? TILE : 0;
+                else
+                {
+                    for (int x = x0; x < x0 + TILE; ++x)
+                        edge += live_edge(code(x, y0 + TILE - 1), code(x, y0 + TILE));
+                }
+                if (edge)
+                {
+                    activity_.add_live(t, edge);
+                    activity_.add_live(s, edge);
+                }
+            }
+        }
+    }
+
+    void MappedArena::write_nibble(size_t i, uint8_t c)
+    {
+        uint8_t &b = base_[i >> 1];
+        const int sh = (i & 1) * 4;
+        b = static_cast<uint8_t>((b & ~(0x0F << sh)) | (c << sh));
+    }
+
+    void MappedArena::set_code(int x, int y, uint8_t c)
+    {
+        const uint8_t old = code(x, y);
+        if (old == c)
+            return;
+        const int t = tile_of(x, y);
+        for (int d = 0; d < 4; ++d)
+        {
+            const int nx = x + NEIGHBOR_DX[d], ny = y + NEIGHBOR_DY[d];
+            if (!in_bounds(nx, ny))
+                continue;
+            const uint8_t cn = code(nx, ny);
+            activity_.edge_changed(t, tile_of(nx, ny), live_edge(old, cn), live_edge(c, cn));
+        }
+        if (evicted_[t])
+        {
+            // The file still holds the tile's single code; the write reads it back in
+            evicted_[t] = 0;
+            reloads_++;
+        }
+        write_nibble(cell_offset(x, y), c);
+        counts_[t][old]--;
+        counts_[t][c]++;
+        uniform_[t] = counts_[t][c] == TILE_CELLS ? c : 0xFF;
+    }
+
+    Cell MappedArena::at(int x, int y) const { return decode_cell(code(x, y), pieces.data()); }
+
+    void MappedArena::set(int x, int y, const Cell &c)
+    {
+        if (c.kind == CellKind::Symbol && c.owner.v < MAX_PLAYERS)
+            pieces[c.owner.v] = c.piece;
+        set_code(x, y, encode_cell(c));
+    }
+
+    long long MappedArena::resolve_pairs(Rng64 &rng, long long count, std::vector<uint32_t> &losses)
+    {
+        const double all_cells = static_cast<double>(w_) * h_;
+        long long remaining = count;
+        long long resolved = 0;
+        while (remaining > 0)
+        {
+            const int na = activity_.active_count();
+            if (na == 0)
+                break;
+            const double p = na * static_cast<double>(TILE_CELLS) / all_cells;
+            const double u = ((rng.next() >> 11) + 1) * 0x1.0p-53; // (0, 1]
+            const long long skip = skip_draws(p, u);
+            if (skip >= remaining)
+                break;
+            remaining -= skip + 1;
+
+            // High half picks the tile, low bits the cell and direction
+            const uint64_t r = rng.next();
+            const int t = activity_.active_tile(static_cast<int>(Rng64::scale(r, na)));
+            const int x = (t % tiles_x_) * TILE + static_cast<int>(r & (TILE - 1));
+            const int y = (t / tiles_x_) * TILE + static_cast<int>((r >> TILE_SHIFT) & (TILE - 1));
+            const int dir = static_cast<int>(r >> (2 * TILE_SHIFT)) & 3;
+            const int nx = x + NEIGHBOR_DX[dir], ny = y + NEIGHBOR_DY[dir];
+            if (!in_bounds(nx, ny))
+                continue;
+
+            const uint8_t ca = code(x, y), cb = code(nx, ny);
+            if (!live_edge(ca, cb))
+                continue;
+
+            Cell a = decode_cell(ca, pieces.data());
+            Cell b = decode_cell(cb, pieces.data());
+            resolve_cells(
+                a, b, [&]()
+                { return static_cast<uint16_t>(rng.next()); },
+                [&](PlayerId loser)
+                {
+                    if (loser.v < losses.size())
+                        losses[loser.v]++;
+                });
+            set_code(x, y, encode_cell(a));
+            set_code(nx, ny, encode_cell(b));
+            resolved++;
+        }
+        return resolved;
+    }
+
+    void MappedArena::evict_tile(int t)
+    {
+        // Unmapping alone leaves the pages in the page cache; write them back
+        // so they are clean, then drop them from the cache as well
+        uint8_t *tile = base_ + static_cast<size_t>(t) * TILE_BYTES;
+        msync(tile, TILE_BYTES, MS_SYNC);
+        madvise(tile, TILE_BYTES, MADV_DONTNEED);
+        posix_fadvise(fd_, static_cast<off_t>(tile - map_), TILE_BYTES, POSIX_FADV_DONTNEED);
+        evicted_[t] = 1;
+        evictions_++;
+    }
+
+    int MappedArena::evict_quiescent()
+    {
+        int n = 0;
+        for (int t : activity_.take_deactivated())
+        {
+            if (!activity_.active(t) && !evicted_[t] && uniform_[t] != 0xFF)
+            {
+                evict_tile(t);
+                n++;
+            }
+        }
+        return n;
+    }
+
+    MappedArena::PagingStats MappedArena::paging_stats() const
+    {
+        PagingStats s;
+        s.mapped_bytes = map_bytes_;
+        s.evictions = evictions_;
+        s.reloads = reloads_;
+        for (uint8_t e : evicted_)
+            s.evicted_tiles += e;
+
+        const long page = sysconf(_SC_PAGESIZE);
+        if (map_ && page > 0)
+        {
+            std::vector<unsigned char> vec((map_bytes_ + page - 1) / page);
+            if (mincore(map_, map_bytes_, vec.data()) == 0)
+            {
+                size_t pages = 0;
+                for (unsigned char v : vec)
+                    pages += v & 1;
+                s.resident_bytes = pages * static_cast<size_t>(page);
+            }
+        }
+        return s;
+    }
+
+    void MappedArena::census(uint64_t *counts, int players) const
+    {
+        for (int p = 0; p < players; ++p)
+            counts[p] = 0;
+        for (const auto &c : counts_)
+        {
+            for (int p = 0; p < players && PACKED_OWNER0 + p < 16; ++p)
+                counts[p] += c[PACKED_OWNER0 + p];
+        }
+    }
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/Activity.h"
+#include "core/Game.h"
+#include "util/Rng.h"
+
+// ----------------- Out-of-core Arena -----------------
+// A packed 4-bit arena (codes as in PackedGrid.h) stored in a memory-mapped
+// file, for arenas larger than RAM. The file is a 4 KB header followed by
+// 128x128-cell tiles of 8 KB each, so a tile is a whole number of pages.
+//
+// An ActivityMap tracks which tiles can still change. Pairs are drawn only
+// from active tiles, and draws that would land in quiescent tiles are
+// skipped in bulk (skip_draws), so the pair rate per cell matches a
+// full-arena sampler. Tiles that go quiescent while holding a single code
+// (one owner, all walls, all empty) are "evicted": their pages are written
+// back, unmapped and dropped from the page cache, and reads return the
+// tile's code without touching memory. They are read back from the file on
+// the next write.
+namespace hl
+{
+    class MappedArena
+    {
+    public:
+        static constexpr int TILE_SHIFT = 7;
+        static constexpr int TILE = 1 << TILE_SHIFT;
+        static constexpr size_t TILE_CELLS = size_t(TILE) * TILE;
+        static constexpr size_t TILE_BYTES = TILE_CELLS / 2;
+        static constexpr size_t HEADER_BYTES = 4096;
+        static constexpr int MAX_PLAYERS = 14;
+
+        struct PagingStats
+        {
+            size_t mapped_bytes{0};
+            size_t resident_bytes{0}; // from mincore()
+            int evicted_tiles{0};
+            uint64_t evictions{0}; // tiles dropped so far
+            uint64_t reloads{0};   // writes that paged an evicted tile back in
+        };
+
+        MappedArena() = default;
+        ~MappedArena();
+        MappedArena(const MappedArena &) = delete;
+        MappedArena &operator=(const MappedArena &) = delete;
+
+        // Creates (or truncates) `path` as a w x h split arena: outer wall,
+        // left half player 0 (Rock), right half player 1 (Scissors).
+        // w and h must be multiples of TILE.
+        bool create(const std::string &path, int w, int h, std::string &err);
+
+        // Maps an existing arena file and rebuilds its activity map
+        bool open(const std::string &path, std::string &err);
+
+        // Stores pieces in the header, syncs and unmaps
+        void close();
+
+        int width() const { return w_; }
+        int height() const { return h_; }
+        bool in_bounds(int x, int y) const { return x >= 0 && x < w_ && y >= 0 && y < h_; }
+        int tile_of(int x, int y) const { return (y >> TILE_SHIFT) * tiles_x_ + (x >> TILE_SHIFT); }
+
+        uint8_t code(int x, int y) const
+        {
+            const int t = tile_of(x, y);
+            if (evicted_[t])
+                return uniform_code(t);
+            const size_t i = cell_offset(x, y);
+            return (base_[i >> 1] >> ((i & 1) * 4)) & 0x0F;
+        }
+
+        // Writes a code, keeping tile counts and the activity map current
+        void set_code(int x, int y, uint8_t c);
+
+        Cell at(int x, int y) const;
+        void set(int x, int y, const Cell &c);
+
+        // Current piece per owner (the piece every symbol of that owner shows)
+        std::array<Piece, MAX_PLAYERS> pieces{};
+
+        const ActivityMap &activity() const { return activity_; }
+
+        // Runs `count` full-arena pair draws; returns the pairs actually resolved
+        long long resolve_pairs(Rng64 &rng, long long count, std::vector<uint32_t> &losses);
+
+        // Releases single-code quiescent tiles from memory and the page cache; returns tiles evicted
+        int evict_quiescent();
+
+        PagingStats paging_stats() const;
+
+        // Symbols per owner from the tile counts, O(tiles)
+        void census(uint64_t *counts, int players) const;
+
+    private:
+        size_t cell_offset(int x, int y) const
+        {
+            const size_t t = static_cast<size_t>(tile_of(x, y));
+            return t * TILE_CELLS + (static_cast<size_t>(y & (TILE - 1)) << TILE_SHIFT) + (x & (TILE - 1));
+        }
+        // 0xFF when the tile holds more than one code
+        uint8_t uniform_code(int t) const { return uniform_[t]; }
+        void write_nibble(size_t i, uint8_t c);
+        bool map_file(const std::string &path, size_t bytes, bool create, std::string &err);
+        void init_tiles();
+        void rebuild_activity();
+        void evict_tile(int t);
+
+        int w_{0}, h_{0};
+        int tiles_x_{0}, tiles_y_{0};
+        int fd_{-1};
+        uint8_t *map_{nullptr};  // header + tiles
+        uint8_t *base_{nullptr}; // first tile
+        size_t map_bytes_{0};
+
+        ActivityMap activity_;
+        std::vector<std::array<uint16_t, 16>> counts_; // per tile, per code
+        std::vector<uint8_t> uniform_;
+        std::vector<uint8_t> evicted_;
+        uint64_t evictions_{0};
+        uint64_t reloads_{0};
+    };
+}
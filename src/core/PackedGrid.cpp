@@ -0,0 +1,131 @@
+#include "core/PackedGrid.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace hl
+{
+    static void census_scalar(const uint8_t *data, size_t nbytes, int bits, int ncodes, uint32_t *counts)
+    {
+        const int fields = 8 / bits;
+        const uint8_t mask = static_cast<uint8_t>((1u << bits) - 1);
+        for (size_t i = 0; i < nbytes; ++i)
+        {
+            for (int f = 0; f < fields; ++f)
+            {
+                const int c = (data[i] >> (f * bits)) & mask;
+                if (c < ncodes)
+                    counts[c]++;
+            }
+        }
+    }
+
+    static void unpack_scalar(const uint8_t *data, size_t nbytes, int bits, uint8_t *out)
+    {
+        const int fields = 8 / bits;
+        const uint8_t mask = static_cast<uint8_t>((1u << bits) - 1);
+        for (size_t i = 0; i < nbytes; ++i)
+        {
+            for (int f = 0; f < fields; ++f)
+                *out++ = (data[i] >> (f * bits)) & mask;
+        }
+    }
+
+#if defined(__SSE2__)
+    // 16 bytes per step; per-code byte counters are folded with psadbw before
+    // they can overflow (each step adds at most `fields` to a lane)
+    static size_t census_sse2(const uint8_t *data, size_t nbytes, int bits, int ncodes, uint32_t *counts)
+    {
+        const int fields = 8 / bits;
+        const __m128i mask = _mm_set1_epi8(static_cast<char>((1u << bits) - 1));
+        const __m128i zero = _mm_setzero_si128();
+        const size_t blocks = nbytes / 16;
+        const size_t flush_every = 255 / fields;
+
+        size_t b = 0;
+        while (b < blocks)
+        {
+            __m128i acc[16];
+            for (int c = 0; c < ncodes; ++c)
+                acc[c] = zero;
+
+            const size_t end = std::min(blocks, b + flush_every);
+            for (; b < end; ++b)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + b * 16));
+                for (int f = 0; f < fields; ++f)
+                {
+                    const __m128i x = _mm_and_si128(_mm_srl_epi16(v, _mm_cvtsi32_si128(f * bits)), mask);
+                    for (int c = 0; c < ncodes; ++c)
+                        acc[c] = _mm_sub_epi8(acc[c], _mm_cmpeq_epi8(x, _mm_set1_epi8(static_cast<char>(c))));
+                }
+            }
+            for (int c = 0; c < ncodes; ++c)
+            {
+                const __m128i s = _mm_sad_epu8(acc[c], zero);
+                counts[c] += static_cast<uint32_t>(_mm_cvtsi128_si32(s) + _mm_extract_epi16(s, 4));
+            }
+        }
+        return blocks * 16;
+    }
+
+    static size_t unpack_sse2(const uint8_t *data, size_t nbytes, int bits, uint8_t *out)
+    {
+        const size_t blocks = nbytes / 16;
+        __m128i *dst = reinterpret_cast<__m128i *>(out);
+        if (bits == 4)
+        {
+            const __m128i mask = _mm_set1_epi8(0x0F);
+            for (size_t b = 0; b < blocks; ++b)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + b * 16));
+                const __m128i lo = _mm_and_si128(v, mask);
+                const __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+                _mm_storeu_si128(dst++, _mm_unpacklo_epi8(lo, hi));
+                _mm_storeu_si128(dst++, _mm_unpackhi_epi8(lo, hi));
+            }
+        }
+        else
+        {
+            const __m128i mask = _mm_set1_epi8(0x03);
+            for (size_t b = 0; b < blocks; ++b)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + b * 16));
+                const __m128i f0 = _mm_and_si128(v, mask);
+                const __m128i f1 = _mm_and_si128(_mm_srli_epi16(v, 2), mask);
+                const __m128i f2 = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+                const __m128i f3 = _mm_and_si128(_mm_srli_epi16(v, 6), mask);
+                const __m128i a_lo = _mm_unpacklo_epi8(f0, f1), a_hi = _mm_unpackhi_epi8(f0, f1);
+                const __m128i b_lo = _mm_unpacklo_epi8(f2, f3), b_hi = _mm_unpackhi_epi8(f2, f3);
+                _mm_storeu_si128(dst++, _mm_unpacklo_epi16(a_lo, b_lo));
+                _mm_storeu_si128(dst++, _mm_unpackhi_epi16(a_lo, b_lo));
+                _mm_storeu_si128(dst++, _mm_unpacklo_epi16(a_hi, b_hi));
+                _mm_storeu_si128(dst++, _mm_unpackhi_epi16(a_hi, b_hi));
+            }
+        }
+        return blocks * 16;
+    }
+#endif
+
+    void packed_census(const uint8_t *data, size_t nbytes, int bits, int ncodes, uint32_t *counts)
+    {
+        ncodes = std::min(ncodes, 1 << bits);
+        size_t done = 0;
+#if defined(__SSE2__)
+        done = census_sse2(data, nbytes, bits, ncodes, counts);
+#endif
+        census_scalar(data + done, nbytes - done, bits, ncodes, counts);
+    }
+
+    void packed_unpack(const uint8_t *data, size_t nbytes, int bits, uint8_t *out)
+    {
+        size_t done = 0;
+#if defined(__SSE2__)
+        done = unpack_sse2(data, nbytes, bits, out);
+#endif
+        unpack_scalar(data + done, nbytes - done, bits, out + done * (8 / bits));
+    }
+}
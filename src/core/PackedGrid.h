@@ -0,0 +1,231 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/Game.h"
+#include "core/LargeGrid.h"
+#include "core/Rules.h"
+#include "util/HugeAlloc.h"
+#include "util/Rng.h"
+
+// ----------------- Packed Large Grid -----------------
+// Every symbol of a player carries that player's current piece (rotation
+// sweeps the grid), so a cell is fully described by kind + owner:
+//   0 = empty, 1 = wall, 2 + owner = symbol of owner
+// At 4 bits that is 14 players, at 2 bits 2 players. A 16K x 16K arena
+// takes 128 MB (4-bit) or 64 MB (2-bit) instead of 768 MB of Cell.
+namespace hl
+{
+    constexpr uint8_t PACKED_EMPTY = 0;
+    constexpr uint8_t PACKED_WALL = 1;
+    constexpr uint8_t PACKED_OWNER0 = 2;
+
+    inline uint8_t encode_cell(const Cell &c)
+    {
+        switch (c.kind)
+        {
+        case CellKind::Empty:
+            return PACKED_EMPTY;
+        case CellKind::Wall:
+            return PACKED_WALL;
+        case CellKind::Symbol:
+            break;
+        }
+        return static_cast<uint8_t>(PACKED_OWNER0 + c.owner.v);
+    }
+
+    inline Cell decode_cell(uint8_t code, const Piece *pieces)
+    {
+        if (code == PACKED_EMPTY)
+            return Cell{};
+        if (code == PACKED_WALL)
+            return Cell{CellKind::Wall, PlayerId{0}, Piece::Rock};
+        const uint8_t owner = code - PACKED_OWNER0;
+        return Cell{CellKind::Symbol, PlayerId{owner}, pieces[owner]};
+    }
+
+    // Counts codes [0, ncodes) in nbytes of packed cells (counts[] is added to).
+    // Padding slots are empty, so they only land in counts[PACKED_EMPTY].
+    void packed_census(const uint8_t *data, size_t nbytes, int bits, int ncodes, uint32_t *counts);
+
+    // Expands nbytes of packed cells to one code byte per cell (storage order),
+    // e.g. for uploading a large arena as an indexed texture.
+    void packed_unpack(const uint8_t *data, size_t nbytes, int bits, uint8_t *out);
+
+    template <typename Layout, int BITS = 4>
+    struct PackedGrid
+    {
+        static_assert(BITS == 2 || BITS == 4, "2 or 4 bits per cell");
+        static constexpr int PER_BYTE = 8 / BITS;
+        static constexpr uint8_t MASK = (1u << BITS) - 1;
+        static constexpr int MAX_PLAYERS = (1 << BITS) - PACKED_OWNER0;
+
+        Layout layout;
+        HugeBuffer bytes;
+        // Current piece per owner; mirror PlayerState::current after rotations
+        std::array<Piece, 14> pieces{};
+
+        // Each 8x8 tile of TiledLayout is a whole number of bytes, so
+        // tile-parallel workers never share a byte.
+        PackedGrid(int w, int h) : layout(w, h), bytes((layout.size() + PER_BYTE - 1) / PER_BYTE) {}
+
+        int width() const { return layout.w; }
+        int height() const { return layout.h; }
+        bool in_bounds(int x, int y) const { return x >= 0 && x < layout.w && y >= 0 && y < layout.h; }
+
+        uint8_t code_at(size_t i) const
+        {
+            return (bytes.data()[i / PER_BYTE] >> ((i % PER_BYTE) * BITS)) & MASK;
+        }
+        void set_code_at(size_t i, uint8_t code)
+        {
+            uint8_t &b = bytes.data()[i / PER_BYTE];
+            const int sh = (i % PER_BYTE) * BITS;
+            b = static_cast<uint8_t>((b & ~(MASK << sh)) | ((code & MASK) << sh));
+        }
+
+        uint8_t code(int x, int y) const { return code_at(layout.index(x, y)); }
+        Cell at(int x, int y) const { return decode_cell(code(x, y), pieces.data()); }
+        void set(int x, int y, const Cell &c)
+        {
+            if (c.kind == CellKind::Symbol)
+                pieces[c.owner.v] = c.piece;
+            set_code_at(layout.index(x, y), encode_cell(c));
+        }
+
+        // Symbols per owner, counts[0..players)
+        void census(uint32_t *counts, int players) const
+        {
+            uint32_t all[16] = {};
+            packed_census(bytes.data(), bytes.size(), BITS, PACKED_OWNER0 + players, all);
+            for (int p = 0; p < players; ++p)
+                counts[p] = all[PACKED_OWNER0 + p];
+        }
+
+        void unpack(uint8_t *out) const { packed_unpack(bytes.data(), bytes.size(), BITS, out); }
+    };
+
+    // resolve_pairs_large for packed grids. Equal codes (wall/wall, empty/empty,
+    // same owner) and walls are no-ops under rules 1, 2 and 4, so only pairs of
+    // different non-wall codes are decoded and run through resolve_cells.
+    template <typename Layout, int BITS, typename R>
+    void resolve_pairs_packed(PackedGrid<Layout, BITS> &grid, R &rng, long long count,
+                              std::vector<uint32_t> &losses)
+    {
+        const uint32_t w = grid.width(), h = grid.height();
+        for (long long i = 0; i < count; ++i)
+        {
+            const auto [x, y, dir] = split_pair_draw(rng.next(), w, h);
+            const int nx = x + NEIGHBOR_DX[dir];
+            const int ny = y + NEIGHBOR_DY[dir];
+            if (!grid.in_bounds(nx, ny))
+                continue;
+
+            const size_t ia = grid.layout.index(x, y);
+            const size_t ib = grid.layout.index(nx, ny);
+            const uint8_t ca = grid.code_at(ia);
+            const uint8_t cb = grid.code_at(ib);
+            if (ca == cb || ca == PACKED_WALL || cb == PACKED_WALL)
+                continue;
+
+            Cell a = decode_cell(ca, grid.pieces.data());
+            Cell b = decode_cell(cb, grid.pieces.data());
+            resolve_cells(
+                a, b, [&]()
+                { return static_cast<uint16_t>(rng.next()); },
+                [&](PlayerId loser)
+                {
+                    if (loser.v < losses.size())
+                        losses[loser.v]++;
+                });
+            grid.set_code_at(ia, encode_cell(a));
+            grid.set_code_at(ib, encode_cell(b));
+        }
+    }
+
+    // resolve_pairs_packed with K pairs' bytes prefetched ahead (see DrawAhead).
+    // Each entry keeps the byte it prefetched and the cell's shift in it, so
+    // the pop reads that byte as is instead of indexing the grid again.
+    // Only worth it once the grid outgrows the cache; see resolve_pairs_packed_auto.
+    template <int K = 16, typename Layout, int BITS, typename R>
+    void resolve_pairs_packed_pipelined(PackedGrid<Layout, BITS> &grid, R &rng, long long count,
+                                        std::vector<uint32_t> &losses)
+    {
+        using PG = PackedGrid<Layout, BITS>;
+        struct Entry
+        {
+            uint64_t r;
+            uint8_t *a;
+            uint8_t *b; // nullptr when the neighbor is off the grid
+            uint8_t sa, sb;
+        };
+        const uint32_t w = grid.width(), h = grid.height();
+        uint8_t *const bytes = grid.bytes.data();
+        auto make = [&](uint64_t r)
+        {
+            const auto [x, y, dir] = split_pair_draw(r, w, h);
+            const int nx = x + NEIGHBOR_DX[dir], ny = y + NEIGHBOR_DY[dir];
+            const size_t ia = grid.layout.index(x, y);
+            Entry e{r, bytes + ia / PG::PER_BYTE, nullptr, static_cast<uint8_t>((ia % PG::PER_BYTE) * BITS), 0};
+            HL_PREFETCH_W(e.a);
+            if (grid.in_bounds(nx, ny))
+            {
+                const size_t ib = grid.layout.index(nx, ny);
+                e.b = bytes + ib / PG::PER_BYTE;
+                e.sb = static_cast<uint8_t>((ib % PG::PER_BYTE) * BITS);
+                HL_PREFETCH_W(e.b);
+            }
+            return e;
+        };
+
+        DrawAhead<R, K, Entry> ahead(rng);
+        for (long long i = 0; i < count; ++i)
+        {
+            ahead.top_up(count - i, make);
+            const Entry e = ahead.pop();
+            if (!e.b)
+                continue;
+
+            const uint8_t ca = (*e.a >> e.sa) & PG::MASK;
+            const uint8_t cb = (*e.b >> e.sb) & PG::MASK;
+            if (ca == cb || ca == PACKED_WALL || cb == PACKED_WALL)
+                continue;
+
+            Cell a = decode_cell(ca, grid.pieces.data());
+            Cell b = decode_cell(cb, grid.pieces.data());
+            resolve_cells(
+                a, b, [&]()
+                { return static_cast<uint16_t>(ahead.pop_raw()); },
+                [&](PlayerId loser)
+                {
+                    if (loser.v < losses.size())
+                        losses[loser.v]++;
+                });
+            // a and b may share a byte, so the second write rereads it
+            *e.a = static_cast<uint8_t>((*e.a & ~(PG::MASK << e.sa)) | (encode_cell(a) << e.sa));
+            *e.b = static_cast<uint8_t>((*e.b & ~(PG::MASK << e.sb)) | (encode_cell(b) << e.sb));
+        }
+    }
+
+    // Below this many grid bytes the plain engine is faster: the cells are
+    // mostly cached and the ring only adds work. Measured on 4-bit row-major
+    // grids (Release build, 2 MB L2): plain 120-140M vs pipelined 48-59M
+    // pairs/s at 2 MB, 75-83M vs 57M at 8 MB, 28-35M vs 38-44M at 16 MB and
+    // 27-34M vs 53-57M at 32 MB.
+    constexpr size_t PACKED_PIPELINE_MIN_BYTES = size_t(16) << 20;
+
+    // resolve_pairs_packed or its pipelined twin, whichever is faster for the
+    // grid's size; both give the same results
+    template <typename Layout, int BITS, typename R>
+    void resolve_pairs_packed_auto(PackedGrid<Layout, BITS> &grid, R &rng, long long count,
+                                   std::vector<uint32_t> &losses)
+    {
+        if (grid.bytes.size() < PACKED_PIPELINE_MIN_BYTES)
+            resolve_pairs_packed(grid, rng, count, losses);
+        else
+            resolve_pairs_packed_pipelined(grid, rng, count, losses);
+    }
+}
@@ -0,0 +1,387 @@
+#include "core/Rules.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "core/PackedGrid.h"
+#include "util/Rng.h"
+
+bool in_bounds(int x, int y)
+{
+    return x >= 0 && x < hl::ARENA_W && y >= 0 && y < hl::ARENA_H;
+}
+
+std::pair<int, int> pick_neighbor(int x, int y, uint16_t r)
+{
+    // Pick one of 4 neighbors: N, E, S, W
+    int dir = r & 3;
+    switch (dir)
+    {
+    case 0:
+        return {x, y - 1}; // North
+    case 1:
+        return {x + 1, y}; // East
+    case 2:
+        return {x, y + 1}; // South
+    case 3:
+        return {x - 1, y}; // West
+    }
+    return {x, y}; // shouldn't happen
+}
+
+// ----------------- Activity Map -----------------
+static int block_of(int x, int y)
+{
+    return (y / hl::ACTIVITY_BLOCK) * (hl::ARENA_W / hl::ACTIVITY_BLOCK) + x / hl::ACTIVITY_BLOCK;
+}
+
+// Stores a cell, updating the live-edge counts of its four edges
+static void write_cell(hl::GameState &gs, int x, int y, const hl::Cell &c)
+{
+    using namespace hl;
+
+    const uint8_t before = encode_cell(gs.grid.at(x, y));
+    const uint8_t after = encode_cell(c);
+    gs.grid.at(x, y) = c;
+    if (before == after)
+        return;
+    for (uint16_t dir = 0; dir < 4; ++dir)
+    {
+        auto [nx, ny] = pick_neighbor(x, y, dir);
+        if (!in_bounds(nx, ny))
+            continue;
+        const uint8_t n = encode_cell(gs.grid.at(nx, ny));
+        gs.activity.edge_changed(block_of(x, y), block_of(nx, ny), live_edge(before, n), live_edge(after, n));
+    }
+}
+
+void rebuild_activity(hl::GameState &gs)
+{
+    using namespace hl;
+
+    gs.activity = ActivityMap(ARENA_W / ACTIVITY_BLOCK, ARENA_H / ACTIVITY_BLOCK);
+    gs.open_cells = 0;
+    for (int y = 0; y < ARENA_H; ++y)
+    {
+        for (int x = 0; x < ARENA_W; ++x)
+        {
+            const uint8_t c = encode_cell(gs.grid.at(x, y));
+            gs.open_cells += c != PACKED_WALL;
+            if (x + 1 < ARENA_W && live_edge(c, encode_cell(gs.grid.at(x + 1, y))))
+                gs.activity.edge_changed(block_of(x, y), block_of(x + 1, y), false, true);
+            if (y + 1 < ARENA_H && live_edge(c, encode_cell(gs.grid.at(x, y + 1))))
+                gs.activity.edge_changed(block_of(x, y), block_of(x, y + 1), false, true);
+        }
+    }
+}
+
+// ----------------- Combat Resolution -----------------
+void resolve_pair(hl::GameState &gs, int x, int y, int nx, int ny)
+{
+    using namespace hl;
+
+    if (!in_bounds(nx, ny))
+        return;
+
+    Cell a = gs.grid.at(x, y);
+    Cell b = gs.grid.at(nx, ny);
+
+    resolve_cells(
+        a, b, [&]()
+        { return static_cast<uint16_t>(rngu(gs)); },
+        [&](PlayerId loser)
+        {
+            if (loser.v < gs.players.size())
+                gs.players[loser.v].tick_losses++;
+        });
+
+    write_cell(gs, x, y, a);
+    write_cell(gs, nx, ny, b);
+}
+
+namespace
+{
+    // Debug counters for one drawn pair (see GameState::last_*)
+    struct PairCounts
+    {
+        int battles{0};
+        int same_player{0};
+        int wall_empty{0};
+
+        void add(const hl::GameState &gs, int x, int y, int nx, int ny)
+        {
+            if (!in_bounds(nx, ny))
+                return;
+            const auto &a = gs.grid.at(x, y);
+            const auto &b = gs.grid.at(nx, ny);
+
+            if (a.kind == hl::CellKind::Wall || b.kind == hl::CellKind::Wall ||
+                a.kind == hl::CellKind::Empty || b.kind == hl::CellKind::Empty) {
+                wall_empty++;
+            } else if (a.kind == hl::CellKind::Symbol && b.kind == hl::CellKind::Symbol) {
+                if (a.owner.v == b.owner.v) {
+                    same_player++;
+                } else {
+                    battles++;
+                }
+            }
+        }
+
+        void store(hl::GameState &gs, int attempts) const
+        {
+            gs.last_battles = battles;
+            gs.last_attempts = attempts;
+            gs.last_same_player = same_player;
+            gs.last_wall_empty = wall_empty;
+        }
+    };
+}
+
+// Sparse sampler: draws only from active blocks. The draws a full-arena
+// sampler would have spent on quiescent blocks are no-ops, so they are
+// skipped in bulk with a geometric count and the per-cell rate is unchanged.
+// Counters only see the draws actually made. A skip that runs past the end
+// of a slice is kept in t.skip, so slicing a tick does not change the draws.
+static void resolve_pairs_sparse(hl::GameState &gs, hl::TickSlice &t, int n, PairCounts &counts)
+{
+    using namespace hl;
+
+    constexpr int BLOCKS_X = ARENA_W / ACTIVITY_BLOCK;
+    constexpr int BLOCK_CELLS = ACTIVITY_BLOCK * ACTIVITY_BLOCK;
+    static_assert(BLOCK_CELLS <= 64, "cell offset comes from 6 bits of one draw");
+
+    int budget = n; // draw positions left in this slice
+    while (budget > 0)
+    {
+        if (t.skip < 0)
+        {
+            const int active = gs.activity.active_count();
+            if (active == 0)
+            {
+                // Nothing can change until the AIs run at the end of the tick
+                t.done += budget;
+                return;
+            }
+            const double p = static_cast<double>(active * BLOCK_CELLS) / (ARENA_W * ARENA_H);
+            t.skip = 0;
+            if (p < 1.0)
+            {
+                // Two statements: the order of the draws must not be the compiler's
+                const uint32_t hi = rngu(gs);
+                const uint32_t lo = rngu(gs);
+                const uint32_t r = (hi << 16) | lo;
+                const long long skip = skip_draws(p, (r + 1.0) * 0x1.0p-32);
+                const int remaining = t.total - t.done;
+                // Past the end of the tick: the rest of it is skipped
+                t.skip = skip >= remaining ? remaining : static_cast<int>(skip);
+            }
+        }
+        if (t.skip >= budget)
+        {
+            t.skip -= budget;
+            t.done += budget;
+            return;
+        }
+        budget -= t.skip + 1;
+        t.done += t.skip + 1;
+        t.skip = -1;
+
+        const int block = gs.activity.active_tile(static_cast<int>(rngu(gs) % gs.activity.active_count()));
+        const uint16_t r = static_cast<uint16_t>(rngu(gs));
+        const int off = r % BLOCK_CELLS;
+        const int x = (block % BLOCKS_X) * ACTIVITY_BLOCK + off % ACTIVITY_BLOCK;
+        const int y = (block / BLOCKS_X) * ACTIVITY_BLOCK + off / ACTIVITY_BLOCK;
+        auto [nx, ny] = pick_neighbor(x, y, r >> 6);
+
+        counts.add(gs, x, y, nx, ny);
+        resolve_pair(gs, x, y, nx, ny);
+    }
+}
+
+// Batched sampler: the tick's coordinate draws are taken up front and split
+// into runs of pairs that touch disjoint cells (found with a per-cell stamp).
+// Pairs in a run cannot see each other's writes, so the run is gathered into
+// lanes, resolved by a branch-free loop the compiler can vectorize, and
+// scattered back in draw order. A rule-5 coin is the draw right after its
+// pair; since a pair's cells are as they were at the start of its run, the
+// decoder knows which pairs need one and skips that draw, fetching one more
+// from the game RNG at the end, so the RNG ends exactly where the
+// sequential loop leaves it.
+namespace
+{
+    constexpr int BATCH_LANES = 64;
+
+    struct PairLanes
+    {
+        int a[BATCH_LANES];
+        int b[BATCH_LANES];
+        uint8_t ka[BATCH_LANES], oa[BATCH_LANES], pa[BATCH_LANES];
+        uint8_t kb[BATCH_LANES], ob[BATCH_LANES], pb[BATCH_LANES];
+        uint8_t coin[BATCH_LANES];
+        uint8_t act[BATCH_LANES];  // 0 none, 1 a := b, 2 b := a
+        uint8_t lost[BATCH_LANES]; // 1 when a symbol was taken
+    };
+
+    // Rules 1-6 and the debug counters over n lanes, with no branches on
+    // cell contents
+    void resolve_lanes(PairLanes &l, int n, PairCounts &counts)
+    {
+        int battles = 0, same_player = 0, wall_empty = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            const uint8_t wall = (l.ka[i] == 1) | (l.kb[i] == 1);
+            const uint8_t empty = (l.ka[i] == 0) | (l.kb[i] == 0);
+            const uint8_t sa = l.ka[i] == 2, sb = l.kb[i] == 2;
+            const uint8_t same = l.oa[i] == l.ob[i];
+            const uint8_t battle = sa & sb & !same;
+            const int d = l.pa[i] - l.pb[i];
+            const uint8_t beats = (d == 1) | (d == -2);
+            const uint8_t a_wins = battle & ((d == 0) ? l.coin[i] : beats);
+            const uint8_t b_wins = battle & !a_wins;
+            const uint8_t fill_a = (l.ka[i] == 0) & sb;
+            const uint8_t fill_b = (l.kb[i] == 0) & sa;
+            l.act[i] = static_cast<uint8_t>((b_wins | fill_a) + 2 * (a_wins | fill_b));
+            l.lost[i] = battle;
+            battles += battle;
+            same_player += sa & sb & same;
+            wall_empty += wall | empty;
+        }
+        counts.battles += battles;
+        counts.same_player += same_player;
+        counts.wall_empty += wall_empty;
+    }
+}
+
+static void resolve_pairs_batched(hl::GameState &gs, int count, PairCounts &counts)
+{
+    using namespace hl;
+
+    thread_local std::vector<uint16_t> draws;
+    thread_local std::array<uint32_t, ARENA_W * ARENA_H> stamp{};
+    thread_local uint32_t epoch = 0;
+    thread_local PairLanes lanes;
+
+    draws.resize(3 * static_cast<size_t>(count));
+    for (auto &d : draws)
+        d = static_cast<uint16_t>(rngu(gs));
+
+    size_t p = 0;
+    int done = 0;
+    while (done < count)
+    {
+        if (++epoch == 0)
+        {
+            stamp.fill(0);
+            epoch = 1;
+        }
+
+        // Decode and gather pairs until one shares a cell with an earlier one
+        int n = 0;
+        while (n < BATCH_LANES && done < count)
+        {
+            const int x = draws[p] % ARENA_W;
+            const int y = draws[p + 1] % ARENA_H;
+            auto [nx, ny] = pick_neighbor(x, y, draws[p + 2]);
+            if (!in_bounds(nx, ny))
+            {
+                // No-op, but still one pair of the tick
+                p += 3;
+                done++;
+                continue;
+            }
+            const int a = Grid::idx(x, y), b = Grid::idx(nx, ny);
+            if (stamp[a] == epoch || stamp[b] == epoch)
+                break;
+            stamp[a] = stamp[b] = epoch;
+            p += 3;
+            done++;
+
+            const Cell &ca = gs.grid.cells[a];
+            const Cell &cb = gs.grid.cells[b];
+            lanes.a[n] = a;
+            lanes.b[n] = b;
+            lanes.ka[n] = static_cast<uint8_t>(ca.kind);
+            lanes.oa[n] = ca.owner.v;
+            lanes.pa[n] = static_cast<uint8_t>(ca.piece);
+            lanes.kb[n] = static_cast<uint8_t>(cb.kind);
+            lanes.ob[n] = cb.owner.v;
+            lanes.pb[n] = static_cast<uint8_t>(cb.piece);
+            lanes.coin[n] = 0;
+            if (ca.kind == CellKind::Symbol && cb.kind == CellKind::Symbol && ca.owner.v != cb.owner.v &&
+                ca.piece == cb.piece)
+            {
+                // Rule 5 takes the next draw; later pairs shift by one
+                draws.push_back(static_cast<uint16_t>(rngu(gs)));
+                lanes.coin[n] = draws[p] & 1;
+                p++;
+            }
+            n++;
+        }
+
+        resolve_lanes(lanes, n, counts);
+
+        // Scatter in draw order
+        for (int i = 0; i < n; ++i)
+        {
+            if (lanes.act[i] == 0)
+                continue;
+            const int a = lanes.a[i], b = lanes.b[i];
+            if (lanes.act[i] == 1)
+                write_cell(gs, a % ARENA_W, a / ARENA_W, gs.grid.cells[b]);
+            else
+                write_cell(gs, b % ARENA_W, b / ARENA_W, gs.grid.cells[a]);
+            const uint8_t loser = lanes.act[i] == 1 ? lanes.oa[i] : lanes.ob[i];
+            if (lanes.lost[i] && loser < gs.players.size())
+                gs.players[loser].tick_losses++;
+        }
+    }
+}
+
+static void resolve_pairs_dense(hl::GameState &gs, int count, PairCounts &counts)
+{
+    // Random pair selection strategy
+    for (int i = 0; i < count; ++i)
+    {
+        // Pick a random cell and neighbor
+        const DenseDraw d = draw_dense_pair(gs);
+        const int x = d.x, y = d.y;
+        auto [nx, ny] = pick_neighbor(x, y, d.dir);
+
+        // Count interaction types
+        counts.add(gs, x, y, nx, ny);
+
+        resolve_pair(gs, x, y, nx, ny);
+    }
+}
+
+int resolve_pairs_slice(hl::GameState &gs, hl::TickSlice &t, int n)
+{
+    n = std::max(0, std::min(n, t.total - t.done));
+    PairCounts counts{t.battles, t.same_player, t.wall_empty};
+    if (gs.sparse_sampling)
+        resolve_pairs_sparse(gs, t, n, counts);
+    else
+    {
+        if (gs.batched_pairs)
+            resolve_pairs_batched(gs, n, counts);
+        else
+            resolve_pairs_dense(gs, n, counts);
+        t.done += n;
+    }
+    t.battles = counts.battles;
+    t.same_player = counts.same_player;
+    t.wall_empty = counts.wall_empty;
+
+    // Store stats for debug display once the tick's pairs are all done
+    if (t.done == t.total)
+        counts.store(gs, t.total);
+    return t.total - t.done;
+}
+
+void resolve_pairs(hl::GameState &gs, int count)
+{
+    hl::TickSlice t;
+    t.total = count;
+    resolve_pairs_slice(gs, t, count);
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <utility>
+
+#include "core/Game.h"
+#include "util/Rng.h"
+
+// ----------------- Grid helpers -----------------
+bool in_bounds(int x, int y);
+std::pair<int, int> pick_neighbor(int x, int y, uint16_t r);
+
+// The dense sampler's draws for one pair: x and y from one RNG value each,
+// then the value pick_neighbor takes the direction from
+struct DenseDraw
+{
+    int x{0};
+    int y{0};
+    uint16_t dir{0};
+};
+
+inline DenseDraw draw_dense_pair(hl::GameState &gs)
+{
+    DenseDraw d;
+    d.x = static_cast<uint16_t>(rngu(gs)) % hl::ARENA_W;
+    d.y = static_cast<uint16_t>(rngu(gs)) % hl::ARENA_H;
+    d.dir = static_cast<uint16_t>(rngu(gs));
+    return d;
+}
+
+// ----------------- Combat Resolution -----------------
+// Rules 1-6 for one pair of cells, shared by every engine. draw() supplies
+// the rule-5 coin flip (called only for same pieces of different owners) and
+// lost(owner) is told whose cell was taken.
+template <typename Draw, typename Lost>
+inline void resolve_cells(hl::Cell &a, hl::Cell &b, Draw &&draw, Lost &&lost)
+{
+    using namespace hl;
+
+    // Rule 1: If one is a wall, nothing happens
+    if (a.kind == CellKind::Wall || b.kind == CellKind::Wall)
+        return;
+
+    // Rule 2: If both are empty, nothing happens
+    if (a.kind == CellKind::Empty && b.kind == CellKind::Empty)
+        return;
+
+    // Rule 3: If one is empty and other is symbol, copy symbol to empty
+    if (a.kind == CellKind::Empty && b.kind == CellKind::Symbol)
+    {
+        a = b; // copy symbol to empty space
+        return;
+    }
+    if (b.kind == CellKind::Empty && a.kind == CellKind::Symbol)
+    {
+        b = a; // copy symbol to empty space
+        return;
+    }
+
+    // Rule 4: If both are symbols from same player, nothing happens
+    if (a.kind == CellKind::Symbol && b.kind == CellKind::Symbol)
+    {
+        if (a.owner.v == b.owner.v)
+            return;
+
+        // Rule 5: Same symbols from different players - 50/50 chance
+        if (a.piece == b.piece)
+        {
+            uint16_t r = draw();
+            if (r & 1)
+            {
+                // a wins, b loses
+                PlayerId loser = b.owner;
+                b = a; // a wins
+                lost(loser);
+            }
+            else
+            {
+                // b wins, a loses
+                PlayerId loser = a.owner;
+                a = b; // b wins
+                lost(loser);
+            }
+            return;
+        }
+
+        // Rule 6: Different symbols - Rock-Paper-Scissors rules
+        bool a_wins = false;
+
+        if (a.piece == Piece::Rock && b.piece == Piece::Scissors)
+            a_wins = true;
+        else if (a.piece == Piece::Scissors && b.piece == Piece::Paper)
+            a_wins = true;
+        else if (a.piece == Piece::Paper && b.piece == Piece::Rock)
+            a_wins = true;
+
+        if (a_wins)
+        {
+            // a wins, b loses
+            PlayerId loser = b.owner;
+            b = a; // a wins
+            lost(loser);
+        }
+        else
+        {
+            // b wins, a loses
+            PlayerId loser = a.owner;
+            a = b; // b wins
+            lost(loser);
+        }
+    }
+}
+
+// Applies one interaction between cell A and its chosen neighbor B
+void resolve_pair(hl::GameState &gs, int x, int y, int nx, int ny);
+
+// Applies N interactions per tick (count = cfg.pairs_per_tick). With
+// gs.sparse_sampling, draws that would land in quiescent blocks are skipped.
+void resolve_pairs(hl::GameState &gs, int count);
+
+// Resolves the next (up to) n of the t.total draws of a tick and returns how
+// many remain. Any split of a tick into slices gives the same result as one
+// resolve_pairs(gs, t.total); the debug counters are stored with the last.
+int resolve_pairs_slice(hl::GameState &gs, hl::TickSlice &t, int n);
+
+// ----------------- Activity Map -----------------
+// Recomputes gs.activity and gs.open_cells from the grid. Call after writing
+// cells directly (level loads); resolve_pair keeps them current from then on.
+void rebuild_activity(hl::GameState &gs);
@@ -0,0 +1,54 @@
+#include "levels/Levels.h"
+
+#include "core/Rules.h"
+
+// Level 1: outer wall; left half player(0), right half opponent(1). Cells
+// only; load_level rebuilds the activity map afterwards.
+static void load_level1(hl::GameState &gs)
+{
+    using namespace hl;
+    gs.grid.clear();
+    // Border walls
+    for (int x = 0; x < ARENA_W; ++x)
+    {
+        gs.grid.at(x, 0).kind = CellKind::Wall;
+        gs.grid.at(x, ARENA_H - 1).kind = CellKind::Wall;
+    }
+    for (int y = 0; y < ARENA_H; ++y)
+    {
+        gs.grid.at(0, y).kind = CellKind::Wall;
+        gs.grid.at(ARENA_W - 1, y).kind = CellKind::Wall;
+    }
+    // Left half player(0), right half opponent(1)
+    for (int y = 1; y < ARENA_H - 1; ++y)
+    {
+        for (int x = 1; x < ARENA_W - 1; ++x)
+        {
+            if (x < ARENA_W / 2)
+            {
+                gs.grid.at(x, y).kind = hl::CellKind::Symbol;
+                gs.grid.at(x, y).owner = hl::PlayerId{0};
+                gs.grid.at(x, y).piece = gs.players[0].current;
+            }
+            else
+            {
+                gs.grid.at(x, y).kind = hl::CellKind::Symbol;
+                gs.grid.at(x, y).owner = hl::PlayerId{1};
+                gs.grid.at(x, y).piece = gs.players[1].current;
+            }
+        }
+    }
+}
+
+void load_level(hl::GameState &gs, int level_id)
+{
+    switch (level_id)
+    {
+    case 1:
+    default:
+        load_level1(gs);
+        break;
+    }
+    rebuild_activity(gs);
+    gs.slice = hl::TickSlice{}; // drops any half-resolved tick
+}
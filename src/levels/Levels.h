@@ -0,0 +1,10 @@
+#pragma once
+
+#include "core/Game.h"
+
+// ----------------- Level Init -----------------
+// Number of levels implemented so far (ids 1..LEVEL_COUNT)
+constexpr int LEVEL_COUNT = 1;
+
+// Loads level `level_id`; unknown ids fall back to level 1
+void load_level(hl::GameState &gs, int level_id);
@@ -0,0 +1,94 @@
+#include "sim/Batch.h"
+
+#include <memory>
+
+#include "ai/AiMeter.h"
+#include "ai/AsyncAi.h"
+#include "levels/Levels.h"
+
+namespace hl
+{
+    static PlayerState make_player(uint8_t id, Piece start, const SideConfig &side)
+    {
+        PlayerState p{PlayerId{id}, start};
+        p.ai = side.ai;
+        p.albert = side.albert;
+        p.table = side.table;
+        p.rollout = side.rollout;
+        return p;
+    }
+
+    void start_match(GameState &gs, const MatchSpec &spec)
+    {
+        gs.players = {make_player(0, Piece::Rock, spec.left),
+                      make_player(1, Piece::Scissors, spec.right)};
+        seed_game(gs, spec.seed, spec.lfsr);
+        gs.lfsr_stride = static_cast<uint8_t>(spec.lfsr_stride);
+        gs.sparse_sampling = spec.sparse;
+        gs.cfg = spec.cfg;
+        load_level(gs, spec.level);
+        gs.phase = Phase::Playing;
+    }
+
+    MatchResult run_match(const MatchSpec &spec)
+    {
+        GameState gs;
+        start_match(gs, spec);
+        std::unique_ptr<AiScheduler> async_ai;
+        if (spec.ai_latency > 0)
+        {
+            // Lockstep with no misses: the result depends only on the seed
+            AsyncAiConfig cfg;
+            cfg.latency = spec.ai_latency;
+            cfg.timing = AiTiming::Lockstep;
+            cfg.seed = spec.seed;
+            async_ai = std::make_unique<AiScheduler>(cfg);
+            gs.async_ai = async_ai.get();
+        }
+        AiMeter meter;
+        if (spec.ai_meter)
+        {
+            meter.budget = spec.ai_meter->budget;
+            meter.enforce = spec.ai_meter->enforce;
+            gs.ai_meter = &meter;
+        }
+
+        MatchResult res;
+        while (gs.phase == Phase::Playing && gs.tick < spec.max_ticks && !meter.failed())
+        {
+            step_fixed(gs);
+            if (spec.on_tick && !spec.on_tick(gs))
+                break;
+        }
+
+        if (spec.ai_meter)
+            spec.ai_meter->merge(meter);
+        Metrics::instance().game(gs.tick, gs.rng_draws);
+
+        res.ticks = gs.tick;
+        if (gs.phase == Phase::Won)
+            res.winner = 0;
+        else if (gs.phase == Phase::Lost)
+            res.winner = 1;
+        return res;
+    }
+
+    uint16_t lfsr_seed(uint64_t seed)
+    {
+        // splitmix64 finalizer, folded to 16 bits; zero would lock the LFSR
+        uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z ^= z >> 31;
+        uint16_t s = static_cast<uint16_t>(z ^ (z >> 16) ^ (z >> 32) ^ (z >> 48));
+        return s ? s : 0xACE1;
+    }
+
+    void seed_game(GameState &gs, uint64_t seed, bool lfsr)
+    {
+        gs.use_system_rng = !lfsr;
+        gs.rng16 = lfsr_seed(seed);
+        std::seed_seq seq{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+        gs.system_rng.seed(seq);
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "core/Game.h"
+#include "util/Metrics.h"
+
+// ----------------- Headless Matches -----------------
+namespace hl
+{
+    // One side of a headless match: which AI plays it and with what tuning
+    struct SideConfig
+    {
+        AiKind ai{AiKind::Albert};
+        AlbertConfig albert{};
+        TableAiConfig table{};
+        RolloutConfig rollout{};
+    };
+
+    struct MatchSpec
+    {
+        SideConfig left{};    // player 0 (left half on level 1)
+        SideConfig right{};   // player 1 (right half on level 1)
+        int level{1};
+        uint64_t seed{1};     // seeds whichever RNG the game uses
+        bool lfsr{false};     // use the 16-bit LFSR instead of the system RNG
+        int lfsr_stride{1};   // LFSR steps per draw: 1, 8 or 16
+        bool sparse{false};   // sample pairs from active blocks only
+        GameConfig cfg{};     // pair budget per tick
+        int max_ticks{6000};  // games still running here are scored as draws
+        int ai_latency{0};    // > 0: AIs decide on a worker, applied this many ticks later
+        AiMeter *ai_meter{nullptr}; // merge this game's AI costs here; stops early on a violation
+        std::function<bool(const GameState &)> on_tick; // after every tick; false stops the game
+    };
+
+    struct MatchResult
+    {
+        int winner{-1};          // 0 = left, 1 = right, -1 = timeout
+        int ticks{0};            // ticks played
+    };
+
+    // Plays one game of spec.level to completion (or max_ticks) with both sides AI-driven
+    MatchResult run_match(const MatchSpec &spec);
+
+    // Sets a fresh gs up as run_match does (players, RNG, sampler, budget,
+    // level) and starts it; async AI, meters and the tick loop are the caller's
+    void start_match(GameState &gs, const MatchSpec &spec);
+
+    // Maps an arbitrary 64-bit seed onto the 65535 non-zero LFSR states
+    uint16_t lfsr_seed(uint64_t seed);
+
+    // Seeds both RNG sources of gs from one 64-bit seed and selects one of them
+    void seed_game(GameState &gs, uint64_t seed, bool lfsr);
+
+    // Runs fn(i) for i in [0, n) on up to `threads` workers (0 = all cores).
+    // Work is handed out one index at a time, so results must be stored by index.
+    // Each index counts as one task in the metrics; spawned workers report as
+    // "pool/1", "pool/2", ... and the remaining indices as handlords_queue_depth.
+    template <typename F>
+    void parallel_for(int n, int threads, F fn)
+    {
+        if (threads <= 0)
+            threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        threads = std::min(threads, std::max(1, n));
+
+        std::atomic<int> next{0};
+        MetricGauge depth("handlords_queue_depth", "Work items waiting in pool queues.",
+                          [&] { return static_cast<double>(n - std::min(n, next.load())); });
+        auto worker = [&]()
+        {
+            Metrics &m = Metrics::instance();
+            for (int i = next++; i < n; i = next++)
+            {
+                const auto t0 = std::chrono::steady_clock::now();
+                fn(i);
+                m.task(std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (int t = 1; t < threads; ++t)
+        {
+            pool.emplace_back([&worker, t]
+                              {
+                                  Metrics::instance().set_worker("pool/" + std::to_string(t));
+                                  worker(); });
+        }
+        worker();
+        for (auto &t : pool)
+            t.join();
+    }
+}
@@ -0,0 +1,200 @@
+#include "sim/BenchCompare.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#include "util/Rng.h"
+
+namespace hl
+{
+    bool write_bench_results(const std::string &path, const std::vector<BenchSeries> &series,
+                             const std::string &comment, std::string &err)
+    {
+        std::ofstream out(path);
+        if (!out)
+        {
+            err = "cannot write " + path;
+            return false;
+        }
+        std::istringstream lines(comment);
+        std::string line;
+        while (std::getline(lines, line))
+            out << "# " << line << "\n";
+        out.precision(17);
+        for (const auto &s : series)
+        {
+            out << s.name << " " << s.unit;
+            for (double x : s.samples)
+                out << " " << x;
+            out << "\n";
+        }
+        return true;
+    }
+
+    bool read_bench_results(const std::string &path, std::vector<BenchSeries> &series, std::string &err)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            err = "cannot read " + path;
+            return false;
+        }
+        series.clear();
+        std::string line;
+        int lineno = 0;
+        while (std::getline(in, line))
+        {
+            lineno++;
+            if (line.empty() || line[0] == '#')
+                continue;
+            std::istringstream fields(line);
+            BenchSeries s;
+            double x;
+            fields >> s.name >> s.unit;
+            while (fields >> x)
+                s.samples.push_back(x);
+            if (s.unit.empty() || s.samples.empty() || !fields.eof())
+            {
+                err = path + ":" + std::to_string(lineno) + ": expected \"name unit rate...\"";
+                return false;
+            }
+            series.push_back(std::move(s));
+        }
+        return true;
+    }
+
+    double median_of(std::vector<double> v)
+    {
+        if (v.empty())
+            return 0.0;
+        const size_t h = v.size() / 2;
+        std::nth_element(v.begin(), v.begin() + h, v.end());
+        if (v.size() % 2)
+            return v[h];
+        return 0.5 * (v[h] + *std::max_element(v.begin(), v.begin() + h));
+    }
+
+    double mann_whitney_p(const std::vector<double> &a, const std::vector<double> &b)
+    {
+        const size_t n1 = a.size(), n2 = b.size();
+        if (n1 == 0 || n2 == 0)
+            return 1.0;
+
+        // U counts the pairs where a wins, ties as half
+        double u = 0.0;
+        bool ties = false;
+        for (double x : a)
+        {
+            for (double y : b)
+            {
+                if (x > y)
+                    u += 1.0;
+                else if (x == y)
+                {
+                    u += 0.5;
+                    ties = true;
+                }
+            }
+        }
+
+        if (!ties && n1 <= 30 && n2 <= 30)
+        {
+            // ways[j][k]: orderings of i a's and j b's with U = k, built up over i
+            const size_t umax = n1 * n2;
+            std::vector<std::vector<double>> ways(n2 + 1, std::vector<double>(umax + 1, 0.0));
+            for (size_t j = 0; j <= n2; ++j)
+                ways[j][0] = 1.0;
+            for (size_t i = 1; i <= n1; ++i)
+            {
+                // Last element is an a (beats all j b's) or a b
+                std::vector<std::vector<double>> next(n2 + 1, std::vector<double>(umax + 1, 0.0));
+                for (size_t j = 0; j <= n2; ++j)
+                {
+                    for (size_t k = 0; k <= umax; ++k)
+                    {
+                        double w = k >= j ? ways[j][k - j] : 0.0;
+                        if (j > 0)
+                            w += next[j - 1][k];
+                        next[j][k] = w;
+                    }
+                }
+                ways.swap(next);
+            }
+            double total = 0.0, lo = 0.0, hi = 0.0;
+            const size_t uk = static_cast<size_t>(u);
+            for (size_t k = 0; k <= umax; ++k)
+            {
+                total += ways[n2][k];
+                if (k <= uk)
+                    lo += ways[n2][k];
+                if (k >= uk)
+                    hi += ways[n2][k];
+            }
+            return std::min(1.0, 2.0 * std::min(lo, hi) / total);
+        }
+
+        // Normal approximation; the variance shrinks with tied groups
+        std::vector<double> all(a);
+        all.insert(all.end(), b.begin(), b.end());
+        std::sort(all.begin(), all.end());
+        double tie_sum = 0.0;
+        for (size_t i = 0; i < all.size();)
+        {
+            size_t j = i;
+            while (j < all.size() && all[j] == all[i])
+                ++j;
+            const double t = static_cast<double>(j - i);
+            tie_sum += t * t * t - t;
+            i = j;
+        }
+        const double n = static_cast<double>(n1 + n2);
+        const double mu = 0.5 * n1 * n2;
+        const double var = n1 * n2 / 12.0 * ((n + 1.0) - tie_sum / (n * (n - 1.0)));
+        if (var <= 0.0)
+            return 1.0;
+        const double z = std::max(0.0, std::fabs(u - mu) - 0.5) / std::sqrt(var);
+        return std::erfc(z / std::sqrt(2.0));
+    }
+
+    BenchComparison compare_series(const BenchSeries &base, const BenchSeries &cand, const CompareOptions &o)
+    {
+        BenchComparison c;
+        c.base_median = median_of(base.samples);
+        c.new_median = median_of(cand.samples);
+        if (c.base_median <= 0.0)
+            return c;
+        c.change = c.new_median / c.base_median - 1.0;
+
+        // Percentile bootstrap, resampling each side on its own
+        Rng64 rng{o.seed};
+        std::vector<double> changes, rb(base.samples.size()), rc(cand.samples.size());
+        changes.reserve(o.resamples);
+        for (int r = 0; r < o.resamples; ++r)
+        {
+            for (auto &x : rb)
+                x = base.samples[Rng64::scale(rng.next(), static_cast<uint32_t>(base.samples.size()))];
+            for (auto &x : rc)
+                x = cand.samples[Rng64::scale(rng.next(), static_cast<uint32_t>(cand.samples.size()))];
+            const double mb = median_of(rb);
+            if (mb > 0.0)
+                changes.push_back(median_of(rc) / mb - 1.0);
+        }
+        if (!changes.empty())
+        {
+            std::sort(changes.begin(), changes.end());
+            c.ci_lo = changes[static_cast<size_t>(0.025 * (changes.size() - 1))];
+            c.ci_hi = changes[static_cast<size_t>(0.975 * (changes.size() - 1))];
+        }
+        c.p_value = mann_whitney_p(cand.samples, base.samples);
+
+        if (o.test == BenchTest::Bootstrap)
+            c.significant = c.ci_lo > 0.0 || c.ci_hi < 0.0;
+        else
+            c.significant = c.p_value < o.alpha;
+        c.regression = c.significant && c.change < -o.threshold;
+        c.improvement = c.significant && c.change > o.threshold;
+        return c;
+    }
+}
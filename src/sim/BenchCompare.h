@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ----------------- Benchmark Comparison -----------------
+namespace hl
+{
+    // Repeated measurements of one benchmark case; every unit is a rate, so
+    // higher is better
+    struct BenchSeries
+    {
+        std::string name;
+        std::string unit;
+        std::vector<double> samples;
+    };
+
+    // Result files hold one case per line, "name unit rate rate ...", with
+    // '#' comment lines (the bench writes its settings there)
+    bool write_bench_results(const std::string &path, const std::vector<BenchSeries> &series,
+                             const std::string &comment, std::string &err);
+    bool read_bench_results(const std::string &path, std::vector<BenchSeries> &series, std::string &err);
+
+    double median_of(std::vector<double> v);
+
+    enum class BenchTest
+    {
+        Bootstrap,   // 95% bootstrap interval of the median change excludes zero
+        MannWhitney, // two-sided rank-sum p-value below alpha
+    };
+
+    struct CompareOptions
+    {
+        BenchTest test{BenchTest::Bootstrap};
+        double threshold{0.03}; // smallest relative change worth flagging
+        double alpha{0.05};
+        int resamples{4000};
+        uint64_t seed{1};
+    };
+
+    struct BenchComparison
+    {
+        double base_median{0.0}, new_median{0.0};
+        double change{0.0};              // new / base - 1 on the medians
+        double ci_lo{0.0}, ci_hi{0.0};   // bootstrap 95% interval of change
+        double p_value{1.0};             // Mann-Whitney, two-sided
+        bool significant{false};         // by the selected test
+        bool regression{false};          // significant and change < -threshold
+        bool improvement{false};         // significant and change > threshold
+    };
+
+    BenchComparison compare_series(const BenchSeries &base, const BenchSeries &cand, const CompareOptions &o);
+
+    // Two-sided Mann-Whitney U test. Exact for small samples without ties,
+    // otherwise the normal approximation with tie and continuity corrections.
+    double mann_whitney_p(const std::vector<double> &a, const std::vector<double> &b);
+}
@@ -0,0 +1,626 @@
+#include "sim/Differential.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+#include "ai/Ai.h"
+#include "ai/AsyncAi.h"
+#include "core/PackedGrid.h"
+#include "core/Rules.h"
+#include "levels/Levels.h"
+#include "sim/Batch.h"
+#include "util/Rng.h"
+
+namespace hl
+{
+    uint64_t GameRng::next()
+    {
+        const uint64_t v = rngu(*gs);
+        uint64_t z = v + 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z ^= z >> 31;
+        return (z & ~1ull) | (v & 1);
+    }
+
+    void DiffEngine::load(const GameState &gs)
+    {
+        driver = gs;
+        losses_.assign(gs.players.size(), 0);
+        load_cells();
+    }
+
+    void DiffEngine::begin_tick()
+    {
+        driver.tick++;
+        for (auto &player : driver.players)
+            player.tick_losses = 0;
+    }
+
+    void DiffEngine::end_tick()
+    {
+        for (auto &player : driver.players)
+            update_ai(driver, player);
+        sync_pieces();
+    }
+
+    // ----------------- Engines -----------------
+    namespace
+    {
+        class ReferenceEngine : public DiffEngine
+        {
+        public:
+            ReferenceEngine() : DiffEngine("reference") {}
+
+            void resolve(int count) override
+            {
+                GameRng rng{&driver};
+                for (int i = 0; i < count; ++i)
+                {
+                    last = split_pair_draw(rng.next(), ARENA_W, ARENA_H);
+                    resolve_pair(driver, last.x, last.y, last.x + NEIGHBOR_DX[last.dir],
+                                 last.y + NEIGHBOR_DY[last.dir]);
+                }
+            }
+
+            Cell at(int x, int y) const override { return driver.grid.at(x, y); }
+
+            // The incrementally kept activity map must equal a rebuilt one
+            bool activity_consistent() const
+            {
+                GameState copy = driver;
+                rebuild_activity(copy);
+                for (int t = 0; t < copy.activity.tile_count(); ++t)
+                {
+                    if (copy.activity.live(t) != driver.activity.live(t) ||
+                        copy.activity.active(t) != driver.activity.active(t))
+                        return false;
+                }
+                return copy.activity.active_count() == driver.activity.active_count() &&
+                       copy.activity.live_edges() == driver.activity.live_edges();
+            }
+
+            PairDraw last{0, 0, 0};
+
+        protected:
+            // The driver's grid is the board; rotate_player already repaints it
+            void load_cells() override {}
+            void sync_pieces() override {}
+        };
+
+        template <typename Layout, bool PIPELINED = false>
+        class LargeEngine : public DiffEngine
+        {
+        public:
+            explicit LargeEngine(const char *name) : DiffEngine(name) {}
+
+            void resolve(int count) override
+            {
+                GameRng rng{&driver};
+                if (PIPELINED)
+                    resolve_pairs_large_pipelined(grid_, rng, count, losses_);
+                else
+                    resolve_pairs_large(grid_, rng, count, losses_);
+            }
+
+            Cell at(int x, int y) const override { return grid_.at(x, y); }
+
+        protected:
+            void load_cells() override
+            {
+                for (int y = 0; y < ARENA_H; ++y)
+                    for (int x = 0; x < ARENA_W; ++x)
+                        grid_.set(x, y, driver.grid.at(x, y));
+            }
+
+            void sync_pieces() override
+            {
+                for (auto &c : grid_.cells)
+                {
+                    if (c.kind == CellKind::Symbol && c.owner.v < driver.players.size())
+                        c.piece = driver.players[c.owner.v].current;
+                }
+            }
+
+        private:
+            LargeGrid<Layout> grid_{ARENA_W, ARENA_H};
+        };
+
+        template <typename Layout, int BITS, bool PIPELINED = false>
+        class PackedEngine : public DiffEngine
+        {
+        public:
+            PackedEngine(const char *name, bool stale_pieces = false) : DiffEngine(name), stale_(stale_pieces) {}
+
+            int max_players() const override { return PackedGrid<Layout, BITS>::MAX_PLAYERS; }
+
+            void resolve(int count) override
+            {
+                GameRng rng{&driver};
+                if (PIPELINED)
+                    resolve_pairs_packed_pipelined(grid_, rng, count, losses_);
+                else
+                    resolve_pairs_packed(grid_, rng, count, losses_);
+            }
+
+            Cell at(int x, int y) const override { return grid_.at(x, y); }
+
+        protected:
+            void load_cells() override
+            {
+                for (int y = 0; y < ARENA_H; ++y)
+                    for (int x = 0; x < ARENA_W; ++x)
+                        grid_.set(x, y, driver.grid.at(x, y));
+                for (size_t p = 0; p < driver.players.size(); ++p)
+                    grid_.pieces[p] = pending_[p] = driver.players[p].current;
+            }
+
+            void sync_pieces() override
+            {
+                for (size_t p = 0; p < driver.players.size(); ++p)
+                {
+                    grid_.pieces[p] = stale_ ? pending_[p] : driver.players[p].current;
+                    pending_[p] = driver.players[p].current;
+                }
+            }
+
+        private:
+            PackedGrid<Layout, BITS> grid_{ARENA_W, ARENA_H};
+            bool stale_;
+            std::array<Piece, 14> pending_{};
+        };
+    }
+
+    std::vector<std::unique_ptr<DiffEngine>> make_candidate_engines(bool inject_bug)
+    {
+        std::vector<std::unique_ptr<DiffEngine>> out;
+        out.push_back(std::make_unique<LargeEngine<RowMajorLayout>>("large/row-major"));
+        out.push_back(std::make_unique<LargeEngine<TiledLayout>>("large/tiled"));
+        out.push_back(std::make_unique<LargeEngine<MortonLayout>>("large/morton"));
+        out.push_back(std::make_unique<PackedEngine<RowMajorLayout, 4>>("packed4/row-major"));
+        out.push_back(std::make_unique<PackedEngine<TiledLayout, 4>>("packed4/tiled"));
+        out.push_back(std::make_unique<PackedEngine<RowMajorLayout, 2>>("packed2/row-major"));
+        out.push_back(std::make_unique<LargeEngine<RowMajorLayout, true>>("large-pf/row-major"));
+        out.push_back(std::make_unique<LargeEngine<MortonLayout, true>>("large-pf/morton"));
+        out.push_back(std::make_unique<PackedEngine<RowMajorLayout, 4, true>>("packed4-pf/row-major"));
+        if (inject_bug)
+            out.push_back(std::make_unique<PackedEngine<RowMajorLayout, 4>>("buggy/stale-pieces", true));
+        return out;
+    }
+
+    // ----------------- Random Cases -----------------
+    GameState make_case_state(const DiffCase &c)
+    {
+        Rng64 rng{c.seed};
+        GameState gs;
+        const uint64_t game_seed = rng.next();
+        seed_game(gs, game_seed, rng.next() & 1);
+
+        for (int p = 0; p < c.players; ++p)
+        {
+            PlayerState player{PlayerId{static_cast<uint8_t>(p)}, static_cast<Piece>(Rng64::scale(rng.next(), 3))};
+            player.ai = AiKind::Albert;
+            player.albert.rotation_average = 2 + static_cast<int>(Rng64::scale(rng.next(), 60));
+            player.albert.rotation_half_interval = static_cast<int>(Rng64::scale(rng.next(), 60));
+            gs.players.push_back(player);
+        }
+
+        auto random_cell = [&](double empty)
+        {
+            const double u = (rng.next() >> 11) * 0x1.0p-53;
+            if (u < 0.05)
+                return Cell{CellKind::Wall, PlayerId{0}, Piece::Rock};
+            if (u < 0.05 + empty)
+                return Cell{};
+            const auto owner = static_cast<uint8_t>(Rng64::scale(rng.next(), c.players));
+            return Cell{CellKind::Symbol, PlayerId{owner}, gs.players[owner].current};
+        };
+
+        if (rng.next() & 1)
+        {
+            // Level 1 with a sprinkling of random cells
+            load_level(gs, 1);
+            const int sprinkle = static_cast<int>(Rng64::scale(rng.next(), 64));
+            for (int i = 0; i < sprinkle; ++i)
+            {
+                const int x = 1 + static_cast<int>(Rng64::scale(rng.next(), ARENA_W - 2));
+                const int y = 1 + static_cast<int>(Rng64::scale(rng.next(), ARENA_H - 2));
+                gs.grid.at(x, y) = random_cell(0.3);
+            }
+        }
+        else
+        {
+            // Uniform noise inside the border wall
+            const double empty = (rng.next() >> 11) * 0x1.0p-53 * 0.5;
+            for (int y = 0; y < ARENA_H; ++y)
+            {
+                for (int x = 0; x < ARENA_W; ++x)
+                {
+                    const bool border = x == 0 || y == 0 || x == ARENA_W - 1 || y == ARENA_H - 1;
+                    gs.grid.at(x, y) = border ? Cell{CellKind::Wall, PlayerId{0}, Piece::Rock} : random_cell(empty);
+                }
+            }
+        }
+        rebuild_activity(gs);
+        gs.phase = Phase::Playing;
+        return gs;
+    }
+
+    // ----------------- Lockstep -----------------
+    namespace
+    {
+        const char *PIECE_NAMES[] = {"Rock", "Paper", "Scissors"};
+
+        std::string describe(const Cell &c)
+        {
+            switch (c.kind)
+            {
+            case CellKind::Empty:
+                return "empty";
+            case CellKind::Wall:
+                return "wall";
+            case CellKind::Symbol:
+                break;
+            }
+            return "p" + std::to_string(c.owner.v) + " " + PIECE_NAMES[static_cast<int>(c.piece) % 3];
+        }
+
+        std::string first_cell_difference(const DiffEngine &ref, const DiffEngine &e)
+        {
+            for (int y = 0; y < ARENA_H; ++y)
+            {
+                for (int x = 0; x < ARENA_W; ++x)
+                {
+                    const Cell a = ref.at(x, y), b = e.at(x, y);
+                    if (describe(a) != describe(b))
+                    {
+                        return "cell (" + std::to_string(x) + "," + std::to_string(y) + "): reference " +
+                               describe(a) + ", " + e.name() + " " + describe(b);
+                    }
+                }
+            }
+            return "boards equal";
+        }
+
+        void run_tick(DiffEngine &e, int pairs)
+        {
+            e.begin_tick();
+            e.resolve(pairs);
+            e.end_tick();
+        }
+
+        // First tick at which e's board differs from the reference, 0 if none
+        int first_failing_tick(const DiffCase &c, ReferenceEngine &ref, DiffEngine &e)
+        {
+            const GameState start = make_case_state(c);
+            ref.load(start);
+            e.load(start);
+            for (int tick = 1; tick <= c.ticks; ++tick)
+            {
+                run_tick(ref, c.pairs);
+                run_tick(e, c.pairs);
+                if (ref.hash() != e.hash())
+                    return tick;
+            }
+            return 0;
+        }
+
+        // Shrinks pairs per tick, then pins the failure to one pair (or the AI step)
+        void minimize(const DiffCase &c, int fail_tick, ReferenceEngine &ref, DiffEngine &e, Divergence &out)
+        {
+            DiffCase best = c;
+            best.ticks = fail_tick;
+            for (int pairs = best.pairs / 2; pairs >= 1; pairs /= 2)
+            {
+                DiffCase trial = best;
+                trial.pairs = pairs;
+                trial.ticks = c.ticks;
+                const int t = first_failing_tick(trial, ref, e);
+                if (t == 0)
+                    break;
+                best = trial;
+                best.ticks = t;
+            }
+
+            const GameState start = make_case_state(best);
+            ref.load(start);
+            e.load(start);
+            for (int tick = 1; tick < best.ticks; ++tick)
+            {
+                run_tick(ref, best.pairs);
+                run_tick(e, best.pairs);
+            }
+
+            out.engine = e.name();
+            out.repro = best;
+            out.tick = best.ticks;
+            out.pair = -1;
+            ref.begin_tick();
+            e.begin_tick();
+            for (int k = 0; k < best.pairs; ++k)
+            {
+                ref.resolve(1);
+                e.resolve(1);
+                if (ref.hash() != e.hash())
+                {
+                    const PairDraw d = ref.last;
+                    out.pair = k;
+                    out.detail = "pair (" + std::to_string(d.x) + "," + std::to_string(d.y) + ") -> (" +
+                                 std::to_string(d.x + NEIGHBOR_DX[d.dir]) + "," +
+                                 std::to_string(d.y + NEIGHBOR_DY[d.dir]) + "); " + first_cell_difference(ref, e);
+                    return;
+                }
+            }
+            ref.end_tick();
+            e.end_tick();
+            out.detail = "AI step; " + first_cell_difference(ref, e);
+        }
+    }
+
+    // resolve_pairs with gs.batched_pairs must leave the same game state,
+    // RNG and per-tick stats as the sequential loop
+    static bool run_batched_case(const DiffCase &c, Divergence &out)
+    {
+        GameState seq = make_case_state(c);
+        GameState bat = seq;
+        bat.batched_pairs = true;
+        for (int tick = 1; tick <= c.ticks; ++tick)
+        {
+            for (GameState *gs : {&seq, &bat})
+            {
+                gs->tick++;
+                for (auto &player : gs->players)
+                    player.tick_losses = 0;
+                resolve_pairs(*gs, c.pairs);
+                for (auto &player : gs->players)
+                    update_ai(*gs, player);
+            }
+            if (hash_game_state(seq) != hash_game_state(bat) || seq.last_battles != bat.last_battles ||
+                seq.last_same_player != bat.last_same_player || seq.last_wall_empty != bat.last_wall_empty)
+            {
+                out.engine = "batched";
+                out.repro = c;
+                out.repro.ticks = tick;
+                out.tick = tick;
+                out.detail = "resolve_pairs batched vs sequential: state, RNG or counters differ";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool run_diff_case(const DiffCase &c, const std::vector<std::unique_ptr<DiffEngine>> &candidates,
+                       Divergence &out)
+    {
+        if (!run_batched_case(c, out))
+            return false;
+
+        const GameState start = make_case_state(c);
+        ReferenceEngine ref;
+        ref.load(start);
+
+        std::vector<DiffEngine *> active;
+        for (const auto &e : candidates)
+        {
+            if (e->max_players() >= c.players)
+            {
+                e->load(start);
+                active.push_back(e.get());
+            }
+        }
+
+        for (int tick = 1; tick <= c.ticks; ++tick)
+        {
+            run_tick(ref, c.pairs);
+            if (!ref.activity_consistent())
+            {
+                out.engine = "reference/activity";
+                out.repro = c;
+                out.repro.ticks = tick;
+                out.tick = tick;
+                out.detail = "incremental activity map differs from rebuild_activity()";
+                return false;
+            }
+
+            const uint64_t h = ref.hash();
+            for (DiffEngine *e : active)
+            {
+                run_tick(*e, c.pairs);
+                if (e->hash() != h)
+                {
+                    minimize(c, tick, ref, *e, out);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // ----------------- Golden Corpus -----------------
+    uint64_t hash_game_state(const GameState &gs)
+    {
+        uint64_t h = hash_cells([&](int x, int y) { return gs.grid.at(x, y); });
+        auto mix = [&](uint64_t v, int bytes)
+        {
+            for (int i = 0; i < bytes; ++i)
+            {
+                h ^= (v >> (8 * i)) & 0xFF;
+                h *= 0x100000001B3ull;
+            }
+        };
+        mix(gs.tick, 2);
+        mix(static_cast<uint64_t>(gs.phase), 1);
+        mix(gs.rng16, 2);
+        std::mt19937 sys = gs.system_rng; // next output stands in for the full state
+        mix(sys(), 4);
+        for (const auto &p : gs.players)
+        {
+            mix(static_cast<uint64_t>(p.current), 1);
+            mix(p.last_rot_tick, 2);
+            mix(p.rot_period, 1);
+            mix(p.tick_losses, 1);
+        }
+        return h;
+    }
+
+    static uint64_t play_golden(const GoldenEntry &e, bool batched, bool sliced, AiScheduler *ai)
+    {
+        GameState gs;
+        gs.players = {PlayerState{PlayerId{0}, Piece::Rock}, PlayerState{PlayerId{1}, Piece::Scissors}};
+        gs.players[1].ai = AiKind::Albert;
+        gs.players[1].albert = e.albert;
+        seed_game(gs, e.seed, e.lfsr);
+        gs.sparse_sampling = e.sparse;
+        gs.batched_pairs = batched;
+        gs.async_ai = ai;
+        load_level(gs, 1);
+        gs.phase = Phase::Playing;
+
+        Rng64 slices{e.seed};
+        size_t next = 0;
+        while (gs.phase == Phase::Playing && gs.tick < e.ticks)
+        {
+            for (; next < e.inputs.size() && e.inputs[next] <= gs.tick; ++next)
+            {
+                if (e.inputs[next] == gs.tick)
+                    rotate_player(gs, gs.players[0]);
+            }
+            if (!sliced)
+            {
+                step_fixed(gs);
+                continue;
+            }
+            // Uneven slices, some empty, as frames of varying length would give
+            begin_tick(gs);
+            while (gs.slice.done < gs.slice.total)
+                resolve_tick_slice(gs, static_cast<int>(Rng64::scale(slices.next(), 97)));
+            finish_tick(gs);
+        }
+        return hash_game_state(gs);
+    }
+
+    uint64_t run_golden(const GoldenEntry &e, bool batched, bool sliced)
+    {
+        return play_golden(e, batched, sliced, nullptr);
+    }
+
+    bool check_async_replay(const GoldenEntry &e, int latency, std::string &detail)
+    {
+        AsyncAiConfig cfg;
+        cfg.latency = latency;
+        cfg.timing = AiTiming::Live;
+        cfg.seed = e.seed;
+        AiScheduler live(cfg);
+        const uint64_t live_hash = play_golden(e, false, false, &live);
+
+        cfg.timing = AiTiming::Lockstep;
+        cfg.threads = 3;
+        AiScheduler replay(cfg);
+        replay.set_replay_misses(live.misses());
+        const uint64_t replay_hash = play_golden(e, false, true, &replay);
+
+        char buf[160];
+        std::snprintf(buf, sizeof(buf), "latency %d: live %016" PRIx64 " (%zu misses), replay %016" PRIx64, latency,
+                      live_hash, live.misses().size(), replay_hash);
+        detail = buf;
+        return live_hash == replay_hash && replay.misses() == live.misses();
+    }
+
+    std::string format_golden(const GoldenEntry &e)
+    {
+        std::string inputs;
+        for (size_t i = 0; i < e.inputs.size(); ++i)
+            inputs += (i ? "," : "") + std::to_string(e.inputs[i]);
+        char buf[256];
+        std::snprintf(buf, sizeof(buf), "seed=%" PRIu64 " rng=%s sampler=%s ticks=%d albert=%d:%d inputs=%s hash=%016" PRIx64,
+                      e.seed, e.lfsr ? "lfsr" : "sys", e.sparse ? "sparse" : "dense", e.ticks,
+                      e.albert.rotation_average, e.albert.rotation_half_interval,
+                      inputs.empty() ? "-" : inputs.c_str(), e.hash);
+        return buf;
+    }
+
+    bool parse_golden(const std::string &line, GoldenEntry &e, std::string &err)
+    {
+        e = GoldenEntry{};
+        std::istringstream in(line);
+        std::string tok;
+        int seen = 0;
+        while (in >> tok)
+        {
+            const size_t eq = tok.find('=');
+            if (eq == std::string::npos)
+            {
+                err = "expected key=value, got '" + tok + "'";
+                return false;
+            }
+            const std::string key = tok.substr(0, eq), val = tok.substr(eq + 1);
+            if (key == "seed")
+                e.seed = std::strtoull(val.c_str(), nullptr, 10);
+            else if (key == "rng" && (val == "sys" || val == "lfsr"))
+                e.lfsr = val == "lfsr";
+            else if (key == "sampler" && (val == "dense" || val == "sparse"))
+                e.sparse = val == "sparse";
+            else if (key == "ticks")
+                e.ticks = std::atoi(val.c_str());
+            else if (key == "albert")
+            {
+                if (std::sscanf(val.c_str(), "%d:%d", &e.albert.rotation_average, &e.albert.rotation_half_interval) != 2)
+                {
+                    err = "bad albert '" + val + "'";
+                    return false;
+                }
+            }
+            else if (key == "inputs")
+            {
+                if (val != "-")
+                {
+                    std::istringstream list(val);
+                    std::string t;
+                    while (std::getline(list, t, ','))
+                        e.inputs.push_back(std::atoi(t.c_str()));
+                }
+            }
+            else if (key == "hash")
+                e.hash = std::strtoull(val.c_str(), nullptr, 16);
+            else
+            {
+                err = "unknown field '" + tok + "'";
+                return false;
+            }
+            seen++;
+        }
+        if (seen != 7)
+        {
+            err = "expected 7 fields";
+            return false;
+        }
+        return true;
+    }
+
+    std::vector<GoldenEntry> default_golden_entries()
+    {
+        const AlbertConfig configs[] = {{58, 43}, {25, 10}, {120, 20}, {40, 39}};
+        std::vector<GoldenEntry> out;
+        for (int i = 0; i < 24; ++i)
+        {
+            GoldenEntry e;
+            e.seed = 1000 + i;
+            e.lfsr = i % 4 == 3;
+            e.sparse = i % 3 == 2;
+            e.ticks = 100 + 50 * (i % 5);
+            e.albert = configs[i % 4];
+
+            Rng64 rng{e.seed};
+            int t = 0;
+            for (int k = i % 6; k > 0; --k)
+            {
+                t += 1 + static_cast<int>(Rng64::scale(rng.next(), 40));
+                e.inputs.push_back(t);
+            }
+            out.push_back(e);
+        }
+        return out;
+    }
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/Game.h"
+#include "core/LargeGrid.h"
+
+// ----------------- Differential Testing -----------------
+// Runs the reference rules (resolve_pair + update_ai on a GameState) and
+// candidate engines in lockstep on the 40x24 board and compares cell hashes
+// after every tick. Every engine owns a copy of the starting GameState as
+// its "driver": the RNG, tick counter and AI state. The pair engines all use
+// split_pair_draw, so with equal drivers they see the same pairs and coins.
+namespace hl
+{
+    // Engine RNG backed by a game's rngu(): one game draw per 64-bit value,
+    // spread with splitmix64 but keeping bit 0, so a rule-5 coin drawn here
+    // matches the one resolve_pair draws from rngu().
+    struct GameRng
+    {
+        GameState *gs{nullptr};
+        uint64_t next();
+    };
+
+    // FNV-1a over the canonical form of every cell (pieces only for symbols)
+    template <typename At>
+    uint64_t hash_cells(At &&at)
+    {
+        uint64_t h = 0xCBF29CE484222325ull;
+        auto mix = [&](uint8_t b)
+        {
+            h ^= b;
+            h *= 0x100000001B3ull;
+        };
+        for (int y = 0; y < ARENA_H; ++y)
+        {
+            for (int x = 0; x < ARENA_W; ++x)
+            {
+                const Cell c = at(x, y);
+                mix(static_cast<uint8_t>(c.kind));
+                if (c.kind == CellKind::Symbol)
+                {
+                    mix(c.owner.v);
+                    mix(static_cast<uint8_t>(c.piece));
+                }
+            }
+        }
+        return h;
+    }
+
+    class DiffEngine
+    {
+    public:
+        explicit DiffEngine(std::string name) : name_(std::move(name)) {}
+        virtual ~DiffEngine() = default;
+
+        const std::string &name() const { return name_; }
+        // Largest owner id + 1 the engine can store
+        virtual int max_players() const { return 14; }
+
+        // Copies the board and takes gs as the driver
+        void load(const GameState &gs);
+        void begin_tick();
+        virtual void resolve(int count) = 0;
+        // Runs the AIs on the driver and mirrors rotations into the board
+        void end_tick();
+
+        virtual Cell at(int x, int y) const = 0;
+        uint64_t hash() const
+        {
+            return hash_cells([this](int x, int y) { return at(x, y); });
+        }
+
+        GameState driver;
+
+    protected:
+        virtual void load_cells() = 0;
+        virtual void sync_pieces() = 0;
+        std::vector<uint32_t> losses_;
+
+    private:
+        std::string name_;
+    };
+
+    // Candidates: large/{row-major,tiled,morton}, packed4/{row-major,tiled},
+    // packed2/row-major, and the pipelined large-pf/{row-major,morton} and
+    // packed4-pf/row-major. With inject_bug, adds "buggy/stale-pieces", a
+    // packed engine that mirrors rotations one tick late (a self-check).
+    std::vector<std::unique_ptr<DiffEngine>> make_candidate_engines(bool inject_bug);
+
+    // One randomized case: a random board and AI tuning derived from seed
+    struct DiffCase
+    {
+        uint64_t seed{1};
+        int players{2};
+        int ticks{100};
+        int pairs{240};
+    };
+
+    GameState make_case_state(const DiffCase &c);
+
+    struct Divergence
+    {
+        std::string engine;
+        DiffCase repro;  // shrunk case that still fails
+        int tick{0};     // first tick whose hash differs (1-based)
+        int pair{-1};    // first pair within that tick, -1 = during the AI step
+        std::string detail;
+    };
+
+    // Runs c through the reference and every candidate that can hold its
+    // players. Returns false and fills out (minimized) on the first divergence.
+    // The reference also checks its incremental activity map against
+    // rebuild_activity() every tick ("reference/activity"), and the batched
+    // resolve_pairs is checked against the sequential one ("batched").
+    bool run_diff_case(const DiffCase &c, const std::vector<std::unique_ptr<DiffEngine>> &candidates,
+                       Divergence &out);
+
+    // ----------------- Golden Corpus -----------------
+    // A level-1 game against Albert played with step_fixed, with player 0's
+    // rotations scripted, and the hash of the final game state.
+    struct GoldenEntry
+    {
+        uint64_t seed{1};
+        bool lfsr{false};
+        bool sparse{false};
+        int ticks{300};
+        AlbertConfig albert{};
+        std::vector<int> inputs; // player 0 rotates after these ticks
+        uint64_t hash{0};
+    };
+
+    // Hash of the grid, tick, phase, both RNG states and the players
+    uint64_t hash_game_state(const GameState &gs);
+
+    // With batched, dense ticks go through the batched sampler, and with
+    // sliced every tick is resolved in uneven resolve_tick_slice() calls;
+    // both must give the same hash
+    uint64_t run_golden(const GoldenEntry &e, bool batched = false, bool sliced = false);
+
+    // Plays e with asynchronous AIs (AiScheduler) in Live timing, then
+    // replays it in Lockstep timing with the live miss log, on more worker
+    // threads and with sliced ticks. False if the replay differs.
+    bool check_async_replay(const GoldenEntry &e, int latency, std::string &detail);
+
+    // One line per entry:
+    //   seed=7 rng=sys sampler=dense ticks=300 albert=58:43 inputs=10,25 hash=0123456789abcdef
+    std::string format_golden(const GoldenEntry &e);
+    bool parse_golden(const std::string &line, GoldenEntry &e, std::string &err);
+
+    // The entries data/golden.txt was generated from (hashes left at 0)
+    std::vector<GoldenEntry> default_golden_entries();
+}
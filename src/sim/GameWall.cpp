@@ -0,0 +1,190 @@
+#include "sim/GameWall.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include "sim/Tournament.h"
+
+namespace hl
+{
+    namespace
+    {
+        // RGBA32 as the bytes R, G, B, A on little-endian hosts
+        constexpr uint32_t rgba(uint32_t r, uint32_t g, uint32_t b)
+        {
+            return 0xFF000000u | (b << 16) | (g << 8) | r;
+        }
+
+        // The arena view's palette; pieces shade the owner's colour, so
+        // rotations show on the thumbnails
+        const uint32_t OWNER_COLORS[4][3] = {
+            {rgba(56, 140, 84), rgba(68, 170, 102), rgba(80, 200, 120)},
+            {rgba(154, 56, 56), rgba(187, 68, 68), rgba(220, 80, 80)},
+            {rgba(56, 84, 154), rgba(68, 102, 187), rgba(80, 120, 220)},
+            {rgba(154, 140, 56), rgba(187, 170, 68), rgba(220, 200, 80)},
+        };
+        constexpr uint32_t WALL_COLOR = rgba(80, 80, 80);
+        constexpr uint32_t EMPTY_COLOR = rgba(25, 25, 28);
+        constexpr uint32_t GUTTER_COLOR = rgba(12, 12, 14);
+    }
+
+    std::vector<WallMatchup> tournament_matchups()
+    {
+        const std::vector<Entrant> roster = default_entrants();
+        std::vector<WallMatchup> out;
+        for (size_t a = 0; a < roster.size(); ++a)
+        {
+            for (size_t b = a + 1; b < roster.size(); ++b)
+            {
+                WallMatchup m;
+                m.label = roster[a].name + " vs " + roster[b].name;
+                m.spec.left = roster[a].side;
+                m.spec.right = roster[b].side;
+                out.push_back(m);
+            }
+        }
+        return out;
+    }
+
+    std::vector<WallMatchup> sweep_matchups()
+    {
+        std::vector<WallMatchup> out;
+        for (int avg = 20; avg <= 140; avg += 20)
+        {
+            WallMatchup m;
+            m.spec.left.albert = AlbertConfig{avg, avg / 2};
+            m.label = "albert " + std::to_string(avg) + ":" + std::to_string(avg / 2) + " vs albert 58:43";
+            out.push_back(m);
+        }
+        return out;
+    }
+
+    void GameWall::start(std::vector<WallMatchup> matchups, int games, uint64_t seed)
+    {
+        matchups_ = std::move(matchups);
+        seed_ = seed;
+        games = matchups_.empty() ? 0 : std::clamp(games, MIN_GAMES, MAX_GAMES);
+        slots_.assign(games, Slot{});
+        columns_ = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(games))));
+        rows_ = columns_ > 0 ? (games + columns_ - 1) / columns_ : 0;
+        atlas_.assign(static_cast<size_t>(atlas_width()) * atlas_height(), GUTTER_COLOR);
+        for (int i = 0; i < games; ++i)
+        {
+            slots_[i].matchup = i % static_cast<int>(matchups_.size());
+            restart(i);
+        }
+    }
+
+    void GameWall::restart(int i)
+    {
+        Slot &s = slots_[i];
+        MatchSpec spec = matchups_[s.matchup].spec;
+        // Independent of how the steps were spread over workers
+        spec.seed = seed_ * 0x9E3779B97F4A7C15ull + static_cast<uint64_t>(s.played) * MAX_GAMES + i;
+        s.gs = GameState{};
+        start_match(s.gs, spec);
+    }
+
+    void GameWall::step_slot(int i, int ticks)
+    {
+        Slot &s = slots_[i];
+        const int max_ticks = matchups_[s.matchup].spec.max_ticks;
+        for (int t = 0; t < ticks; ++t)
+        {
+            if (s.gs.phase != Phase::Playing || s.gs.tick >= max_ticks)
+            {
+                s.result[s.gs.phase == Phase::Won ? 0 : s.gs.phase == Phase::Lost ? 1 : 2]++;
+                s.played++;
+                restart(i);
+            }
+            step_fixed(s.gs);
+        }
+    }
+
+    void GameWall::step(int ticks, int threads)
+    {
+        if (ticks <= 0)
+            return;
+        parallel_for(games(), threads, [&](int i) { step_slot(i, ticks); });
+    }
+
+    void GameWall::step(int ticks, JobScheduler &pool)
+    {
+        if (ticks <= 0 || games() == 0)
+            return;
+        std::mutex m;
+        std::condition_variable cv;
+        bool finished = false;
+        auto job = std::make_shared<SimJob>();
+        job->kind = "wall";
+        job->tasks = games();
+        job->run = [this, ticks](int i) { step_slot(i, ticks); };
+        job->finish = [&](bool)
+        {
+            std::lock_guard<std::mutex> lock(m);
+            finished = true;
+            cv.notify_all();
+        };
+        if (!pool.submit(job))
+        {
+            for (int i = 0; i < games(); ++i)
+                step_slot(i, ticks);
+            return;
+        }
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&] { return finished; });
+    }
+
+    bool GameWall::paint()
+    {
+        bool changed = false;
+        const int stride = atlas_width();
+        for (int i = 0; i < games(); ++i)
+        {
+            Slot &s = slots_[i];
+            const uint32_t key = (static_cast<uint32_t>(s.played) << 16) | s.gs.tick;
+            if (key == s.painted)
+                continue;
+            s.painted = key;
+            changed = true;
+            uint32_t *dst = &atlas_[static_cast<size_t>(i / columns_) * THUMB_H * stride + (i % columns_) * THUMB_W];
+            for (int y = 0; y < ARENA_H; ++y, dst += stride)
+            {
+                for (int x = 0; x < ARENA_W; ++x)
+                {
+                    const Cell &c = s.gs.grid.at(x, y);
+                    uint32_t col = EMPTY_COLOR;
+                    if (c.kind == CellKind::Wall)
+                        col = WALL_COLOR;
+                    else if (c.kind == CellKind::Symbol)
+                        col = OWNER_COLORS[c.owner.v % 4][static_cast<int>(c.piece) % 3];
+                    dst[x] = col;
+                }
+            }
+        }
+        return changed;
+    }
+
+    int GameWall::game_at(int x, int y) const
+    {
+        if (x < 0 || y < 0 || x >= atlas_width() || y >= atlas_height())
+            return -1;
+        const int i = (y / THUMB_H) * columns_ + x / THUMB_W;
+        return i < games() ? i : -1;
+    }
+
+    void GameWall::tally(int matchup, int out[3]) const
+    {
+        out[0] = out[1] = out[2] = 0;
+        for (const Slot &s : slots_)
+        {
+            if (s.matchup != matchup)
+                continue;
+            for (int k = 0; k < 3; ++k)
+                out[k] += s.result[k];
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/Game.h"
+#include "sim/Batch.h"
+#include "sim/JobScheduler.h"
+
+// ----------------- Game Wall -----------------
+// Many headless games stepped side by side, for watching a sweep or a
+// tournament at a glance. Every game is a thumbnail of one pixel per cell
+// in a single RGBA atlas, so a view uploads one texture and draws all the
+// games as one textured quad, whatever their number.
+namespace hl
+{
+    struct WallMatchup
+    {
+        std::string label; // "albert-fast vs idle"
+        MatchSpec spec{};  // seed is replaced per game
+    };
+
+    // Every pairing of the default tournament roster, on level 1
+    std::vector<WallMatchup> tournament_matchups();
+
+    // Albert 20:10 ... 140:70 against the default Albert, on level 1
+    std::vector<WallMatchup> sweep_matchups();
+
+    class GameWall
+    {
+    public:
+        static constexpr int MIN_GAMES = 16;
+        static constexpr int MAX_GAMES = 256;
+        static constexpr int THUMB_W = ARENA_W + 1; // one pixel of gutter right and below
+        static constexpr int THUMB_H = ARENA_H + 1;
+
+        // Game i plays matchups[i % size]; finished games restart on a fresh seed
+        void start(std::vector<WallMatchup> matchups, int games, uint64_t seed);
+
+        // Advances every game by `ticks` on up to `threads` workers (0 = all cores)
+        void step(int ticks, int threads);
+        // The same on a long-lived pool, for callers that step every frame;
+        // returns once every game has moved
+        void step(int ticks, JobScheduler &pool);
+
+        // Repaints the thumbnails of games that moved since the last call;
+        // false if none did, so the texture need not be uploaded again
+        bool paint();
+
+        // RGBA bytes in memory (SDL_PIXELFORMAT_RGBA32), atlas_width() per row
+        const std::vector<uint32_t> &atlas() const { return atlas_; }
+        int atlas_width() const { return columns_ * THUMB_W; }
+        int atlas_height() const { return rows_ * THUMB_H; }
+
+        // Game under atlas pixel (x, y), or -1 for none
+        int game_at(int x, int y) const;
+
+        int games() const { return static_cast<int>(slots_.size()); }
+        const GameState &game(int i) const { return slots_[i].gs; }
+        const WallMatchup &matchup(int i) const { return matchups_[slots_[i].matchup]; }
+        int played(int i) const { return slots_[i].played; } // games finished in slot i
+        // Per matchup, over all its slots: left wins, right wins, timeouts
+        void tally(int matchup, int out[3]) const;
+        int matchups() const { return static_cast<int>(matchups_.size()); }
+
+    private:
+        struct Slot
+        {
+            GameState gs;
+            int matchup{0};
+            int played{0};
+            uint32_t painted{~0u}; // (played << 16) | tick when last painted
+            int result[3]{}; // left wins, right wins, timeouts
+        };
+
+        void restart(int i);
+        void step_slot(int i, int ticks);
+
+        std::vector<WallMatchup> matchups_;
+        std::vector<Slot> slots_;
+        std::vector<uint32_t> atlas_;
+        int columns_{0}, rows_{0};
+        uint64_t seed_{1};
+    };
+}
@@ -0,0 +1,202 @@
+#include "sim/JobScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "util/Metrics.h"
+
+namespace hl
+{
+    JobScheduler::JobScheduler(int threads)
+    {
+        for (int i = 0; i < std::max(1, threads); ++i)
+            workers_.emplace_back([this, i] { worker(i); });
+    }
+
+    JobScheduler::~JobScheduler() { shutdown(); }
+
+    int JobScheduler::submit(std::shared_ptr<SimJob> job)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stop_)
+            return 0;
+        Entry e;
+        e.id = next_id_++;
+        e.job = std::move(job);
+        e.job->id = e.id;
+        // Start a newcomer level with the least-served job of its priority,
+        // otherwise it would get the whole pool until it caught up
+        bool peer = false;
+        double least = 0.0;
+        for (const auto &o : jobs_)
+        {
+            if (o.job->priority != e.job->priority)
+                continue;
+            const double share = o.service / o.job->weight;
+            least = peer ? std::min(least, share) : share;
+            peer = true;
+        }
+        e.service = least * e.job->weight;
+        const int id = e.id;
+        jobs_.push_back(std::move(e));
+        // A job without tasks is retired by the next worker to look
+        cv_.notify_all();
+        return id;
+    }
+
+    bool JobScheduler::cancel(int id)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &e : jobs_)
+        {
+            if (e.id == id)
+            {
+                e.job->cancelled = true;
+                cv_.notify_all();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<JobStatus> JobScheduler::status() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<JobStatus> out;
+        for (const auto &e : jobs_)
+        {
+            JobStatus s;
+            s.id = e.id;
+            s.kind = e.job->kind;
+            s.priority = e.job->priority;
+            s.tasks = e.job->tasks;
+            s.done = e.done;
+            s.running = e.running;
+            s.cpu_seconds = e.service;
+            s.cancelled = e.job->cancelled;
+            out.push_back(s);
+        }
+        return out;
+    }
+
+    int JobScheduler::active() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return static_cast<int>(jobs_.size());
+    }
+
+    int JobScheduler::queued() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int n = 0;
+        for (const auto &e : jobs_)
+        {
+            if (!e.job->cancelled)
+                n += e.job->tasks - e.next;
+        }
+        return n;
+    }
+
+    void JobScheduler::shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (workers_.empty())
+                return;
+            for (auto &e : jobs_)
+                e.job->cancelled = true;
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto &t : workers_)
+            t.join();
+        workers_.clear();
+    }
+
+    JobScheduler::Entry *JobScheduler::pick()
+    {
+        Entry *best = nullptr;
+        for (auto &e : jobs_)
+        {
+            if (e.job->cancelled || e.next >= e.job->tasks)
+                continue;
+            if (!best || e.job->priority > best->job->priority)
+            {
+                best = &e;
+                continue;
+            }
+            // Ties on priority go to the least service per weight, then FIFO
+            // (jobs_ is in submission order, so keeping best keeps the older)
+            if (e.job->priority == best->job->priority &&
+                e.service / e.job->weight < best->service / best->job->weight)
+                best = &e;
+        }
+        return best;
+    }
+
+    void JobScheduler::retire(size_t index, std::unique_lock<std::mutex> &lock)
+    {
+        std::shared_ptr<SimJob> job = std::move(jobs_[index].job);
+        jobs_.erase(jobs_.begin() + static_cast<std::ptrdiff_t>(index));
+        const bool cancelled = job->cancelled;
+        lock.unlock();
+        if (job->finish)
+            job->finish(cancelled);
+        lock.lock();
+    }
+
+    void JobScheduler::worker(int index)
+    {
+        using clock = std::chrono::steady_clock;
+        Metrics::instance().set_worker("sched/" + std::to_string(index));
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;)
+        {
+            // Retire jobs with nothing left to run or wait for
+            for (size_t i = 0; i < jobs_.size();)
+            {
+                const Entry &e = jobs_[i];
+                if (e.running == 0 && (e.job->cancelled || e.next >= e.job->tasks))
+                {
+                    retire(i, lock);
+                    i = 0;
+                    continue;
+                }
+                ++i;
+            }
+
+            Entry *e = pick();
+            if (!e)
+            {
+                if (stop_ && jobs_.empty())
+                    return;
+                cv_.wait(lock);
+                continue;
+            }
+
+            const int id = e->id;
+            const int task = e->next++;
+            e->running++;
+            std::shared_ptr<SimJob> job = e->job;
+            lock.unlock();
+            const auto t0 = clock::now();
+            job->run(task);
+            const double dt = std::chrono::duration<double>(clock::now() - t0).count();
+            Metrics::instance().task(dt);
+            lock.lock();
+
+            // The entry may have moved while unlocked
+            for (auto &o : jobs_)
+            {
+                if (o.id == id)
+                {
+                    o.running--;
+                    o.done++;
+                    o.service += dt;
+                    break;
+                }
+            }
+            cv_.notify_all();
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ----------------- Job Scheduler -----------------
+namespace hl
+{
+    // A job is a fixed number of independent tasks. run(i) is called once
+    // per task, concurrently on the scheduler's workers; finish() once, after
+    // the last task has returned or the job was cancelled.
+    struct SimJob
+    {
+        std::string kind;
+        int priority{0};     // higher runs first
+        double weight{1.0};  // share of the workers among jobs of equal priority
+        int tasks{0};
+        std::function<void(int task)> run;
+        std::function<void(bool cancelled)> finish;
+        std::atomic<bool> cancelled{false}; // long tasks may poll this
+        int id{0}; // set by submit before any task runs
+    };
+
+    struct JobStatus
+    {
+        int id{0};
+        std::string kind;
+        int priority{0};
+        int tasks{0}, done{0}, running{0};
+        double cpu_seconds{0.0};
+        bool cancelled{false};
+    };
+
+    // Worker pool for many jobs at once. Workers take the next task from the
+    // highest-priority jobs, and among those from the one that has had the
+    // least worker time per unit weight, so equal jobs share the pool evenly
+    // and a new job does not wait behind a long one. Cancelling drops a job's
+    // queued tasks; running tasks finish (or poll SimJob::cancelled). Workers
+    // report to the metrics as "sched/0", "sched/1", ...
+    class JobScheduler
+    {
+    public:
+        explicit JobScheduler(int threads);
+        ~JobScheduler();
+        JobScheduler(const JobScheduler &) = delete;
+        JobScheduler &operator=(const JobScheduler &) = delete;
+
+        int threads() const { return static_cast<int>(workers_.size()); }
+
+        // Returns the job id, or 0 once shut down
+        int submit(std::shared_ptr<SimJob> job);
+        bool cancel(int id);
+        std::vector<JobStatus> status() const;
+        // Jobs queued or running
+        int active() const;
+        // Tasks not yet started
+        int queued() const;
+
+        // Cancels everything, waits for running tasks and stops the workers
+        void shutdown();
+
+    private:
+        struct Entry
+        {
+            int id{0};
+            std::shared_ptr<SimJob> job;
+            int next{0};
+            int running{0};
+            int done{0};
+            double service{0.0}; // worker seconds spent on the job
+        };
+
+        void worker(int index);
+        Entry *pick();
+        void retire(size_t index, std::unique_lock<std::mutex> &lock);
+
+        mutable std::mutex mutex_;
+        std::condition_variable cv_;
+        std::vector<Entry> jobs_;
+        std::vector<std::thread> workers_;
+        int next_id_{1};
+        bool stop_{false};
+    };
+}
@@ -0,0 +1,364 @@
+#include "sim/MarkovSolver.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <numeric>
+
+#include "core/Rules.h"
+#include "sim/Batch.h"
+#include "sim/Stats.h"
+#include "util/Rng.h"
+
+namespace hl
+{
+    namespace
+    {
+        int popcount(uint32_t v) { return static_cast<int>(std::bitset<32>(v).count()); }
+
+        uint32_t permute(uint32_t mask, const std::vector<int> &perm)
+        {
+            uint32_t out = 0;
+            for (size_t c = 0; c < perm.size(); ++c)
+                out |= ((mask >> c) & 1u) << perm[c];
+            return out;
+        }
+
+        // Rotations of player i at the ends of ticks 1..t
+        int rotations(const TinyArenaSpec &s, int i, long long t)
+        {
+            return static_cast<int>((t + s.offset[i]) / s.period[i] - s.offset[i] / s.period[i]);
+        }
+    }
+
+    bool TinyArenaChain::build(const TinyArenaSpec &spec, std::string &err)
+    {
+        const int w = spec.width, h = spec.height;
+        if (w < 1 || h < 1 || w * h > MAX_CELLS || w * h < 2)
+        {
+            err = "interior must have 2.." + std::to_string(MAX_CELLS) + " cells";
+            return false;
+        }
+        for (int i = 0; i < 2; ++i)
+        {
+            if (spec.period[i] < 1 || spec.offset[i] < 0 || spec.offset[i] >= spec.period[i])
+            {
+                err = "schedule needs period >= 1 and 0 <= offset < period";
+                return false;
+            }
+        }
+        spec_ = spec;
+        n_ = w * h;
+        full_ = n_ == 32 ? ~0u : (1u << n_) - 1;
+        const int arena = (w + 2) * (h + 2);
+        pairs_ = spec.pairs_per_tick > 0 ? spec.pairs_per_tick : std::max(1, static_cast<int>(std::lround(0.25 * arena)));
+        hit_ = 1.0 / (2.0 * arena);
+
+        neighbors_.assign(n_, 0);
+        start_ = 0;
+        for (int y = 0; y < h; ++y)
+        {
+            for (int x = 0; x < w; ++x)
+            {
+                const int c = y * w + x;
+                if (x > 0)
+                    neighbors_[c] |= 1u << (c - 1);
+                if (x + 1 < w)
+                    neighbors_[c] |= 1u << (c + 1);
+                if (y > 0)
+                    neighbors_[c] |= 1u << (c - w);
+                if (y + 1 < h)
+                    neighbors_[c] |= 1u << (c + w);
+                if (x < w / 2)
+                    start_ |= 1u << c;
+            }
+        }
+
+        // The board's symmetries; the rules and draws do not care about position
+        perm_.clear();
+        auto add = [&](auto map)
+        {
+            std::vector<int> p(n_);
+            for (int y = 0; y < h; ++y)
+                for (int x = 0; x < w; ++x)
+                {
+                    const auto [tx, ty] = map(x, y);
+                    p[y * w + x] = ty * w + tx;
+                }
+            perm_.push_back(p);
+        };
+        add([&](int x, int y) { return std::pair<int, int>{x, y}; });
+        add([&](int x, int y) { return std::pair<int, int>{w - 1 - x, y}; });
+        add([&](int x, int y) { return std::pair<int, int>{x, h - 1 - y}; });
+        add([&](int x, int y) { return std::pair<int, int>{w - 1 - x, h - 1 - y}; });
+        if (w == h)
+        {
+            add([&](int x, int y) { return std::pair<int, int>{y, x}; });
+            add([&](int x, int y) { return std::pair<int, int>{w - 1 - y, x}; });
+            add([&](int x, int y) { return std::pair<int, int>{y, w - 1 - x}; });
+            add([&](int x, int y) { return std::pair<int, int>{w - 1 - y, w - 1 - x}; });
+        }
+
+        // Reachable states from the split, breadth first over single flips of
+        // frontier cells; every mask in a state's orbit maps to it
+        index_.assign(size_t(1) << n_, -1);
+        rep_.clear();
+        auto visit = [&](uint32_t mask)
+        {
+            if (index_[mask] >= 0)
+                return;
+            const int32_t id = static_cast<int32_t>(rep_.size());
+            uint32_t canon = mask;
+            for (const auto &p : perm_)
+            {
+                const uint32_t m = permute(mask, p);
+                index_[m] = id;
+                canon = std::min(canon, m);
+            }
+            rep_.push_back(canon);
+        };
+        visit(start_);
+        for (size_t next = 0; next < rep_.size(); ++next)
+        {
+            const uint32_t m = rep_[next];
+            for (int c = 0; c < n_; ++c)
+            {
+                const bool mine = (m >> c) & 1u;
+                if (neighbors_[c] & (mine ? ~m : m))
+                    visit(m ^ (1u << c));
+            }
+        }
+
+        // Flip lists, so sweeps only walk arrays
+        first_.assign(rep_.size() + 1, 0);
+        to0_count_.assign(rep_.size(), 0);
+        live_.assign(rep_.size(), 0);
+        flips_.clear();
+        for (size_t s = 0; s < rep_.size(); ++s)
+        {
+            const uint32_t m = rep_[s];
+            first_[s] = static_cast<uint32_t>(flips_.size());
+            int ends = 0;
+            for (int side = 0; side < 2; ++side)
+            {
+                for (int c = 0; c < n_; ++c)
+                {
+                    const bool mine = (m >> c) & 1u;
+                    if (mine != (side == 1))
+                        continue; // towards player 0 flips player 1's cells first
+                    const int live = popcount(neighbors_[c] & (mine ? ~m : m));
+                    if (!live)
+                        continue;
+                    ends += live;
+                    flips_.push_back(static_cast<uint32_t>(index_[m ^ (1u << c)]) << 3 | static_cast<uint32_t>(live));
+                    if (side == 0)
+                        to0_count_[s]++;
+                }
+            }
+            live_[s] = static_cast<uint8_t>(ends / 2);
+        }
+        first_[rep_.size()] = static_cast<uint32_t>(flips_.size());
+
+        // Piece relation per tick; level 1 starts Rock (0) against Scissors (2)
+        const long long lcm = std::lcm(static_cast<long long>(spec.period[0]), static_cast<long long>(spec.period[1]));
+        long long len = lcm;
+        while ((len / spec.period[0] - len / spec.period[1]) % 3 != 0)
+            len += lcm;
+        relation_.resize(static_cast<size_t>(len));
+        for (long long t = 1; t <= len; ++t)
+        {
+            const int d = (1 + rotations(spec, 0, t - 1) - rotations(spec, 1, t - 1)) % 3;
+            relation_[t - 1] = static_cast<uint8_t>((d + 3) % 3);
+        }
+
+        win_.assign(rep_.size(), 0.5);
+        ticks_.assign(rep_.size(), 0.0);
+        for (size_t s = 0; s < rep_.size(); ++s)
+        {
+            if (rep_[s] == 0 || rep_[s] == full_)
+                win_[s] = rep_[s] == full_ ? 1.0 : 0.0;
+        }
+        sweeps_ = 0;
+        residual_ = 0.0;
+        return true;
+    }
+
+    // One pair draw: out = P * in for the given relation. Absorbed states have
+    // no live edges, so they keep their value.
+    void TinyArenaChain::apply(int relation, const std::vector<double> *in, std::vector<double> *out,
+                               int threads) const
+    {
+        const int n_states = static_cast<int>(rep_.size());
+        // Weight of a flip towards player 0 / player 1, per live edge of the flipped cell
+        const double to0 = relation == 1 ? 1.0 : relation == 2 ? 0.0 : 0.5;
+        const double to1 = 1.0 - to0;
+
+        auto range = [&](int begin, int end)
+        {
+            for (int s = begin; s < end; ++s)
+            {
+                const uint32_t *f = flips_.data() + first_[s];
+                const uint32_t *mid = f + to0_count_[s];
+                const uint32_t *last = flips_.data() + first_[s + 1];
+                const double stay = 1.0 - hit_ * live_[s];
+                const double *x = in[0].data(), *y = in[1].data();
+                double x0 = 0.0, y0 = 0.0, x1 = 0.0, y1 = 0.0;
+                for (const uint32_t *e = f; e < mid; ++e)
+                {
+                    x0 += (*e & 7) * x[*e >> 3];
+                    y0 += (*e & 7) * y[*e >> 3];
+                }
+                for (const uint32_t *e = mid; e < last; ++e)
+                {
+                    x1 += (*e & 7) * x[*e >> 3];
+                    y1 += (*e & 7) * y[*e >> 3];
+                }
+                out[0][s] = stay * x[s] + hit_ * (to0 * x0 + to1 * x1);
+                out[1][s] = stay * y[s] + hit_ * (to0 * y0 + to1 * y1);
+            }
+        };
+
+        constexpr int CHUNK = 1 << 14;
+        if (threads == 1 || n_states < 2 * CHUNK)
+        {
+            range(0, n_states);
+            return;
+        }
+        const int chunks = (n_states + CHUNK - 1) / CHUNK;
+        parallel_for(chunks, threads, [&](int i) { range(i * CHUNK, std::min(n_states, (i + 1) * CHUNK)); });
+    }
+
+    bool TinyArenaChain::solve(double tol, int max_sweeps, int threads)
+    {
+        const size_t n_states = rep_.size();
+        std::vector<double> cur[2] = {win_, ticks_}, tmp[2] = {std::vector<double>(n_states), std::vector<double>(n_states)};
+        std::vector<double> &win = cur[0], &ticks = cur[1];
+        for (sweeps_ = 0; sweeps_ < max_sweeps;)
+        {
+            // Backwards through one period, from the values at its end
+            for (int phase = phases() - 1; phase >= 0; --phase)
+            {
+                for (int k = 0; k < pairs_; ++k)
+                {
+                    apply(relation_[phase], cur, tmp, threads);
+                    cur[0].swap(tmp[0]);
+                    cur[1].swap(tmp[1]);
+                }
+                for (size_t s = 0; s < n_states; ++s)
+                {
+                    if (rep_[s] != 0 && rep_[s] != full_)
+                        ticks[s] += 1.0;
+                }
+            }
+            sweeps_++;
+
+            residual_ = 0.0;
+            for (size_t s = 0; s < n_states; ++s)
+            {
+                residual_ = std::max(residual_, std::abs(win[s] - win_[s]));
+                residual_ = std::max(residual_, std::abs(ticks[s] - ticks_[s]) / std::max(1.0, ticks[s]));
+            }
+            win_ = win;
+            ticks_ = ticks;
+            if (residual_ < tol)
+                return true;
+        }
+        return false;
+    }
+
+    double TinyArenaChain::win_probability(uint32_t mask) const
+    {
+        const int32_t s = mask <= full_ ? index_[mask] : -1;
+        return s >= 0 ? win_[s] : -1.0;
+    }
+
+    double TinyArenaChain::expected_ticks(uint32_t mask) const
+    {
+        const int32_t s = mask <= full_ ? index_[mask] : -1;
+        return s >= 0 ? ticks_[s] : -1.0;
+    }
+
+    TinyArenaSample sample_tiny_arena(const TinyArenaSpec &spec, int games, uint64_t seed, int max_ticks,
+                                      int threads)
+    {
+        const int aw = spec.width + 2, ah = spec.height + 2;
+        const int pairs = spec.pairs_per_tick > 0 ? spec.pairs_per_tick
+                                                  : std::max(1, static_cast<int>(std::lround(0.25 * aw * ah)));
+        std::vector<double> win(games), ticks(games);
+        std::vector<uint8_t> timed_out(games, 0);
+
+        parallel_for(games, threads, [&](int g)
+                     {
+                         // Streams start at scattered points of the sequence, not one step apart
+                         Rng64 rng{Rng64{seed}.next() ^ Rng64{static_cast<uint64_t>(g) * 0xD1B54A32D192ED03ull}.next()};
+                         Piece piece[2] = {Piece::Rock, Piece::Scissors};
+                         std::vector<Cell> cells(static_cast<size_t>(aw) * ah);
+                         int count[2] = {0, 0};
+                         for (int y = 0; y < ah; ++y)
+                         {
+                             for (int x = 0; x < aw; ++x)
+                             {
+                                 Cell &c = cells[y * aw + x];
+                                 if (x == 0 || y == 0 || x == aw - 1 || y == ah - 1)
+                                 {
+                                     c.kind = CellKind::Wall;
+                                     continue;
+                                 }
+                                 const int owner = x - 1 < spec.width / 2 ? 0 : 1;
+                                 c.kind = CellKind::Symbol;
+                                 c.owner = PlayerId{static_cast<uint8_t>(owner)};
+                                 c.piece = piece[owner];
+                                 count[owner]++;
+                             }
+                         }
+
+                         int tick = 0;
+                         while (count[0] > 0 && count[1] > 0 && tick < max_ticks)
+                         {
+                             tick++;
+                             for (int k = 0; k < pairs; ++k)
+                             {
+                                 // x and y from the two halves of one value, the direction from another
+                                 const uint64_t r = rng.next();
+                                 const int x = static_cast<int>(Rng64::scale(r, static_cast<uint32_t>(aw)));
+                                 const int y = static_cast<int>(Rng64::scale(r << 32, static_cast<uint32_t>(ah)));
+                                 const uint64_t dir = rng.next() >> 62;
+                                 static const int DX[4] = {0, 1, 0, -1}, DY[4] = {-1, 0, 1, 0};
+                                 const int nx = x + DX[dir], ny = y + DY[dir];
+                                 if (nx < 0 || ny < 0 || nx >= aw || ny >= ah)
+                                     continue;
+                                 resolve_cells(
+                                     cells[y * aw + x], cells[ny * aw + nx],
+                                     [&]() { return static_cast<uint16_t>(rng.next() >> 48); },
+                                     [&](PlayerId loser)
+                                     {
+                                         count[loser.v]--;
+                                         count[1 - loser.v]++;
+                                     });
+                             }
+                             for (int i = 0; i < 2; ++i)
+                             {
+                                 if ((tick + spec.offset[i]) % spec.period[i] != 0)
+                                     continue;
+                                 piece[i] = static_cast<Piece>((static_cast<int>(piece[i]) + 1) % 3);
+                                 for (Cell &c : cells)
+                                 {
+                                     if (c.kind == CellKind::Symbol && c.owner.v == i)
+                                         c.piece = piece[i];
+                                 }
+                             }
+                         }
+                         win[g] = count[1] == 0 ? 1.0 : 0.0;
+                         ticks[g] = tick;
+                         timed_out[g] = count[0] > 0 && count[1] > 0; });
+
+        TinyArenaSample out;
+        out.win = mean_of(win);
+        out.win_ci = games > 1 ? Z95 * std::sqrt(var_of(win) / games) : 0.0;
+        out.ticks = mean_of(ticks);
+        out.ticks_ci = games > 1 ? Z95 * std::sqrt(var_of(ticks) / games) : 0.0;
+        for (uint8_t t : timed_out)
+            out.timeouts += t;
+        return out;
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ----------------- Tiny-Arena Markov Chain -----------------
+// Exact answers for a two-player game on a W x H interior inside a wall
+// ring, as a ground truth for the statistical checks of sampled engines.
+//
+// A state is the owner of every interior cell (bit set = player 0). Each
+// pair draw is uniform over the arena's cells (walls included) and four
+// directions, like the dense sampler, so a draw hits each live edge with
+// probability 1 / (2 * arena cells) and the edge's loser under the current
+// pieces (rules 5 and 6 of resolve_cells) changes owner. Both players
+// rotate on a fixed schedule, so the pieces repeat with some period of
+// ticks; absorption probabilities and expected game lengths are the fixed
+// point of one period's operator, found by sweeping it until it settles.
+// States equal under the board's symmetries (mirrors, and rotations on
+// square boards) are solved once.
+namespace hl
+{
+    struct TinyArenaSpec
+    {
+        int width{4};        // interior cells; the arena adds a wall ring
+        int height{4};
+        int pairs_per_tick{0}; // 0: 0.25 per arena cell, the dense rate of level 1
+        int period[2]{3, 4}; // player i rotates after every period[i] ticks...
+        int offset[2]{0, 0}; // ...starting with tick period[i] - offset[i]
+    };
+
+    class TinyArenaChain
+    {
+    public:
+        static constexpr int MAX_CELLS = 24;
+
+        bool build(const TinyArenaSpec &spec, std::string &err);
+
+        // Sweeps until the largest change is below tol; false if max_sweeps ran out
+        bool solve(double tol, int max_sweeps, int threads);
+
+        // For a position at the start of the schedule (tick 1)
+        double win_probability(uint32_t mask) const; // player 0 wins
+        double expected_ticks(uint32_t mask) const;
+
+        uint32_t start_mask() const { return start_; } // level 1's split: left half player 0
+        int cells() const { return n_; }
+        size_t states() const { return rep_.size(); }
+        int symmetries() const { return static_cast<int>(perm_.size()); }
+        int phases() const { return static_cast<int>(relation_.size()); }
+        int pairs_per_tick() const { return pairs_; }
+        int sweeps() const { return sweeps_; }
+        double residual() const { return residual_; }
+        // Relation of the pieces on tick phase + 1: 0 = equal, 1 = player 0's wins, 2 = player 1's
+        int relation(int phase) const { return relation_[phase]; }
+
+    private:
+        // One pair draw applied to both value vectors (win, ticks)
+        void apply(int relation, const std::vector<double> *in, std::vector<double> *out, int threads) const;
+
+        TinyArenaSpec spec_{};
+        int n_{0};
+        int pairs_{0};
+        double hit_{0.0}; // per draw and live edge
+        uint32_t full_{0}, start_{0};
+        std::vector<uint32_t> neighbors_;       // per cell, interior neighbors as a mask
+        std::vector<std::vector<int>> perm_;    // symmetry -> cell permutation
+        std::vector<int32_t> index_;            // mask -> state, -1 = unreachable
+        std::vector<uint32_t> rep_;             // state -> its canonical mask
+        std::vector<uint8_t> relation_;         // per tick of the schedule period
+        // Per state: its flips, towards player 0 then towards player 1, as
+        // (successor << 3) | live edges of the flipped cell
+        std::vector<uint32_t> first_;           // state -> first flip; one past the end for the last
+        std::vector<uint8_t> to0_count_;        // flips towards player 0
+        std::vector<uint8_t> live_;             // live edges of the state
+        std::vector<uint32_t> flips_;
+        std::vector<double> win_, ticks_;       // per state, at tick 1 of the period
+        int sweeps_{0};
+        double residual_{0.0};
+    };
+
+    // Monte Carlo of the same game through resolve_cells, drawing pairs like
+    // the dense sampler; checks the chain, and is the pattern for checking a
+    // sampled engine against it
+    struct TinyArenaSample
+    {
+        double win{0.0}, win_ci{0.0}; // player 0's wins, 95% half-width
+        double ticks{0.0}, ticks_ci{0.0};
+        int timeouts{0};
+    };
+
+    TinyArenaSample sample_tiny_arena(const TinyArenaSpec &spec, int games, uint64_t seed, int max_ticks,
+                                      int threads);
+}
@@ -0,0 +1,356 @@
+#include "sim/MeanField.h"
+
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cmath>
+
+#include "core/Rules.h"
+#include "levels/Levels.h"
+#include "sim/Stats.h"
+#include "util/Rng.h"
+
+namespace hl
+{
+    namespace
+    {
+        // Level 1's opening as the model sees it
+        struct Opening
+        {
+            int open_cells{0};
+            int left_cells{0};
+            double frontier{0.0};
+        };
+
+        Opening level1_opening()
+        {
+            GameState gs;
+            gs.players = {PlayerState{PlayerId{0}, Piece::Rock}, PlayerState{PlayerId{1}, Piece::Scissors}};
+            load_level(gs, 1);
+            Opening o;
+            o.open_cells = gs.open_cells;
+            for (const auto &c : gs.grid.cells)
+                o.left_cells += c.kind == CellKind::Symbol && c.owner.v == 0;
+            o.frontier = gs.activity.live_edges();
+            return o;
+        }
+
+        // Net cells won by player 0 in h rule-5 coin flips
+        int coin_flips(Rng64 &rng, int h)
+        {
+            int won = 0;
+            for (int left = h; left > 0; left -= 64)
+            {
+                const int n = std::min(left, 64);
+                const uint64_t bits = rng.next();
+                won += static_cast<int>(std::bitset<64>(n == 64 ? bits : bits & ((uint64_t(1) << n) - 1)).count());
+            }
+            return 2 * won - h;
+        }
+
+        // Albert's rotation schedule (see update_albert_ai)
+        struct Schedule
+        {
+            AlbertConfig cfg{};
+            int piece{0};
+            int last_rot{0};
+            int period{0};
+
+            int draw(Rng64 &rng) const
+            {
+                const int lo = std::max(1, cfg.rotation_average - cfg.rotation_half_interval);
+                const int hi = cfg.rotation_average + cfg.rotation_half_interval;
+                return lo + static_cast<int>(Rng64::scale(rng.next(), static_cast<uint32_t>(hi - lo + 1)));
+            }
+
+            void update(int tick, Rng64 &rng)
+            {
+                if (period == 0)
+                    period = draw(rng);
+                if (tick - last_rot >= period)
+                {
+                    piece = (piece + 1) % 3;
+                    last_rot = tick;
+                    period = draw(rng);
+                }
+            }
+        };
+
+        int budget_for(const GameConfig &cfg, int open_cells, double frontier)
+        {
+            switch (cfg.pair_rate)
+            {
+            case PairRate::PerOpenCell:
+                return static_cast<int>(cfg.pairs_per_open_cell * open_cells + 0.5);
+            case PairRate::PerFrontier:
+                return static_cast<int>(cfg.pairs_per_frontier_edge * frontier + 0.5);
+            case PairRate::Fixed:
+                break;
+            }
+            return cfg.pairs_per_tick;
+        }
+
+        // Frontier target by minority size, tabulated once per estimate
+        std::vector<double> frontier_table(const MeanFieldParams &p, int open_cells)
+        {
+            std::vector<double> t(open_cells / 2 + 1);
+            for (size_t m = 0; m < t.size(); ++m)
+            {
+                // Stragglers are loose cells with about two live edges each
+                const double curve = p.frontier_max * (1.0 - std::exp(-static_cast<double>(m) / p.frontier_scale));
+                t[m] = std::max(curve, std::min(2.0 * m, p.frontier_max));
+            }
+            return t;
+        }
+
+        // One reduced game; returns the winner (-1 = timeout) and its length.
+        // With an advantage every frontier hit goes one way, so territory
+        // moves by its expected amount (the spread comes from the schedules);
+        // tied pieces play their coin flips.
+        int play_reduced(const MeanFieldSpec &spec, const Opening &open, const std::vector<double> &target,
+                         Rng64 &rng, int &ticks)
+        {
+            const double n_all = open.open_cells;
+            const double hit_rate = 1.0 / (2.0 * ARENA_W * ARENA_H); // per draw, per frontier edge
+            double n = open.left_cells;
+            double e = open.frontier;
+            Schedule side[2] = {{spec.left, static_cast<int>(Piece::Rock)},
+                                {spec.right, static_cast<int>(Piece::Scissors)}};
+
+            for (int tick = 1; tick <= spec.max_ticks; ++tick)
+            {
+                const double hits = budget_for(spec.cfg, open.open_cells, e) * e * hit_rate;
+                switch ((side[0].piece - side[1].piece + 3) % 3)
+                {
+                case 1: // player 0's piece beats player 1's
+                    n += hits;
+                    break;
+                case 2:
+                    n -= hits;
+                    break;
+                default:
+                    n += coin_flips(rng, static_cast<int>(hits + 0.5));
+                    break;
+                }
+                if (n <= 0.0 || n >= n_all)
+                {
+                    ticks = tick;
+                    return n <= 0.0 ? 1 : 0;
+                }
+                const int minority = static_cast<int>(std::ceil(std::min(n, n_all - n)));
+                // A front roughens gradually, but a shrinking pocket's
+                // perimeter shrinks with it
+                e = std::min(e + spec.params.relax * (target[minority] - e), target[minority]);
+
+                side[0].update(tick, rng);
+                side[1].update(tick, rng);
+            }
+            ticks = spec.max_ticks;
+            return -1;
+        }
+
+        void summarize(const std::vector<double> &score, const std::vector<double> &len,
+                       double &mean, double &ci, double &ticks, double &sd)
+        {
+            mean = mean_of(score);
+            ci = score.empty() ? 0.0 : Z95 * std::sqrt(var_of(score) / score.size());
+            ticks = mean_of(len);
+            sd = std::sqrt(var_of(len));
+        }
+    }
+
+    MeanFieldResult run_mean_field(const MeanFieldSpec &spec)
+    {
+        static const Opening open = level1_opening();
+        const auto t0 = std::chrono::steady_clock::now();
+        const std::vector<double> target = frontier_table(spec.params, open.open_cells);
+
+        Rng64 rng{spec.seed};
+        std::vector<double> score(spec.runs), len(spec.runs);
+        int timeouts = 0;
+        for (int i = 0; i < spec.runs; ++i)
+        {
+            int ticks = 0;
+            const int w = play_reduced(spec, open, target, rng, ticks);
+            score[i] = w == 0 ? 1.0 : w == 1 ? 0.0 : 0.5;
+            len[i] = ticks;
+            timeouts += w < 0;
+        }
+
+        MeanFieldResult r;
+        summarize(score, len, r.left_score, r.left_ci, r.mean_ticks, r.sd_ticks);
+        r.timeouts = spec.runs > 0 ? static_cast<double>(timeouts) / spec.runs : 0.0;
+        r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        return r;
+    }
+
+    // ----------------- Calibration -----------------
+    namespace
+    {
+        constexpr int MINORITY_BIN = 10; // cells per frontier bin
+        constexpr int RISE_TICKS = 40;   // opening ticks the relaxation rate is fitted to
+        constexpr int PROBE_EVERY = 4;   // later ticks sampled for the frontier bins
+
+        // Frontier samples of one exact game
+        struct FrontierSamples
+        {
+            std::vector<double> bin_sum;
+            std::vector<int> bin_n;
+            double rise[RISE_TICKS + 1]{};
+            int rise_n[RISE_TICKS + 1]{};
+
+            explicit FrontierSamples(int bins) : bin_sum(bins, 0.0), bin_n(bins, 0) {}
+
+            void merge(const FrontierSamples &o)
+            {
+                for (size_t b = 0; b < bin_sum.size(); ++b)
+                {
+                    bin_sum[b] += o.bin_sum[b];
+                    bin_n[b] += o.bin_n[b];
+                }
+                for (int t = 0; t <= RISE_TICKS; ++t)
+                {
+                    rise[t] += o.rise[t];
+                    rise_n[t] += o.rise_n[t];
+                }
+            }
+        };
+
+        MeanFieldParams fit_frontier(const FrontierSamples &s, double opening_frontier)
+        {
+            MeanFieldParams p;
+
+            // Plateau: bins past 150 cells; then the scale of the rise to it
+            double plateau = 0.0, plateau_w = 0.0;
+            for (size_t b = 0; b < s.bin_sum.size(); ++b)
+            {
+                if (s.bin_n[b] >= 20 && static_cast<int>(b) * MINORITY_BIN >= 150)
+                {
+                    plateau += s.bin_sum[b];
+                    plateau_w += s.bin_n[b];
+                }
+            }
+            if (plateau_w > 0.0)
+                p.frontier_max = plateau / plateau_w;
+            double best_scale = -1.0;
+            for (int scale = 5; scale <= 150; ++scale)
+            {
+                double err = 0.0;
+                for (size_t b = 0; b < s.bin_sum.size(); ++b)
+                {
+                    if (s.bin_n[b] < 20)
+                        continue;
+                    const double m = (b + 0.5) * MINORITY_BIN;
+                    const double d = s.bin_sum[b] / s.bin_n[b] - p.frontier_max * (1.0 - std::exp(-m / scale));
+                    err += s.bin_n[b] * d * d;
+                }
+                if (best_scale < 0.0 || err < best_scale)
+                {
+                    best_scale = err;
+                    p.frontier_scale = scale;
+                }
+            }
+
+            // Relaxation rate: least squares over the opening's mean frontier
+            double best = -1.0;
+            for (int r = 1; r <= 60; ++r)
+            {
+                const double rate = r * 0.01;
+                double e = opening_frontier, err = 0.0;
+                for (int t = 1; t <= RISE_TICKS; ++t)
+                {
+                    e += rate * (p.frontier_max - e);
+                    if (s.rise_n[t] > 0)
+                    {
+                        const double d = s.rise[t] / s.rise_n[t] - e;
+                        err += d * d;
+                    }
+                }
+                if (best < 0.0 || err < best)
+                {
+                    best = err;
+                    p.relax = rate;
+                }
+            }
+            return p;
+        }
+    }
+
+    CalibrationReport calibrate_mean_field(const std::vector<std::pair<AlbertConfig, AlbertConfig>> &matchups,
+                                           const GameConfig &cfg, int games, int runs, uint64_t seed,
+                                           int threads)
+    {
+        using clock = std::chrono::steady_clock;
+        const Opening open = level1_opening();
+        const int bins = open.open_cells / 2 / MINORITY_BIN + 1;
+
+        CalibrationReport rep;
+        FrontierSamples all(bins);
+        for (const auto &[a, b] : matchups)
+        {
+            CalibrationRow row;
+            row.left = a;
+            row.right = b;
+
+            std::vector<double> score(games), len(games), secs(games);
+            std::vector<FrontierSamples> samples(games, FrontierSamples(bins));
+            parallel_for(games, threads, [&](int i)
+                         {
+                             MatchSpec spec;
+                             spec.left.albert = a;
+                             spec.right.albert = b;
+                             spec.seed = seed + i;
+                             spec.cfg = cfg;
+                             FrontierSamples &s = samples[i];
+                             spec.on_tick = [&](const GameState &gs)
+                             {
+                                 if (gs.tick > RISE_TICKS && gs.tick % PROBE_EVERY)
+                                     return true;
+                                 int left = 0;
+                                 for (const auto &c : gs.grid.cells)
+                                     left += c.kind == CellKind::Symbol && c.owner.v == 0;
+                                 const int m = std::min(left, open.open_cells - left);
+                                 const double e = gs.activity.live_edges();
+                                 if (gs.tick <= RISE_TICKS)
+                                 {
+                                     s.rise[gs.tick] += e;
+                                     s.rise_n[gs.tick]++;
+                                 }
+                                 const int bin = std::min(m / MINORITY_BIN, bins - 1);
+                                 s.bin_sum[bin] += e;
+                                 s.bin_n[bin]++;
+                                 return true;
+                             };
+                             const auto t0 = clock::now();
+                             const MatchResult r = run_match(spec);
+                             secs[i] = std::chrono::duration<double>(clock::now() - t0).count();
+                             score[i] = r.winner == 0 ? 1.0 : r.winner == 1 ? 0.0 : 0.5;
+                             len[i] = r.ticks; });
+
+            for (const FrontierSamples &s : samples)
+                all.merge(s);
+            summarize(score, len, row.exact_score, row.exact_ci, row.exact_ticks, row.exact_sd);
+            row.exact_us_per_game = 1e6 * mean_of(secs);
+            rep.rows.push_back(row);
+        }
+
+        rep.fitted = fit_frontier(all, open.frontier);
+        for (CalibrationRow &row : rep.rows)
+        {
+            MeanFieldSpec spec;
+            spec.left = row.left;
+            spec.right = row.right;
+            spec.cfg = cfg;
+            spec.params = rep.fitted;
+            spec.runs = runs;
+            spec.seed = seed;
+            const MeanFieldResult r = run_mean_field(spec);
+            row.mf_score = r.left_score;
+            row.mf_ci = r.left_ci;
+            row.mf_ticks = r.mean_ticks;
+            row.mf_sd = r.sd_ticks;
+            row.mf_us_per_game = runs > 0 ? 1e6 * r.seconds / runs : 0.0;
+        }
+        return rep;
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/Game.h"
+#include "sim/Batch.h"
+
+// ----------------- Mean-Field Engine -----------------
+// An approximate level-1 game reduced to a few numbers per tick: player 0's
+// territory n, the frontier E (live edges between the sides) and both
+// pieces. Rates come from resolve_pair and the pair budget: a tick's draws
+// hit E of the 2*W*H undirected edges, so about budget*E/(2*W*H) frontier
+// cells change hands, all to the side whose piece beats the other's (rule
+// 6), or by coin flips when the pieces match (rule 5). The frontier has no
+// exact closure; it relaxes towards max * (1 - exp(-minority / scale)),
+// whose constants are fitted to exact games by calibrate_mean_field().
+// Rotations follow the Albert schedules exactly, on the model's own RNG.
+namespace hl
+{
+    struct MeanFieldParams
+    {
+        // Defaults: handlords_meanfield --calibrate 1000 on the fixed 240-pair budget
+        double frontier_max{55.4};   // frontier of a long front, in live edges
+        double frontier_scale{35.0}; // minority cells over which it falls towards 0
+        double relax{0.08};          // per tick, towards that target while roughening
+    };
+
+    struct MeanFieldSpec
+    {
+        AlbertConfig left{};  // player 0
+        AlbertConfig right{}; // player 1
+        GameConfig cfg{};     // pair budget, as in MatchSpec
+        MeanFieldParams params{};
+        int runs{400};        // replications of the reduced game
+        uint64_t seed{1};
+        int max_ticks{6000};  // scored as draws
+    };
+
+    struct MeanFieldResult
+    {
+        double left_score{0.5};  // win = 1, timeout = 0.5
+        double left_ci{0.0};     // 95% half-width
+        double mean_ticks{0.0};
+        double sd_ticks{0.0};
+        double timeouts{0.0};    // share of runs
+        double seconds{0.0};     // wall time of the estimate
+    };
+
+    // Plays spec.runs reduced games of level 1 (single-threaded)
+    MeanFieldResult run_mean_field(const MeanFieldSpec &spec);
+
+    // ----------------- Calibration -----------------
+    struct CalibrationRow
+    {
+        AlbertConfig left{}, right{};
+        double exact_score{0.5}, exact_ci{0.0};
+        double exact_ticks{0.0}, exact_sd{0.0};
+        double mf_score{0.5}, mf_ci{0.0};
+        double mf_ticks{0.0}, mf_sd{0.0};
+        double exact_us_per_game{0.0}, mf_us_per_game{0.0};
+    };
+
+    struct CalibrationReport
+    {
+        MeanFieldParams fitted{};
+        std::vector<CalibrationRow> rows;
+    };
+
+    // Plays `games` exact games per matchup (in parallel), fits the frontier
+    // constants to the frontier and territory seen in them, and compares the
+    // fitted model against the exact engine on every matchup
+    CalibrationReport calibrate_mean_field(const std::vector<std::pair<AlbertConfig, AlbertConfig>> &matchups,
+                                           const GameConfig &cfg, int games, int runs, uint64_t seed,
+                                           int threads);
+}
@@ -0,0 +1,135 @@
+#include "sim/Ratings.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "sim/Stats.h"
+
+namespace hl
+{
+    // In-place Gauss-Jordan inverse of a small dense matrix; false if singular
+    static bool invert(std::vector<std::vector<double>> &m)
+    {
+        const int n = static_cast<int>(m.size());
+        std::vector<std::vector<double>> inv(n, std::vector<double>(n, 0.0));
+        for (int i = 0; i < n; ++i)
+            inv[i][i] = 1.0;
+
+        for (int c = 0; c < n; ++c)
+        {
+            int piv = c;
+            for (int r = c + 1; r < n; ++r)
+            {
+                if (std::fabs(m[r][c]) > std::fabs(m[piv][c]))
+                    piv = r;
+            }
+            if (std::fabs(m[piv][c]) < 1e-12)
+                return false;
+            std::swap(m[c], m[piv]);
+            std::swap(inv[c], inv[piv]);
+
+            const double d = m[c][c];
+            for (int k = 0; k < n; ++k)
+            {
+                m[c][k] /= d;
+                inv[c][k] /= d;
+            }
+            for (int r = 0; r < n; ++r)
+            {
+                if (r == c || m[r][c] == 0.0)
+                    continue;
+                const double f = m[r][c];
+                for (int k = 0; k < n; ++k)
+                {
+                    m[r][k] -= f * m[c][k];
+                    inv[r][k] -= f * inv[c][k];
+                }
+            }
+        }
+        m.swap(inv);
+        return true;
+    }
+
+    Ratings bradley_terry(const std::vector<std::vector<double>> &score,
+                          const std::vector<std::vector<double>> &games)
+    {
+        const int n = static_cast<int>(score.size());
+        const double elo_per_nat = 400.0 / std::log(10.0);
+
+        // Prior: one virtual draw between every pair
+        std::vector<std::vector<double>> s(n, std::vector<double>(n, 0.0));
+        std::vector<std::vector<double>> g(n, std::vector<double>(n, 0.0));
+        for (int i = 0; i < n; ++i)
+        {
+            for (int j = 0; j < n; ++j)
+            {
+                if (i == j)
+                    continue;
+                s[i][j] = score[i][j] + 0.5;
+                g[i][j] = games[i][j] + 1.0;
+            }
+        }
+
+        std::vector<double> gamma(n, 1.0);
+        for (int iter = 0; iter < 1000; ++iter)
+        {
+            double change = 0.0;
+            for (int i = 0; i < n; ++i)
+            {
+                double wins = 0.0, denom = 0.0;
+                for (int j = 0; j < n; ++j)
+                {
+                    if (i == j)
+                        continue;
+                    wins += s[i][j];
+                    denom += g[i][j] / (gamma[i] + gamma[j]);
+                }
+                const double next = denom > 0.0 ? wins / denom : gamma[i];
+                change = std::max(change, std::fabs(std::log(next / gamma[i])));
+                gamma[i] = next;
+            }
+            // Normalize to geometric mean 1 (Elo mean 0)
+            double log_mean = 0.0;
+            for (double v : gamma)
+                log_mean += std::log(v);
+            log_mean /= n;
+            for (double &v : gamma)
+                v /= std::exp(log_mean);
+            if (change < 1e-9)
+                break;
+        }
+
+        Ratings r;
+        r.elo.resize(n);
+        r.elo_ci.assign(n, 0.0);
+        for (int i = 0; i < n; ++i)
+            r.elo[i] = elo_per_nat * std::log(gamma[i]);
+        if (n < 2)
+            return r;
+
+        // Fisher information in log-strength; singular along (1,..,1), so
+        // invert L + P with P = 11'/n and subtract P back out (pseudo-inverse).
+        std::vector<std::vector<double>> info(n, std::vector<double>(n, 1.0 / n));
+        for (int i = 0; i < n; ++i)
+        {
+            for (int j = 0; j < n; ++j)
+            {
+                if (i == j)
+                    continue;
+                const double p = gamma[i] / (gamma[i] + gamma[j]);
+                const double w = g[i][j] * p * (1.0 - p);
+                info[i][i] += w;
+                info[i][j] -= w;
+            }
+        }
+        if (!invert(info))
+            return r;
+        for (int i = 0; i < n; ++i)
+        {
+            const double var = info[i][i] - 1.0 / n;
+            r.elo_ci[i] = var > 0.0 ? Z95 * elo_per_nat * std::sqrt(var) : 0.0;
+        }
+        return r;
+    }
+}
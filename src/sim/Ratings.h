@@ -0,0 +1,20 @@
+#pragma once
+
+#include <vector>
+
+// ----------------- Ratings -----------------
+namespace hl
+{
+    struct Ratings
+    {
+        std::vector<double> elo;    // mean zero across entrants
+        std::vector<double> elo_ci; // 95% half-width
+    };
+
+    // Bradley-Terry maximum likelihood fit (MM iterations) with one virtual
+    // draw per pairing as a prior, so unbeaten entrants stay finite.
+    // score[i][j] = points i took from j (draw = 0.5), games[i][j] = games played.
+    // Confidence intervals come from the inverse Fisher information.
+    Ratings bradley_terry(const std::vector<std::vector<double>> &score,
+                          const std::vector<std::vector<double>> &games);
+}
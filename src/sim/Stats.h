@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// ----------------- Sample Statistics -----------------
+namespace hl
+{
+    inline double mean_of(const std::vector<double> &v)
+    {
+        double s = 0.0;
+        for (double x : v)
+            s += x;
+        return v.empty() ? 0.0 : s / v.size();
+    }
+
+    // Unbiased sample covariance (n - 1 denominator)
+    inline double cov_of(const std::vector<double> &a, const std::vector<double> &b)
+    {
+        const size_t n = std::min(a.size(), b.size());
+        if (n < 2)
+            return 0.0;
+        double ma = 0.0, mb = 0.0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            ma += a[i];
+            mb += b[i];
+        }
+        ma /= n;
+        mb /= n;
+        double s = 0.0;
+        for (size_t i = 0; i < n; ++i)
+            s += (a[i] - ma) * (b[i] - mb);
+        return s / (n - 1);
+    }
+
+    inline double var_of(const std::vector<double> &v) { return cov_of(v, v); }
+
+    // Two-sided 95% normal quantile
+    constexpr double Z95 = 1.959963984540054;
+}
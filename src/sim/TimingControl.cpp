@@ -0,0 +1,150 @@
+#include "sim/TimingControl.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "util/Rng.h"
+
+namespace hl
+{
+    namespace
+    {
+        // +1 when piece a beats b, -1 when it loses, 0 on a tie (Paper beats Rock, ...)
+        int relation(int a, int b)
+        {
+            const int d = ((a - b) % 3 + 3) % 3;
+            return d == 1 ? 1 : d == 2 ? -1 : 0;
+        }
+
+        // start_match deals Rock to the left and Scissors to the right
+        int start_piece(int side)
+        {
+            return static_cast<int>(side == 0 ? Piece::Rock : Piece::Scissors);
+        }
+    }
+
+    TimingControl::TimingControl(const AlbertConfig &me, const AlbertConfig &opp, double tau)
+        : me_(periods_of(me)), opp_(periods_of(opp))
+    {
+        // exp(-8) of the weight is left beyond the horizon
+        horizon_ = std::max(1, static_cast<int>(std::ceil(8.0 * tau)));
+        weight_.resize(horizon_ + 1);
+        for (int t = 0; t <= horizon_; ++t)
+            weight_[t] = std::exp(-t / tau);
+
+        const auto qm = phase(me_), qo = phase(opp_);
+        for (int side = 0; side < 2; ++side)
+        {
+            const int pm = start_piece(side), po = start_piece(1 - side);
+            double sum = 0.0;
+            for (int t = 1; t <= horizon_; ++t)
+            {
+                double e = 0.0;
+                for (int i = 0; i < 3; ++i)
+                {
+                    for (int j = 0; j < 3; ++j)
+                        e += qm[t][i] * qo[t][j] * relation(pm + i, po + j);
+                }
+                sum += weight_[t] * e;
+            }
+            mean_[side] = sum;
+        }
+    }
+
+    TimingControl::Periods TimingControl::periods_of(const AlbertConfig &c)
+    {
+        // As update_albert_ai draws it: min + (16-bit draw % range)
+        const int max = c.rotation_average + c.rotation_half_interval;
+        Periods d;
+        d.min = std::max(1, c.rotation_average - c.rotation_half_interval);
+        const int range = max - d.min + 1;
+        d.p.assign(range, 0.0);
+        for (int r = 0; r < 65536; ++r)
+            d.p[r % range] += 1.0 / 65536.0;
+        return d;
+    }
+
+    std::vector<std::array<double, 3>> TimingControl::phase(const Periods &d) const
+    {
+        const int range = static_cast<int>(d.p.size());
+        const int max = d.min + range - 1;
+
+        // hit[s][k]: P(some rotation j falls on tick s with j = k mod 3); rotation 0 is the start
+        std::vector<std::array<double, 3>> hit(horizon_ + 1, {0.0, 0.0, 0.0});
+        hit[0][0] = 1.0;
+        for (int s = d.min; s <= horizon_; ++s)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                double v = 0.0;
+                for (int i = 0; i < range && d.min + i <= s; ++i)
+                    v += d.p[i] * hit[s - d.min - i][(k + 2) % 3];
+                hit[s][k] = v;
+            }
+        }
+
+        // longer[x] = P(period > x)
+        std::vector<double> longer(max + 1, 0.0);
+        for (int x = 0; x <= max; ++x)
+        {
+            for (int i = std::max(0, x + 1 - d.min); i < range; ++i)
+                longer[x] += d.p[i];
+        }
+
+        std::vector<std::array<double, 3>> q(horizon_ + 1, {0.0, 0.0, 0.0});
+        for (int t = 0; t <= horizon_; ++t)
+        {
+            for (int s = std::max(0, t - max); s <= t; ++s)
+            {
+                for (int k = 0; k < 3; ++k)
+                    q[t][k] += hit[s][k] * longer[t - s];
+            }
+        }
+        return q;
+    }
+
+    double TimingControl::value(int side, const std::vector<int> &mine, const std::vector<int> &theirs,
+                                uint64_t seed) const
+    {
+        Rng64 rng{seed};
+        auto extend = [&](std::vector<int> v, const Periods &d)
+        {
+            long long end = 0;
+            for (int x : v)
+                end += x;
+            while (end <= horizon_)
+            {
+                v.push_back(d.min + static_cast<int>((rng.next() & 0xFFFF) % d.p.size()));
+                end += v.back();
+            }
+            return v;
+        };
+        const std::vector<int> pm = extend(mine, me_), po = extend(theirs, opp_);
+
+        int nm = 0, no = 0;
+        long long next_m = pm[0], next_o = po[0];
+        double sum = 0.0;
+        for (int t = 1; t <= horizon_; ++t)
+        {
+            while (next_m <= t)
+                next_m += pm[++nm];
+            while (next_o <= t)
+                next_o += po[++no];
+            sum += weight_[t] * relation(start_piece(side) + nm, start_piece(1 - side) + no);
+        }
+        return sum;
+    }
+
+    void PeriodLog::observe(const GameState &gs)
+    {
+        for (int i = 0; i < 2 && i < static_cast<int>(gs.players.size()); ++i)
+        {
+            const PlayerState &p = gs.players[i];
+            // A draw sets a new period, or follows a rotation (which may repeat the old one)
+            if (p.rot_period != 0 && (p.rot_period != period_[i] || p.last_rot_tick != last_rot_[i]))
+                drawn[i].push_back(p.rot_period);
+            period_[i] = p.rot_period;
+            last_rot_[i] = p.last_rot_tick;
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "core/Game.h"
+
+// ----------------- Rotation Timing Control -----------------
+// A control variate for Albert-vs-Albert batches whose mean is known exactly.
+// Albert's rotation periods are independent draws from a fixed distribution
+// whatever happens on the board, so any function of them can be averaged
+// without playing a game. The control counts, tick by tick, +1 / -1 / 0 as
+// one side's piece beats, loses to or ties the other's, weighted by
+// exp(-t / tau) so that ticks few games reach count little. Periods a game
+// ended before drawing are filled in from a separate stream.
+namespace hl
+{
+    class TimingControl
+    {
+    public:
+        TimingControl(const AlbertConfig &me, const AlbertConfig &opp, double tau);
+
+        // Expected value with `me` on `side` (0 = left, starts Rock; 1 = right, starts Scissors)
+        double mean(int side) const { return mean_[side]; }
+
+        // Value for one game from the periods each side drew there, in draw order
+        double value(int side, const std::vector<int> &mine, const std::vector<int> &theirs,
+                     uint64_t seed) const;
+
+    private:
+        struct Periods
+        {
+            int min{1};
+            std::vector<double> p; // P(period = min + k)
+        };
+
+        static Periods periods_of(const AlbertConfig &c);
+        // P(rotations made by tick t = k mod 3), t = 0..horizon_
+        std::vector<std::array<double, 3>> phase(const Periods &d) const;
+
+        Periods me_, opp_;
+        std::vector<double> weight_; // per tick, 0..horizon_
+        int horizon_{0};
+        double mean_[2]{0.0, 0.0};
+    };
+
+    // Records the rotation periods both players draw; call after every tick
+    class PeriodLog
+    {
+    public:
+        void observe(const GameState &gs);
+
+        std::vector<int> drawn[2];
+
+    private:
+        int period_[2]{0, 0};
+        int last_rot_[2]{0, 0};
+    };
+}
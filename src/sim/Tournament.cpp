@@ -0,0 +1,213 @@
+#include "sim/Tournament.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace hl
+{
+    bool parse_side(const std::string &spec, SideConfig &out)
+    {
+        if (spec == "idle")
+        {
+            out = SideConfig{AiKind::Human, AlbertConfig{}};
+            return true;
+        }
+        if (spec == "albert")
+        {
+            out = SideConfig{AiKind::Albert, AlbertConfig{}};
+            return true;
+        }
+        int avg = 0, half = 0;
+        if (std::sscanf(spec.c_str(), "albert:%d:%d", &avg, &half) == 2 && avg > 0 && half >= 0 &&
+            avg + half <= 255) // rot_period is a u8
+        {
+            out = SideConfig{AiKind::Albert, AlbertConfig{avg, half}};
+            return true;
+        }
+        return false;
+    }
+
+    std::vector<Entrant> default_entrants()
+    {
+        return {
+            {"albert", SideConfig{AiKind::Albert, AlbertConfig{58, 43}}},
+            {"albert-fast", SideConfig{AiKind::Albert, AlbertConfig{25, 10}}},
+            {"albert-slow", SideConfig{AiKind::Albert, AlbertConfig{120, 20}}},
+            {"idle", SideConfig{AiKind::Human, AlbertConfig{}}},
+        };
+    }
+
+    // Seed of mirrored pair `index` of pairing `k`; independent of scheduling order
+    static uint64_t pair_seed(uint64_t base, size_t k, uint64_t index)
+    {
+        return base * 0x9E3779B97F4A7C15ull + (static_cast<uint64_t>(k) << 40) + index;
+    }
+
+    static Ratings rate(const std::vector<Pairing> &pairings, int n)
+    {
+        std::vector<std::vector<double>> score(n, std::vector<double>(n, 0.0));
+        std::vector<std::vector<double>> games(n, std::vector<double>(n, 0.0));
+        for (const auto &p : pairings)
+        {
+            score[p.a][p.b] += p.score_a;
+            score[p.b][p.a] += p.games - p.score_a;
+            games[p.a][p.b] += p.games;
+            games[p.b][p.a] += p.games;
+        }
+        return bradley_terry(score, games);
+    }
+
+    // Splits `budget` mirrored pairs across pairings in proportion to the
+    // variance of their mean score, p(1-p)/n: close and under-sampled
+    // pairings get more games, lopsided ones stop soaking up the budget.
+    static std::vector<int> allocate(const std::vector<Pairing> &pairings, int budget)
+    {
+        const size_t k = pairings.size();
+        std::vector<double> w(k);
+        double total = 0.0;
+        for (size_t i = 0; i < k; ++i)
+        {
+            const auto &p = pairings[i];
+            const double mean = (p.score_a + 1.0) / (p.games + 2.0);
+            w[i] = mean * (1.0 - mean) / std::max(1, p.games);
+            total += w[i];
+        }
+
+        std::vector<int> out(k, 0);
+        std::vector<std::pair<double, size_t>> rem;
+        int used = 0;
+        for (size_t i = 0; i < k; ++i)
+        {
+            const double share = total > 0.0 ? budget * w[i] / total : double(budget) / k;
+            out[i] = static_cast<int>(share);
+            used += out[i];
+            rem.push_back({share - out[i], i});
+        }
+        // Largest remainder; ties broken by index to stay deterministic
+        std::sort(rem.begin(), rem.end(), [](const auto &x, const auto &y)
+                  { return x.first != y.first ? x.first > y.first : x.second < y.second; });
+        for (size_t i = 0; used < budget && i < rem.size(); ++i, ++used)
+            out[rem[i].second]++;
+        return out;
+    }
+
+    TournamentReport run_tournament(const TournamentConfig &cfg,
+                                    const std::function<void(const TournamentProgress &)> &progress)
+    {
+        using clock = std::chrono::steady_clock;
+        const auto start = clock::now();
+        const int n = static_cast<int>(cfg.entrants.size());
+
+        TournamentReport rep;
+        for (int level : cfg.levels)
+        {
+            for (int a = 0; a < n; ++a)
+            {
+                for (int b = a + 1; b < n; ++b)
+                {
+                    Pairing p;
+                    p.a = a;
+                    p.b = b;
+                    p.level = level;
+                    rep.pairings.push_back(p);
+                }
+            }
+        }
+        if (rep.pairings.empty())
+            return rep;
+
+        const int round_pairs = cfg.round_pairs > 0 ? cfg.round_pairs
+                                                    : 16 * static_cast<int>(rep.pairings.size());
+
+        struct Job
+        {
+            size_t pairing;
+            uint64_t index;
+            double score_a;
+            long long ticks;
+        };
+
+        for (int round = 0;; ++round)
+        {
+            std::vector<int> alloc = round == 0
+                                         ? std::vector<int>(rep.pairings.size(), cfg.initial_pairs)
+                                         : allocate(rep.pairings, round_pairs);
+
+            // Respect the game budget: trim the allocation from the back
+            int planned = 0;
+            for (int c : alloc)
+                planned += c;
+            int room = (cfg.max_games - rep.games) / 2;
+            for (size_t i = alloc.size(); i-- > 0 && planned > room;)
+            {
+                const int cut = std::min(alloc[i], planned - room);
+                alloc[i] -= cut;
+                planned -= cut;
+            }
+            if (planned <= 0)
+                break;
+
+            std::vector<Job> jobs;
+            for (size_t k = 0; k < alloc.size(); ++k)
+            {
+                for (int j = 0; j < alloc[k]; ++j)
+                    jobs.push_back(Job{k, rep.pairings[k].next_pair++, 0.0, 0});
+            }
+
+            parallel_for(static_cast<int>(jobs.size()), cfg.threads, [&](int i)
+                         {
+                             Job &job = jobs[i];
+                             const Pairing &p = rep.pairings[job.pairing];
+                             MatchSpec spec;
+                             spec.level = p.level;
+                             spec.max_ticks = cfg.max_ticks;
+                             spec.seed = pair_seed(cfg.seed, job.pairing, job.index);
+
+                             spec.left = cfg.entrants[p.a].side;
+                             spec.right = cfg.entrants[p.b].side;
+                             MatchResult r0 = run_match(spec);
+                             spec.left = cfg.entrants[p.b].side;
+                             spec.right = cfg.entrants[p.a].side;
+                             MatchResult r1 = run_match(spec);
+
+                             auto points = [](const MatchResult &r, int side)
+                             { return r.winner < 0 ? 0.5 : (r.winner == side ? 1.0 : 0.0); };
+                             job.score_a = points(r0, 0) + points(r1, 1);
+                             job.ticks = r0.ticks + r1.ticks; });
+
+            for (const Job &job : jobs)
+            {
+                Pairing &p = rep.pairings[job.pairing];
+                p.score_a += job.score_a;
+                p.games += 2;
+                rep.games += 2;
+                rep.ticks += job.ticks;
+            }
+
+            rep.ratings = rate(rep.pairings, n);
+            rep.seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+            TournamentProgress prog;
+            prog.round = round;
+            prog.games = rep.games;
+            prog.seconds = rep.seconds;
+            prog.max_ci = *std::max_element(rep.ratings.elo_ci.begin(), rep.ratings.elo_ci.end());
+            prog.ratings = &rep.ratings;
+            prog.pairings = &rep.pairings;
+            if (progress)
+                progress(prog);
+
+            if (prog.max_ci <= cfg.target_ci)
+            {
+                rep.converged = true;
+                break;
+            }
+            if (rep.games >= cfg.max_games || rep.seconds >= cfg.max_seconds)
+                break;
+            if (cfg.cancel && cfg.cancel->load())
+                break;
+        }
+        return rep;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "sim/Batch.h"
+#include "sim/Ratings.h"
+
+// ----------------- Round-robin Tournament -----------------
+namespace hl
+{
+    struct Entrant
+    {
+        std::string name;
+        SideConfig side{};
+    };
+
+    struct TournamentConfig
+    {
+        std::vector<Entrant> entrants;
+        std::vector<int> levels{1};
+        uint64_t seed{1};
+        int threads{0};          // 0 = all cores
+        int max_ticks{6000};     // timeouts score as draws
+        int initial_pairs{16};   // mirrored pairs per pairing before adapting
+        int round_pairs{0};      // pairs per adaptive round (0 = 16 per pairing)
+        int max_games{40000};    // hard budget
+        double max_seconds{300}; // wall-clock budget
+        double target_ci{25.0};  // stop once every 95% Elo half-width is below this
+        const std::atomic<bool> *cancel{nullptr}; // stop after the current round once set
+    };
+
+    // One (entrant a, entrant b, level) combination; a < b
+    struct Pairing
+    {
+        int a{0};
+        int b{0};
+        int level{1};
+        double score_a{0.0}; // points a took from b (draw = 0.5)
+        int games{0};
+        uint64_t next_pair{0}; // seed index of the next mirrored pair
+    };
+
+    struct TournamentProgress
+    {
+        int round{0};
+        int games{0};
+        double seconds{0.0};
+        double max_ci{0.0};
+        const Ratings *ratings{nullptr};
+        const std::vector<Pairing> *pairings{nullptr};
+    };
+
+    struct TournamentReport
+    {
+        Ratings ratings;
+        std::vector<Pairing> pairings;
+        int games{0};
+        long long ticks{0};
+        double seconds{0.0};
+        bool converged{false};
+    };
+
+    // Parses "albert:AVG:HALF", "albert" or "idle"
+    bool parse_side(const std::string &spec, SideConfig &out);
+
+    // The default roster: Albert at a few cadences plus a non-rotating baseline
+    std::vector<Entrant> default_entrants();
+
+    // Plays every pairing on every level in mirrored pairs (same seed, sides
+    // swapped), then spends each further round on the pairings whose result is
+    // least certain. Deterministic for a given config regardless of threads.
+    TournamentReport run_tournament(const TournamentConfig &cfg,
+                                    const std::function<void(const TournamentProgress &)> &progress);
+}
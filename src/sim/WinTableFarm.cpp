@@ -0,0 +1,166 @@
+#include "sim/WinTableFarm.h"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+
+#include "sim/Stats.h"
+#include "util/Rng.h"
+
+namespace hl
+{
+    namespace
+    {
+        // Tunings the build draws each side from: the range balance sweeps cover
+        const AlbertConfig BUILD_CONFIGS[] = {{25, 10}, {40, 20}, {58, 43}, {80, 20}, {120, 20}};
+
+        struct GameSamples
+        {
+            std::vector<int> index[2]; // per side, one bucket per tick
+            double result[2]{0.5, 0.5};
+        };
+
+        double seconds_since(std::chrono::steady_clock::time_point t0)
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        }
+    }
+
+    WinTableBuildReport build_win_table(const WinTableBuildSpec &spec)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        std::vector<GameSamples> games(spec.games);
+        parallel_for(spec.games, spec.threads,
+                     [&](int g)
+                     {
+                         Rng64 pick{spec.seed ^ (static_cast<uint64_t>(g) * 0xD1B54A32D192ED03ull)};
+                         const int n = static_cast<int>(sizeof(BUILD_CONFIGS) / sizeof(BUILD_CONFIGS[0]));
+                         MatchSpec ms;
+                         ms.left.albert = BUILD_CONFIGS[Rng64::scale(pick.next(), n)];
+                         ms.right.albert = BUILD_CONFIGS[Rng64::scale(pick.next(), n)];
+                         ms.seed = spec.seed + g;
+                         ms.max_ticks = spec.max_ticks;
+                         ms.cfg = spec.cfg;
+                         GameSamples &s = games[g];
+                         ms.on_tick = [&s](const GameState &gs)
+                         {
+                             for (int side = 0; side < 2; ++side)
+                                 s.index[side].push_back(win_table_index(gs, gs.players[side], 0));
+                             return true;
+                         };
+                         const MatchResult r = run_match(ms);
+                         if (r.winner >= 0)
+                         {
+                             s.result[r.winner] = 1.0;
+                             s.result[1 - r.winner] = 0.0;
+                         }
+                     });
+
+        std::vector<double> wins(WinTable::SIZE, 0.0), count(WinTable::SIZE, 0.0);
+        WinTableBuildReport rep;
+        for (const GameSamples &s : games)
+        {
+            for (int side = 0; side < 2; ++side)
+            {
+                for (int i : s.index[side])
+                {
+                    wins[i] += s.result[side];
+                    count[i] += 1.0;
+                }
+                rep.samples += s.index[side].size();
+            }
+        }
+
+        // Prior per share and relation, itself pulled towards the share's midpoint
+        const int per_relation = WinTable::SINCES;
+        const int per_share = WinTable::FRONTIERS * WinTable::RELATIONS * WinTable::SINCES;
+        std::array<double, WinTable::SHARES * WinTable::RELATIONS> mw{}, mn{};
+        for (int i = 0; i < WinTable::SIZE; ++i)
+        {
+            const int k = (i / per_share) * WinTable::RELATIONS + (i / per_relation) % WinTable::RELATIONS;
+            mw[k] += wins[i];
+            mn[k] += count[i];
+        }
+        for (int i = 0; i < WinTable::SIZE; ++i)
+        {
+            const int share = i / per_share;
+            const int k = share * WinTable::RELATIONS + (i / per_relation) % WinTable::RELATIONS;
+            const double mid = (share + 0.5) / WinTable::SHARES;
+            const double prior = (mw[k] + spec.prior * mid) / (mn[k] + spec.prior);
+            rep.table.set(i, (wins[i] + spec.prior * prior) / (count[i] + spec.prior));
+            rep.empty += count[i] == 0.0;
+            rep.sparse += count[i] < 100.0;
+        }
+
+        double se = 0.0;
+        for (const GameSamples &s : games)
+        {
+            for (int side = 0; side < 2; ++side)
+            {
+                for (int i : s.index[side])
+                {
+                    const double d = rep.table.p(i) - s.result[side];
+                    se += d * d;
+                }
+            }
+        }
+        rep.brier = rep.samples ? se / rep.samples : 0.0;
+        rep.seconds = seconds_since(t0);
+        return rep;
+    }
+
+    std::vector<StrengthRow> measure_win_table(const StrengthSpec &spec, AiMeter &meter)
+    {
+        SideConfig albert{AiKind::Albert, spec.opponent};
+        SideConfig table = albert;
+        table.ai = AiKind::Table;
+        table.table.table = spec.table;
+        SideConfig rollout = albert;
+        rollout.ai = AiKind::Rollout;
+        rollout.rollout = spec.rollout;
+        struct Contender
+        {
+            const char *name;
+            SideConfig side, opponent;
+        };
+        const Contender contenders[] = {{"albert (baseline)", albert, albert},
+                                        {"table", table, albert},
+                                        {"rollout", rollout, albert},
+                                        {"table vs rollout", table, rollout}};
+
+        const int pairs = (spec.games + 1) / 2;
+        std::vector<StrengthRow> rows;
+        for (const Contender &c : contenders)
+        {
+            const auto t0 = std::chrono::steady_clock::now();
+            std::vector<double> score(2 * pairs), ticks(2 * pairs);
+            parallel_for(2 * pairs, spec.threads,
+                         [&](int g)
+                         {
+                             // Mirrored pairs: the contender takes each side once on the same seed
+                             const int me = g % 2;
+                             MatchSpec ms;
+                             (me == 0 ? ms.left : ms.right) = c.side;
+                             (me == 0 ? ms.right : ms.left) = c.opponent;
+                             ms.seed = spec.seed + g / 2;
+                             ms.max_ticks = spec.max_ticks;
+                             ms.cfg = spec.cfg;
+                             ms.ai_meter = &meter;
+                             const MatchResult r = run_match(ms);
+                             score[g] = r.winner < 0 ? 0.5 : r.winner == me ? 1.0 : 0.0;
+                             ticks[g] = r.ticks;
+                         });
+            std::vector<double> pair_score(pairs);
+            for (int p = 0; p < pairs; ++p)
+                pair_score[p] = 0.5 * (score[2 * p] + score[2 * p + 1]);
+            StrengthRow row;
+            row.name = c.name;
+            row.score = mean_of(pair_score);
+            row.ci = Z95 * std::sqrt(var_of(pair_score) / pairs);
+            row.mean_ticks = mean_of(ticks);
+            row.seconds = seconds_since(t0);
+            rows.push_back(row);
+        }
+        return rows;
+    }
+}
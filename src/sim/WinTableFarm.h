@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ai/AiMeter.h"
+#include "ai/WinTable.h"
+#include "sim/Batch.h"
+
+// ----------------- Win-Table Pipeline -----------------
+// Builds the Table AI's win table from batch games and measures how much of
+// the Rollout AI's playing strength it keeps (see ai/WinTable.h).
+namespace hl
+{
+    struct WinTableBuildSpec
+    {
+        int games{4000};      // Albert-vs-Albert games of level 1, tuning varied per side
+        uint64_t seed{1};
+        int max_ticks{6000};  // timeouts count as half a win for both sides
+        GameConfig cfg{};
+        double prior{8.0};    // pseudo-games pulling sparse buckets towards their share's mean
+        int threads{0};
+    };
+
+    struct WinTableBuildReport
+    {
+        WinTable table{};
+        uint64_t samples{0}; // positions tabulated, one per side and tick
+        int empty{0};        // buckets no game reached (filled from the prior)
+        int sparse{0};       // buckets with fewer than 100 samples
+        double brier{0.0};   // mean squared error of the quantized table on its samples
+        double seconds{0.0};
+    };
+
+    // Every tick of every game is a sample for both sides: its bucket and the
+    // side's eventual result
+    WinTableBuildReport build_win_table(const WinTableBuildSpec &spec);
+
+    struct StrengthSpec
+    {
+        const WinTable *table{nullptr};
+        AlbertConfig opponent{}; // every contender plays this Albert
+        RolloutConfig rollout{};
+        int games{200};          // per contender, in mirrored pairs (same seed, sides swapped)
+        uint64_t seed{1};
+        int max_ticks{6000};
+        GameConfig cfg{};
+        int threads{0};
+    };
+
+    struct StrengthRow
+    {
+        std::string name;
+        double score{0.5}, ci{0.0}; // against the opponent; win = 1, timeout = 0.5
+        double mean_ticks{0.0};
+        double seconds{0.0};        // wall time of the contender's games
+    };
+
+    // Albert with the opponent's own tuning (the baseline), the Table AI and
+    // the Rollout AI against the same opponent on the same seeds, then the
+    // Table AI against the Rollout AI; AI costs are merged into meter
+    std::vector<StrengthRow> measure_win_table(const StrengthSpec &spec, AiMeter &meter);
+}
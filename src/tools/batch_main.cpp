@@ -0,0 +1,428 @@
+// Headless batch runner for balance statistics.
+//
+// Plays many level-1 games between two AI configurations and estimates the
+// win rate of config A. Variance reduction options:
+//   --antithetic      play each seed twice with sides swapped (level 1 is
+//                     left/right symmetric, so the side bias cancels per pair)
+//   --compare AVG:HALF  estimate the win-rate change of a second config A'
+//                     against the same opponent using common random numbers
+//   rotation timing   on by default: A's weighted piece advantage from the
+//                     Albert period draws, a control variate with an exactly
+//                     known mean (sim/TimingControl.h), so it costs no games
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "ai/AiMeter.h"
+#include "sim/Batch.h"
+#include "sim/Stats.h"
+#include "sim/TimingControl.h"
+
+namespace
+{
+    struct Options
+    {
+        int games{2000};
+        uint64_t seed{1};
+        int threads{0};
+        int max_ticks{6000};
+        hl::AlbertConfig a{};
+        hl::AlbertConfig b{};
+        bool compare{false};
+        hl::AlbertConfig a2{};
+        bool antithetic{false};
+        bool lfsr{false};
+        int lfsr_stride{1};
+        bool sparse{false};
+        hl::GameConfig cfg{};
+        int ai_latency{0};
+        bool ai_costs{false};
+        hl::AiBudget ai_budget{}; // enforced when any limit is set
+        hl::AiMeter *ai_meter{nullptr};
+        bool control{true};
+        double control_tau{300.0};
+        double target_ci{0.005};
+        std::string metrics_file;
+        double metrics_every{5.0};
+    };
+
+    // Samples for one config under test: outcome U and control C per unit.
+    // A unit is one game, or one mirrored pair of games with --antithetic.
+    struct Arm
+    {
+        std::vector<double> u;
+        std::vector<double> c;  // minus its exact mean
+        double naive_var{0.0};  // per-unit variance had the games been independent
+        std::vector<double> lengths; // ticks of every game
+    };
+
+    struct Estimate
+    {
+        double mean{0.0};
+        double var_naive{0.0};  // independent games
+        double var_paired{0.0}; // after antithetic / CRN pairing
+        double var_final{0.0};  // after control variate
+        double beta{0.0};
+        int n{0};
+    };
+
+    bool parse_config(const char *s, hl::AlbertConfig &out)
+    {
+        int avg = 0, half = 0;
+        if (std::sscanf(s, "%d:%d", &avg, &half) != 2 || avg <= 0 || half < 0)
+            return false;
+        out.rotation_average = avg;
+        out.rotation_half_interval = half;
+        return true;
+    }
+
+    void usage()
+    {
+        std::fprintf(stderr,
+                     "usage: handlords_batch [options]\n"
+                     "  --games N           seeds to play (default 2000)\n"
+                     "  --seed S            first seed (default 1)\n"
+                     "  --threads T         worker threads (default: all cores)\n"
+                     "  --max-ticks M       timeout, scored as a draw (default 6000)\n"
+                     "  --a AVG:HALF        Albert config under test (default 58:43)\n"
+                     "  --b AVG:HALF        opponent Albert config (default 58:43)\n"
+                     "  --compare AVG:HALF  second config A' vs the same opponent (CRN)\n"
+                     "  --antithetic        mirrored pairs: same seed, sides swapped\n"
+                     "  --lfsr              use the 16-bit LFSR instead of the system RNG\n"
+                     "  --lfsr-stride K     LFSR steps per draw: 1, 8 or 16 (implies --lfsr)\n"
+                     "  --sparse            skip quiescent 8x8 blocks when sampling pairs\n"
+                     "  --pairs-per-cell R  pair budget R per open cell instead of 240 per tick\n"
+                     "  --pairs-per-edge R  pair budget R per frontier edge instead of 240 per tick\n"
+                     "  --ai-latency K      AIs decide on worker threads, applied K ticks later\n"
+                     "  --ai-costs          per-AI time, RNG draws and cells per tick\n"
+                     "  --ai-budget US:DRAWS:CELLS  fail if one AI update exceeds this (0 = unchecked)\n"
+                     "  --no-control        skip the rotation-timing control variate\n"
+                     "  --control-tau T     ticks over which the control's weight decays (default 300)\n"
+                     "  --target-ci W       95%% half-width used for games-needed (default 0.005)\n"
+                     "  --metrics-file PATH rewrite OpenMetrics counters to PATH while running\n"
+                     "  --metrics-every S   seconds between rewrites (default 5)\n");
+    }
+
+    bool parse_args(int argc, char **argv, Options &o)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char *arg = argv[i];
+            const char *val = i + 1 < argc ? argv[i + 1] : nullptr;
+            auto need = [&]() -> const char *
+            {
+                if (!val)
+                {
+                    std::fprintf(stderr, "missing value for %s\n", arg);
+                    return nullptr;
+                }
+                ++i;
+                return val;
+            };
+
+            if (!std::strcmp(arg, "--antithetic"))
+                o.antithetic = true;
+            else if (!std::strcmp(arg, "--lfsr"))
+                o.lfsr = true;
+            else if (!std::strcmp(arg, "--sparse"))
+                o.sparse = true;
+            else if (!std::strcmp(arg, "--no-control"))
+                o.control = false;
+            else if (!std::strcmp(arg, "--ai-costs"))
+                o.ai_costs = true;
+            else if (!std::strcmp(arg, "--ai-budget") && need())
+            {
+                if (std::sscanf(val, "%lf:%u:%u", &o.ai_budget.max_us, &o.ai_budget.max_draws,
+                                &o.ai_budget.max_cells) != 3)
+                    return false;
+                o.ai_costs = true;
+            }
+            else if (!std::strcmp(arg, "--lfsr-stride") && need())
+            {
+                o.lfsr_stride = std::atoi(val);
+                if (o.lfsr_stride != 1 && o.lfsr_stride != 8 && o.lfsr_stride != 16)
+                    return false;
+                o.lfsr = true;
+            }
+            else if (!std::strcmp(arg, "--pairs-per-cell") && need())
+            {
+                o.cfg.pair_rate = hl::PairRate::PerOpenCell;
+                o.cfg.pairs_per_open_cell = std::atof(val);
+                if (o.cfg.pairs_per_open_cell <= 0.0)
+                    return false;
+            }
+            else if (!std::strcmp(arg, "--pairs-per-edge") && need())
+            {
+                o.cfg.pair_rate = hl::PairRate::PerFrontier;
+                o.cfg.pairs_per_frontier_edge = std::atof(val);
+                if (o.cfg.pairs_per_frontier_edge <= 0.0)
+                    return false;
+            }
+            else if (!std::strcmp(arg, "--ai-latency") && need())
+                o.ai_latency = std::atoi(val);
+            else if (!std::strcmp(arg, "--games") && need())
+                o.games = std::atoi(val);
+            else if (!std::strcmp(arg, "--seed") && need())
+                o.seed = std::strtoull(val, nullptr, 0);
+            else if (!std::strcmp(arg, "--threads") && need())
+                o.threads = std::atoi(val);
+            else if (!std::strcmp(arg, "--max-ticks") && need())
+                o.max_ticks = std::atoi(val);
+            else if (!std::strcmp(arg, "--a") && need())
+            {
+                if (!parse_config(val, o.a))
+                    return false;
+            }
+            else if (!std::strcmp(arg, "--b") && need())
+            {
+                if (!parse_config(val, o.b))
+                    return false;
+            }
+            else if (!std::strcmp(arg, "--compare") && need())
+            {
+                if (!parse_config(val, o.a2))
+                    return false;
+                o.compare = true;
+            }
+            else if (!std::strcmp(arg, "--control-tau") && need())
+                o.control_tau = std::atof(val);
+            else if (!std::strcmp(arg, "--target-ci") && need())
+                o.target_ci = std::atof(val);
+            else if (!std::strcmp(arg, "--metrics-file") && need())
+                o.metrics_file = val;
+            else if (!std::strcmp(arg, "--metrics-every") && need())
+                o.metrics_every = std::atof(val);
+            else
+                return false;
+        }
+        // uint16_t tick counter, and Albert's rot_period is a u8
+        return o.games > 1 && o.max_ticks > 0 && o.max_ticks < 65000 &&
+               o.control_tau > 0.0;
+    }
+
+    double score_for(const hl::MatchResult &r, int side)
+    {
+        if (r.winner < 0)
+            return 0.5;
+        return r.winner == side ? 1.0 : 0.0;
+    }
+
+    // Plays one game with A on `side`; c is A's timing control less its mean
+    double play_side(const Options &o, hl::MatchSpec &spec, const hl::SideConfig &sa, const hl::SideConfig &sb,
+                     int side, const hl::TimingControl &tc, double &c, int &ticks)
+    {
+        spec.left = side == 0 ? sa : sb;
+        spec.right = side == 0 ? sb : sa;
+        hl::PeriodLog log;
+        if (o.control)
+            spec.on_tick = [&log](const hl::GameState &gs)
+            {
+                log.observe(gs);
+                return true;
+            };
+        hl::MatchResult r = hl::run_match(spec);
+        ticks = r.ticks;
+        // Periods past the game's end come from a stream of their own
+        c = o.control ? tc.value(side, log.drawn[side], log.drawn[1 - side], spec.seed * 2 + side) - tc.mean(side)
+                      : 0.0;
+        return score_for(r, side);
+    }
+
+    // Plays one unit for config `a` against opts.b. Returns (U, C) and the
+    // length of each game played.
+    void play_unit(const Options &o, const hl::AlbertConfig &a, const hl::TimingControl &tc, uint64_t seed,
+                   double &u, double &c, double u_side[2], int ticks[2])
+    {
+        hl::SideConfig sa{hl::AiKind::Albert, a};
+        hl::SideConfig sb{hl::AiKind::Albert, o.b};
+
+        hl::MatchSpec spec;
+        spec.seed = seed;
+        spec.lfsr = o.lfsr;
+        spec.lfsr_stride = o.lfsr_stride;
+        spec.sparse = o.sparse;
+        spec.cfg = o.cfg;
+        spec.ai_latency = o.ai_latency;
+        spec.ai_meter = o.ai_meter;
+        spec.max_ticks = o.max_ticks;
+
+        u = u_side[0] = play_side(o, spec, sa, sb, 0, tc, c, ticks[0]);
+        if (o.antithetic)
+        {
+            double c1 = 0.0;
+            u_side[1] = play_side(o, spec, sa, sb, 1, tc, c1, ticks[1]);
+            u = 0.5 * (u + u_side[1]);
+            c = 0.5 * (c + c1);
+        }
+    }
+
+    Arm run_arm(const Options &o, const hl::AlbertConfig &a)
+    {
+        const int n = o.games;
+        Arm arm;
+        arm.u.resize(n);
+        arm.c.resize(n);
+        std::vector<double> left(n), right(n);
+        std::vector<int> ticks(2 * n, 0);
+        const hl::TimingControl tc(a, o.b, o.control_tau);
+
+        hl::parallel_for(n, o.threads, [&](int i)
+                         {
+                             double sides[2] = {0.0, 0.0};
+                             play_unit(o, a, tc, o.seed + i, arm.u[i], arm.c[i], sides, &ticks[2 * i]);
+                             left[i] = sides[0];
+                             right[i] = sides[1]; });
+
+        for (int i = 0; i < n; ++i)
+        {
+            for (int k = 0; k < (o.antithetic ? 2 : 1); ++k)
+                arm.lengths.push_back(ticks[2 * i + k]);
+        }
+        // Independent games with A on a random side; includes the side advantage
+        if (o.antithetic)
+        {
+            std::vector<double> pooled(left);
+            pooled.insert(pooled.end(), right.begin(), right.end());
+            arm.naive_var = 0.5 * hl::var_of(pooled);
+        }
+        else
+        {
+            arm.naive_var = hl::var_of(left);
+        }
+
+        return arm;
+    }
+
+    // Optimal control-variate estimate; c has mean zero by construction
+    Estimate estimate(const std::vector<double> &u, const std::vector<double> &c,
+                      double naive_var, bool use_control)
+    {
+        Estimate e;
+        e.n = static_cast<int>(u.size());
+        e.mean = hl::mean_of(u);
+        e.var_naive = naive_var;
+        e.var_paired = hl::var_of(u);
+        e.var_final = e.var_paired;
+        if (!use_control)
+            return e;
+
+        const double vc = hl::var_of(c);
+        if (vc <= 0.0)
+            return e;
+        e.beta = hl::cov_of(u, c) / vc;
+        std::vector<double> resid(u.size());
+        for (size_t i = 0; i < u.size(); ++i)
+            resid[i] = u[i] - e.beta * c[i];
+        e.mean = hl::mean_of(resid);
+        e.var_final = hl::var_of(resid);
+        return e;
+    }
+
+    double games_needed(double var_per_unit, int games_per_unit, double half_width)
+    {
+        return games_per_unit * var_per_unit * (hl::Z95 / half_width) * (hl::Z95 / half_width);
+    }
+
+    void report(const char *label, const Estimate &e, const Options &o, int games_per_unit)
+    {
+        const double se = std::sqrt(e.var_final / e.n);
+        std::printf("%s\n", label);
+        std::printf("  estimate            %.4f +/- %.4f (95%%)\n", e.mean, hl::Z95 * se);
+        if (o.control)
+            std::printf("  control beta        %.5f\n", e.beta);
+        std::printf("  variance / unit     naive %.5f  paired %.5f  final %.5f\n",
+                    e.var_naive, e.var_paired, e.var_final);
+        if (e.var_final <= 0.0)
+        {
+            // e.g. identical configs with --antithetic: every pair is an exact draw
+            std::printf("  reduction           exact (zero variance)\n");
+            return;
+        }
+        const double pair_x = e.var_naive / e.var_paired;
+        const double cv_x = e.var_paired / e.var_final;
+        const double total_x = e.var_naive / e.var_final;
+        std::printf("  reduction           pairing x%.2f  control x%.2f  total x%.2f\n", pair_x, cv_x, total_x);
+        std::printf("  games for +/-%.3f   naive %.0f  reduced %.0f\n", o.target_ci,
+                    games_needed(e.var_naive, games_per_unit, o.target_ci),
+                    games_needed(e.var_final, games_per_unit, o.target_ci));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options o;
+    if (!parse_args(argc, argv, o))
+    {
+        usage();
+        return 2;
+    }
+
+    const int per_unit = o.antithetic ? 2 : 1;
+    std::printf("handlords_batch: %d units x %d game(s), seed %llu, max %d ticks\n",
+                o.games, per_unit, static_cast<unsigned long long>(o.seed), o.max_ticks);
+    std::printf("  A  = Albert %d:%d   B = Albert %d:%d", o.a.rotation_average, o.a.rotation_half_interval,
+                o.b.rotation_average, o.b.rotation_half_interval);
+    if (o.compare)
+        std::printf("   A' = Albert %d:%d", o.a2.rotation_average, o.a2.rotation_half_interval);
+    // Successive LFSR draws are not independent, so the control's exact mean would not hold
+    if (o.lfsr)
+        o.control = false;
+    std::printf("\n  antithetic %s, timing control %s\n\n", o.antithetic ? "on" : "off",
+                o.control ? "on" : o.lfsr ? "off (LFSR)" : "off");
+
+    hl::AiMeter ai_meter;
+    if (o.ai_costs)
+    {
+        ai_meter.budget = o.ai_budget;
+        ai_meter.enforce = o.ai_budget.max_us > 0.0 || o.ai_budget.max_draws > 0 || o.ai_budget.max_cells > 0;
+        o.ai_meter = &ai_meter;
+    }
+
+    hl::MetricsFileWriter metrics;
+    std::string err;
+    if (!o.metrics_file.empty() && !metrics.start(o.metrics_file, o.metrics_every, err))
+    {
+        std::fprintf(stderr, "%s\n", err.c_str());
+        return 1;
+    }
+
+    Arm arm_a = run_arm(o, o.a);
+    Estimate ea = estimate(arm_a.u, arm_a.c, arm_a.naive_var, o.control);
+    std::printf("game length: mean %.1f, sd %.1f ticks\n\n", hl::mean_of(arm_a.lengths),
+                std::sqrt(hl::var_of(arm_a.lengths)));
+    report("win rate of A vs B:", ea, o, per_unit);
+
+    if (o.compare)
+    {
+        Arm arm_b = run_arm(o, o.a2);
+        Estimate eb = estimate(arm_b.u, arm_b.c, arm_b.naive_var, o.control);
+        std::printf("\n");
+        report("win rate of A' vs B:", eb, o, per_unit);
+
+        // Common random numbers: both arms saw the same seeds, so difference per unit
+        std::vector<double> du(o.games), dc(o.games);
+        for (int i = 0; i < o.games; ++i)
+        {
+            du[i] = arm_b.u[i] - arm_a.u[i];
+            dc[i] = arm_b.c[i] - arm_a.c[i];
+        }
+        Estimate ed = estimate(du, dc, arm_a.naive_var + arm_b.naive_var, o.control);
+        // The baseline for CRN is two independent arms, already paired within each arm
+        const double indep = hl::var_of(arm_a.u) + hl::var_of(arm_b.u);
+        std::printf("\n");
+        report("difference A' - A (common random numbers):", ed, o, per_unit * 2);
+        std::printf("  CRN alone           x%.2f vs independent seeds\n",
+                    ed.var_paired > 0.0 ? indep / ed.var_paired : 0.0);
+    }
+
+    if (o.ai_costs)
+    {
+        std::printf("\nAI cost per update:\n");
+        ai_meter.report(stdout);
+        if (ai_meter.failed())
+            return 1;
+    }
+    return 0;
+}
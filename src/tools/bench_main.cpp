@@ -0,0 +1,470 @@
+// Headless benchmark harness.
+//
+// Each case runs a fixed amount of work and reports a rate. Cases:
+//   board/<sampler>      pairs/s of step_fixed on the 40x24 board, Albert vs Albert
+//   large/<layout>/<N>   pairs/s of resolve_pairs_large on an N x N split arena
+//   packed<B>/<layout>/<N>  same on a B-bit packed grid
+//   <engine>-pf/...      the software-pipelined (prefetching) engine, same grid
+//   packed4-auto/...     whichever packed engine resolve_pairs_packed_auto picks
+//   census/<grid>/<N>    cells/s counted per owner (Cell scan vs SIMD packed)
+//   unpack/packed<B>/<N> cells/s expanded to one byte per cell
+//   games/level1         whole Albert-vs-Albert level-1 games per second
+//
+// --counters adds hardware counters per unit of work for each case, and
+// --profile prints the step_fixed phase table after the board cases.
+// --repeat/--pin/--out record repeated runs for handlords_benchcmp.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ai/AiMeter.h"
+#include "core/LargeGrid.h"
+#include "core/PackedGrid.h"
+#include "levels/Levels.h"
+#include "sim/Batch.h"
+#include "sim/BenchCompare.h"
+#include "util/PerfCounters.h"
+#include "util/Profiler.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace
+{
+    double seconds_since(std::chrono::steady_clock::time_point t0)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    // Times the measured region of a case and, when counters are open, reads
+    // them around the same region
+    struct Meter
+    {
+        const hl::PerfCounters *perf{nullptr};
+        std::chrono::steady_clock::time_point t0;
+        hl::PerfSample c0, counts;
+        double work{0.0};
+
+        void start()
+        {
+            if (perf)
+                c0 = perf->read();
+            t0 = std::chrono::steady_clock::now();
+        }
+
+        // Returns the rate of `done` units per second
+        double stop(double done)
+        {
+            const double secs = seconds_since(t0);
+            if (perf)
+                counts = perf->read() - c0;
+            work = done;
+            return done / secs;
+        }
+    };
+
+    struct BenchCase
+    {
+        std::string name;
+        const char *unit;
+        std::function<double(Meter &)> run; // returns the rate in `unit`
+    };
+
+    struct Options
+    {
+        std::string filter;
+        long long pairs{10000000};
+        bool counters{false};
+        bool profile{false};
+        int repeat{1};
+        int pin_cpu{-1};
+        std::string out;
+    };
+
+    // Keeps the process on one CPU so repetitions do not migrate between
+    // cores (and their caches) mid-case
+    bool pin_to_cpu(int cpu, std::string &err)
+    {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) == 0)
+            return true;
+        err = "sched_setaffinity(" + std::to_string(cpu) + ") failed";
+#else
+        (void)cpu;
+        err = "CPU pinning is only supported on Linux";
+#endif
+        return false;
+    }
+
+    // Whole ticks of level-1 games, restarted whenever one ends
+    double bench_board(Meter &m, bool batched, long long pairs, bool profile)
+    {
+        hl::GameState gs;
+        hl::Profiler prof;
+        hl::AiMeter ai_meter;
+        if (profile)
+        {
+            gs.ai_meter = &ai_meter;
+            std::string err;
+            if (m.perf)
+                prof.enable_hw_counters(err);
+            gs.profiler = &prof;
+        }
+        uint64_t seed = 1;
+        auto restart = [&]()
+        {
+            gs.players = {hl::PlayerState{hl::PlayerId{0}, hl::Piece::Rock},
+                          hl::PlayerState{hl::PlayerId{1}, hl::Piece::Scissors}};
+            for (auto &p : gs.players)
+                p.ai = hl::AiKind::Albert;
+            hl::seed_game(gs, seed++, false);
+            gs.batched_pairs = batched;
+            gs.tick = 0;
+            load_level(gs, 1);
+            gs.phase = hl::Phase::Playing;
+        };
+        restart();
+
+        m.start();
+        long long done = 0;
+        while (done < pairs)
+        {
+            step_fixed(gs);
+            done += gs.cfg.pairs_per_tick;
+            if (gs.phase != hl::Phase::Playing)
+                restart();
+        }
+        const double rate = m.stop(static_cast<double>(done));
+        if (profile)
+        {
+            prof.report(stdout);
+            ai_meter.report(stdout);
+        }
+        return rate;
+    }
+
+    template <typename Layout, bool PIPELINED>
+    double bench_large(Meter &m, int n, long long pairs)
+    {
+        hl::LargeGrid<Layout> grid(n, n);
+        hl::fill_split_arena(grid);
+        hl::Rng64 rng;
+        std::vector<uint32_t> losses(2, 0);
+        auto run = [&](long long count)
+        {
+            if (PIPELINED)
+                hl::resolve_pairs_large_pipelined(grid, rng, count, losses);
+            else
+                hl::resolve_pairs_large(grid, rng, count, losses);
+        };
+
+        // Short warm-up so page faults and frequency ramp are not timed
+        run(pairs / 20);
+
+        m.start();
+        run(pairs);
+        return m.stop(static_cast<double>(pairs));
+    }
+
+    template <typename Layout, bool PIPELINED = false>
+    void add_large_cases(std::vector<BenchCase> &cases, const Options &o)
+    {
+        for (int n : {512, 2048, 8192})
+        {
+            cases.push_back({std::string(PIPELINED ? "large-pf/" : "large/") + Layout::name + "/" + std::to_string(n),
+                             "pairs/s", [n, &o](Meter &m)
+                             { return bench_large<Layout, PIPELINED>(m, n, o.pairs); }});
+        }
+    }
+
+    // Which packed engine a case runs, and the suffix of its name
+    enum class PackedEngine
+    {
+        Plain,     // packed<B>/...
+        Pipelined, // packed<B>-pf/...
+        Auto,      // packed<B>-auto/...: by grid size
+    };
+
+    template <typename Layout, int BITS, PackedEngine ENGINE>
+    double bench_packed(Meter &m, int n, long long pairs)
+    {
+        hl::PackedGrid<Layout, BITS> grid(n, n);
+        hl::fill_split_arena(grid);
+        hl::Rng64 rng;
+        std::vector<uint32_t> losses(2, 0);
+        auto run = [&](long long count)
+        {
+            if (ENGINE == PackedEngine::Pipelined)
+                hl::resolve_pairs_packed_pipelined(grid, rng, count, losses);
+            else if (ENGINE == PackedEngine::Auto)
+                hl::resolve_pairs_packed_auto(grid, rng, count, losses);
+            else
+                hl::resolve_pairs_packed(grid, rng, count, losses);
+        };
+
+        run(pairs / 20);
+
+        m.start();
+        run(pairs);
+        return m.stop(static_cast<double>(pairs));
+    }
+
+    template <typename Layout, int BITS, PackedEngine ENGINE = PackedEngine::Plain>
+    void add_packed_cases(std::vector<BenchCase> &cases, const Options &o)
+    {
+        const char *suffix = ENGINE == PackedEngine::Pipelined ? "-pf/" : ENGINE == PackedEngine::Auto ? "-auto/" : "/";
+        for (int n : {2048, 8192, 16384})
+        {
+            cases.push_back({"packed" + std::to_string(BITS) + suffix + Layout::name + "/" + std::to_string(n),
+                             "pairs/s", [n, &o](Meter &m)
+                             { return bench_packed<Layout, BITS, ENGINE>(m, n, o.pairs); }});
+        }
+    }
+
+    // Per-owner census over the whole arena, repeated until ~0.2 s have passed
+    template <typename F>
+    double repeat_rate(Meter &m, double work_per_call, F fn)
+    {
+        m.start();
+        int calls = 0;
+        do
+        {
+            fn();
+            ++calls;
+        } while (seconds_since(m.t0) < 0.2);
+        return m.stop(calls * work_per_call);
+    }
+
+    void add_census_cases(std::vector<BenchCase> &cases)
+    {
+        const int n = 8192;
+        cases.push_back({"census/cell/8192", "cells/s", [n](Meter &m)
+                         {
+                             hl::LargeGrid<hl::RowMajorLayout> grid(n, n);
+                             hl::fill_split_arena(grid);
+                             volatile uint32_t sink = 0;
+                             return repeat_rate(m, double(n) * n, [&]()
+                                                {
+                                                    uint32_t counts[2] = {0, 0};
+                                                    for (const auto &c : grid.cells)
+                                                    {
+                                                        if (c.kind == hl::CellKind::Symbol && c.owner.v < 2)
+                                                            counts[c.owner.v]++;
+                                                    }
+                                                    sink = counts[0] + counts[1]; });
+                         }});
+        cases.push_back({"census/packed4/8192", "cells/s", [n](Meter &m)
+                         {
+                             hl::PackedGrid<hl::RowMajorLayout, 4> grid(n, n);
+                             hl::fill_split_arena(grid);
+                             volatile uint32_t sink = 0;
+                             return repeat_rate(m, double(n) * n, [&]()
+                                                {
+                                                    uint32_t counts[2];
+                                                    grid.census(counts, 2);
+                                                    sink = counts[0] + counts[1]; });
+                         }});
+        cases.push_back({"census/packed2/8192", "cells/s", [n](Meter &m)
+                         {
+                             hl::PackedGrid<hl::RowMajorLayout, 2> grid(n, n);
+                             hl::fill_split_arena(grid);
+                             volatile uint32_t sink = 0;
+                             return repeat_rate(m, double(n) * n, [&]()
+                                                {
+                                                    uint32_t counts[2];
+                                                    grid.census(counts, 2);
+                                                    sink = counts[0] + counts[1]; });
+                         }});
+        cases.push_back({"unpack/packed4/8192", "cells/s", [n](Meter &m)
+                         {
+                             hl::PackedGrid<hl::RowMajorLayout, 4> grid(n, n);
+                             hl::fill_split_arena(grid);
+                             std::vector<uint8_t> out(grid.bytes.size() * 2);
+                             return repeat_rate(m, double(n) * n, [&]()
+                                                { grid.unpack(out.data()); });
+                         }});
+    }
+
+    // Whole level-1 games, Albert against Albert, on consecutive seeds
+    void add_games_case(std::vector<BenchCase> &cases)
+    {
+        cases.push_back({"games/level1", "games/s", [](Meter &m)
+                         {
+                             uint64_t seed = 1;
+                             volatile int sink = 0;
+                             return repeat_rate(m, 1.0, [&]()
+                                                {
+                                                    hl::MatchSpec spec;
+                                                    spec.seed = seed++;
+                                                    sink = hl::run_match(spec).ticks; });
+                         }});
+    }
+
+    void usage()
+    {
+        std::fprintf(stderr,
+                     "usage: handlords_bench [options]\n"
+                     "  --filter STR   run only cases whose name contains STR\n"
+                     "  --pairs N      pairs per large-grid case (default 10000000)\n"
+                     "  --counters     hardware counters per unit of work (cycles, IPC, misses)\n"
+                     "  --profile      step_fixed phase and per-AI cost tables after each board case\n"
+                     "  --repeat N     run each case N times and print the median (default 1)\n"
+                     "  --pin CPU      pin the process to one CPU\n"
+                     "  --out PATH     write every repetition to PATH for handlords_benchcmp\n"
+                     "  --list         list cases and exit\n");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options o;
+    bool list = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--list"))
+            list = true;
+        else if (!std::strcmp(argv[i], "--counters"))
+            o.counters = true;
+        else if (!std::strcmp(argv[i], "--profile"))
+            o.profile = true;
+        else if (!std::strcmp(argv[i], "--filter") && i + 1 < argc)
+            o.filter = argv[++i];
+        else if (!std::strcmp(argv[i], "--pairs") && i + 1 < argc)
+            o.pairs = std::atoll(argv[++i]);
+        else if (!std::strcmp(argv[i], "--repeat") && i + 1 < argc)
+            o.repeat = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--pin") && i + 1 < argc)
+            o.pin_cpu = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--out") && i + 1 < argc)
+            o.out = argv[++i];
+        else
+        {
+            usage();
+            return 2;
+        }
+    }
+
+    std::vector<BenchCase> cases;
+    cases.push_back({"board/sequential", "pairs/s", [&o](Meter &m)
+                     { return bench_board(m, false, o.pairs, o.profile); }});
+    cases.push_back({"board/batched", "pairs/s", [&o](Meter &m)
+                     { return bench_board(m, true, o.pairs, o.profile); }});
+    add_large_cases<hl::RowMajorLayout>(cases, o);
+    add_large_cases<hl::TiledLayout>(cases, o);
+    add_large_cases<hl::MortonLayout>(cases, o);
+    add_packed_cases<hl::RowMajorLayout, 4>(cases, o);
+    add_packed_cases<hl::TiledLayout, 4>(cases, o);
+    add_packed_cases<hl::RowMajorLayout, 2>(cases, o);
+    add_large_cases<hl::RowMajorLayout, true>(cases, o);
+    add_large_cases<hl::MortonLayout, true>(cases, o);
+    add_packed_cases<hl::RowMajorLayout, 4, PackedEngine::Pipelined>(cases, o);
+    add_packed_cases<hl::RowMajorLayout, 4, PackedEngine::Auto>(cases, o);
+    add_census_cases(cases);
+    add_games_case(cases);
+
+    if (o.pin_cpu >= 0 && !list)
+    {
+        std::string err;
+        if (!pin_to_cpu(o.pin_cpu, err))
+            std::printf("warning: %s, running unpinned\n", err.c_str());
+    }
+
+    hl::PerfCounters perf;
+    if (o.counters && !list)
+    {
+        std::string err;
+        if (perf.open(err))
+        {
+            std::printf("%-28s %14s %-8s %9s %6s %9s %9s %9s   (per unit)\n", "case", "rate", "", "cycles", "IPC",
+                        "L1d miss", "LLC miss", "br miss");
+            if (!err.empty())
+                std::printf("hw counters %s\n", err.c_str());
+        }
+        else
+            std::printf("hw counters unavailable (%s), timing only\n", err.c_str());
+    }
+
+    std::vector<const BenchCase *> selected;
+    std::vector<hl::BenchSeries> results;
+    for (const auto &c : cases)
+    {
+        if (!o.filter.empty() && c.name.find(o.filter) == std::string::npos)
+            continue;
+        if (list)
+            std::printf("%s\n", c.name.c_str());
+        selected.push_back(&c);
+        results.push_back(hl::BenchSeries{c.name, c.unit, {}});
+    }
+    if (list)
+        return 0;
+
+    // Repetitions go round-robin over the cases, so a burst of machine noise
+    // spreads across cases instead of hitting every run of one; lines print
+    // during the last round
+    for (int r = 0; r < o.repeat; ++r)
+    {
+        for (size_t i = 0; i < selected.size(); ++i)
+        {
+            const BenchCase &c = *selected[i];
+            hl::BenchSeries &series = results[i];
+            Meter m;
+            if (perf.available())
+                m.perf = &perf;
+            series.samples.push_back(c.run(m));
+            if (r + 1 < o.repeat)
+                continue;
+            const double rate = hl::median_of(series.samples);
+            if (!m.perf)
+                std::printf("%-28s %14.0f %s", c.name.c_str(), rate, c.unit);
+            else
+            {
+                std::printf("%-28s %14.0f %-8s", c.name.c_str(), rate, c.unit);
+                auto col = [&](int e, const char *fmt)
+                {
+                    if (perf.has(e))
+                        std::printf(fmt, m.counts.v[e] / m.work);
+                    else
+                        std::printf(" %9s", "-");
+                };
+                col(hl::PERF_CYCLES, " %9.2f");
+                if (perf.has(hl::PERF_INSTRUCTIONS) && m.counts.v[hl::PERF_CYCLES])
+                    std::printf(" %6.2f",
+                                static_cast<double>(m.counts.v[hl::PERF_INSTRUCTIONS]) / m.counts.v[hl::PERF_CYCLES]);
+                else
+                    std::printf(" %6s", "-");
+                col(hl::PERF_L1D_MISSES, " %9.3f");
+                col(hl::PERF_LLC_MISSES, " %9.3f");
+                col(hl::PERF_BRANCH_MISSES, " %9.3f");
+            }
+            if (o.repeat > 1)
+            {
+                const auto mm = std::minmax_element(series.samples.begin(), series.samples.end());
+                std::printf("  [%+.1f%%, %+.1f%%]", 100.0 * (*mm.first / rate - 1.0), 100.0 * (*mm.second / rate - 1.0));
+            }
+            std::printf("\n");
+            std::fflush(stdout);
+        }
+    }
+
+    if (!o.out.empty())
+    {
+        std::string err;
+        const std::string comment = "handlords_bench --pairs " + std::to_string(o.pairs) + " --repeat " +
+                                    std::to_string(o.repeat) + (o.pin_cpu >= 0 ? " --pin " + std::to_string(o.pin_cpu) : "");
+        if (!hl::write_bench_results(o.out, results, comment, err))
+        {
+            std::fprintf(stderr, "handlords_bench: %s\n", err.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
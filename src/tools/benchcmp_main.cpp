@@ -0,0 +1,131 @@
+// Benchmark regression gate.
+//
+// Compares two handlords_bench --out files case by case and flags only
+// changes that are both statistically significant and beyond --threshold.
+// Exits 1 if any case regressed.
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "sim/BenchCompare.h"
+
+namespace
+{
+    struct Options
+    {
+        std::string base, cand;
+        hl::CompareOptions cmp;
+    };
+
+    void usage()
+    {
+        std::fprintf(stderr,
+                     "usage: handlords_benchcmp BASE NEW [options]\n"
+                     "  --threshold PCT     smallest change to flag, in percent (default 3)\n"
+                     "  --test bootstrap|mwu  significance test (default bootstrap)\n"
+                     "  --alpha A           Mann-Whitney significance level (default 0.05)\n"
+                     "  --resamples N       bootstrap resamples (default 4000)\n"
+                     "  --seed S            bootstrap seed (default 1)\n");
+    }
+
+    bool parse_args(int argc, char **argv, Options &o)
+    {
+        std::vector<std::string> files;
+        for (int i = 1; i < argc; ++i)
+        {
+            const char *arg = argv[i];
+            if (std::strncmp(arg, "--", 2) != 0)
+            {
+                files.push_back(arg);
+                continue;
+            }
+            if (i + 1 >= argc)
+                return false;
+            const char *val = argv[++i];
+            if (!std::strcmp(arg, "--threshold"))
+                o.cmp.threshold = std::atof(val) / 100.0;
+            else if (!std::strcmp(arg, "--test"))
+            {
+                if (!std::strcmp(val, "bootstrap"))
+                    o.cmp.test = hl::BenchTest::Bootstrap;
+                else if (!std::strcmp(val, "mwu"))
+                    o.cmp.test = hl::BenchTest::MannWhitney;
+                else
+                    return false;
+            }
+            else if (!std::strcmp(arg, "--alpha"))
+                o.cmp.alpha = std::atof(val);
+            else if (!std::strcmp(arg, "--resamples"))
+                o.cmp.resamples = std::atoi(val);
+            else if (!std::strcmp(arg, "--seed"))
+                o.cmp.seed = std::strtoull(val, nullptr, 0);
+            else
+                return false;
+        }
+        if (files.size() != 2)
+            return false;
+        o.base = files[0];
+        o.cand = files[1];
+        return o.cmp.threshold >= 0.0 && o.cmp.alpha > 0.0 && o.cmp.resamples > 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options o;
+    if (!parse_args(argc, argv, o))
+    {
+        usage();
+        return 2;
+    }
+
+    std::vector<hl::BenchSeries> base, cand;
+    std::string err;
+    if (!hl::read_bench_results(o.base, base, err) || !hl::read_bench_results(o.cand, cand, err))
+    {
+        std::fprintf(stderr, "handlords_benchcmp: %s\n", err.c_str());
+        return 2;
+    }
+
+    std::printf("%-28s %14s %14s %8s %19s %7s  %s\n", "case", "base", "new", "change", "95% CI", "p", "verdict");
+    int regressions = 0, improvements = 0, few = 0;
+    for (const auto &c : cand)
+    {
+        const hl::BenchSeries *b = nullptr;
+        for (const auto &s : base)
+        {
+            if (s.name == c.name)
+                b = &s;
+        }
+        if (!b || b->unit != c.unit)
+        {
+            std::printf("%-28s %14s %14.4g %8s %19s %7s  %s\n", c.name.c_str(), "-", hl::median_of(c.samples), "",
+                        "", "", b ? "unit differs" : "new case");
+            continue;
+        }
+        const auto r = hl::compare_series(*b, c, o.cmp);
+        const char *verdict = r.regression ? "REGRESSION" : r.improvement ? "improved" : r.significant ? "~ (below threshold)" : "~";
+        std::printf("%-28s %14.4g %14.4g %+7.1f%% [%+7.1f%%, %+7.1f%%] %7.3f  %s\n", c.name.c_str(), r.base_median,
+                    r.new_median, 100.0 * r.change, 100.0 * r.ci_lo, 100.0 * r.ci_hi, r.p_value, verdict);
+        regressions += r.regression;
+        improvements += r.improvement;
+        few += b->samples.size() < 5 || c.samples.size() < 5;
+    }
+    for (const auto &b : base)
+    {
+        bool found = false;
+        for (const auto &c : cand)
+            found = found || c.name == b.name;
+        if (!found)
+            std::printf("%-28s %14.4g %14s %8s %19s %7s  %s\n", b.name.c_str(), hl::median_of(b.samples), "-", "", "",
+                        "", "missing");
+    }
+
+    std::printf("\n%d regression(s), %d improvement(s) beyond %.1f%% (%s test)\n", regressions, improvements,
+                100.0 * o.cmp.threshold, o.cmp.test == hl::BenchTest::Bootstrap ? "bootstrap" : "Mann-Whitney");
+    if (few)
+        std::printf("note: %d case(s) have fewer than 5 repetitions; significance is unreliable\n", few);
+    return regressions ? 1 : 0;
+}
@@ -0,0 +1,249 @@
+// Out-of-core "continent" arena runner.
+//
+// Simulates a split arena stored in a memory-mapped file, drawing pairs only
+// from active tiles, and prints a profiler report (phase times, throughput,
+// tile activity and paging, plus hardware counters with --counters) every
+// --report-every ticks.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "core/MappedArena.h"
+#include "util/Profiler.h"
+
+namespace
+{
+    struct Options
+    {
+        std::string file{"continent.arena"};
+        bool resume{false};
+        int width{16384};
+        int height{16384};
+        int ticks{300};
+        double pairs_per_cell{0.25}; // 240 pairs / 960 cells on the 40x24 board
+        int report_every{50};
+        uint64_t seed{1};
+        std::string activity_pgm;
+        bool counters{false};
+    };
+
+    void usage()
+    {
+        std::fprintf(stderr,
+                     "usage: handlords_continent [options]\n"
+                     "  --file PATH            arena file (default continent.arena)\n"
+                     "  --resume               continue an existing arena file\n"
+                     "  --size WxH             new arena size, multiples of %d (default 16384x16384)\n"
+                     "  --ticks N              ticks to run (default 300)\n"
+                     "  --pairs-per-cell F     pair draws per cell per tick (default 0.25)\n"
+                     "  --report-every N       profiler report interval in ticks (default 50)\n"
+                     "  --seed S               RNG seed (default 1)\n"
+                     "  --activity-pgm PATH    write the final tile activity map as a PGM image\n"
+                     "  --counters             add hardware counters per phase to the reports\n",
+                     hl::MappedArena::TILE);
+    }
+
+    bool parse_args(int argc, char **argv, Options &o)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char *arg = argv[i];
+            if (!std::strcmp(arg, "--resume"))
+            {
+                o.resume = true;
+                continue;
+            }
+            if (!std::strcmp(arg, "--counters"))
+            {
+                o.counters = true;
+                continue;
+            }
+            if (i + 1 >= argc)
+                return false;
+            const char *val = argv[++i];
+            if (!std::strcmp(arg, "--file"))
+                o.file = val;
+            else if (!std::strcmp(arg, "--size"))
+            {
+                if (std::sscanf(val, "%dx%d", &o.width, &o.height) != 2)
+                    return false;
+            }
+            else if (!std::strcmp(arg, "--ticks"))
+                o.ticks = std::atoi(val);
+            else if (!std::strcmp(arg, "--pairs-per-cell"))
+                o.pairs_per_cell = std::atof(val);
+            else if (!std::strcmp(arg, "--report-every"))
+                o.report_every = std::atoi(val);
+            else if (!std::strcmp(arg, "--seed"))
+                o.seed = std::strtoull(val, nullptr, 0);
+            else if (!std::strcmp(arg, "--activity-pgm"))
+                o.activity_pgm = val;
+            else
+                return false;
+        }
+        return o.ticks > 0 && o.pairs_per_cell > 0.0 && o.report_every > 0;
+    }
+
+    // Albert's schedule for each side, on the arena's 64-bit RNG
+    struct Rotator
+    {
+        hl::AlbertConfig cfg{};
+        int next_tick{0};
+
+        void schedule(int tick, hl::Rng64 &rng)
+        {
+            const int lo = std::max(1, cfg.rotation_average - cfg.rotation_half_interval);
+            const int hi = cfg.rotation_average + cfg.rotation_half_interval;
+            next_tick = tick + lo + static_cast<int>(hl::Rng64::scale(rng.next(), hi - lo + 1));
+        }
+    };
+
+    long resident_set_kb()
+    {
+        long pages = 0, rss = 0;
+        std::FILE *f = std::fopen("/proc/self/statm", "r");
+        if (!f)
+            return 0;
+        if (std::fscanf(f, "%ld %ld", &pages, &rss) != 2)
+            rss = 0;
+        std::fclose(f);
+        return rss * (sysconf(_SC_PAGESIZE) / 1024);
+    }
+
+    void write_pgm(const std::string &path, const hl::ActivityMap &act)
+    {
+        std::FILE *f = std::fopen(path.c_str(), "wb");
+        if (!f)
+        {
+            std::fprintf(stderr, "cannot write %s\n", path.c_str());
+            return;
+        }
+        std::fprintf(f, "P5\n%d %d\n255\n", act.tiles_x(), act.tiles_y());
+        for (int t = 0; t < act.tile_count(); ++t)
+            std::fputc(act.active(t) ? 255 : 0, f);
+        std::fclose(f);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options o;
+    if (!parse_args(argc, argv, o))
+    {
+        usage();
+        return 2;
+    }
+
+    hl::Profiler prof;
+    std::string err;
+    if (o.counters && !prof.enable_hw_counters(err))
+        std::printf("hw counters unavailable (%s), timing only\n", err.c_str());
+    const int ph_open = prof.phase("open");
+    const int ph_pairs = prof.phase("pairs");
+    const int ph_evict = prof.phase("evict");
+    const int ph_ai = prof.phase("ai");
+
+    hl::MappedArena arena;
+    {
+        hl::Profiler::Scope s(prof, ph_open);
+        const bool ok = o.resume ? arena.open(o.file, err) : arena.create(o.file, o.width, o.height, err);
+        if (!ok)
+        {
+            std::fprintf(stderr, "handlords_continent: %s\n", err.c_str());
+            return 1;
+        }
+    }
+    prof.end_tick();
+
+    const double cells = static_cast<double>(arena.width()) * arena.height();
+    const long long pairs_per_tick = static_cast<long long>(cells * o.pairs_per_cell);
+    std::printf("handlords_continent: %dx%d arena, %.1f MB file, %d tiles, %lld pair draws/tick\n",
+                arena.width(), arena.height(), arena.paging_stats().mapped_bytes / 1048576.0,
+                arena.activity().tile_count(), pairs_per_tick);
+
+    hl::Rng64 rng{o.seed};
+    std::vector<uint32_t> losses(2, 0);
+    Rotator rot[2];
+    rot[0].schedule(0, rng);
+    rot[1].schedule(0, rng);
+
+    long long resolved = 0, resolved_window = 0;
+    rusage ru0{};
+    getrusage(RUSAGE_SELF, &ru0);
+    auto window_start = hl::Profiler::clock::now();
+
+    for (int tick = 1; tick <= o.ticks; ++tick)
+    {
+        {
+            hl::Profiler::Scope s(prof, ph_pairs);
+            const long long n = arena.resolve_pairs(rng, pairs_per_tick, losses);
+            resolved += n;
+            resolved_window += n;
+        }
+        {
+            hl::Profiler::Scope s(prof, ph_evict);
+            arena.evict_quiescent();
+        }
+        {
+            // Rotation only changes the owner's piece, never a cell code
+            hl::Profiler::Scope s(prof, ph_ai);
+            for (int p = 0; p < 2; ++p)
+            {
+                if (tick >= rot[p].next_tick)
+                {
+                    arena.pieces[p] = static_cast<hl::Piece>((static_cast<int>(arena.pieces[p]) + 1) % 3);
+                    rot[p].schedule(tick, rng);
+                }
+            }
+        }
+        prof.end_tick();
+
+        if (tick % o.report_every == 0 || tick == o.ticks)
+        {
+            const double secs = std::chrono::duration<double>(hl::Profiler::clock::now() - window_start).count();
+            const int window_ticks = tick % o.report_every ? tick % o.report_every : o.report_every;
+            rusage ru{};
+            getrusage(RUSAGE_SELF, &ru);
+            const auto ps = arena.paging_stats();
+            uint64_t census[2];
+            arena.census(census, 2);
+
+            prof.set_counter("ticks/s", window_ticks / secs);
+            prof.set_counter("draws/s (full-arena)", window_ticks * static_cast<double>(pairs_per_tick) / secs);
+            prof.set_counter("resolved pairs/s", resolved_window / secs);
+            prof.set_counter("active tiles", arena.activity().active_count());
+            prof.set_counter("active fraction", 100.0 * arena.activity().active_count() / arena.activity().tile_count(), "%");
+            prof.set_counter("evicted tiles", ps.evicted_tiles);
+            prof.set_counter("evictions (total)", static_cast<double>(ps.evictions));
+            prof.set_counter("reloads (total)", static_cast<double>(ps.reloads));
+            prof.set_counter("page cache resident", ps.resident_bytes / 1048576.0, "MB");
+            prof.set_counter("process RSS", resident_set_kb() / 1024.0, "MB");
+            prof.set_counter("minor faults", static_cast<double>(ru.ru_minflt - ru0.ru_minflt));
+            prof.set_counter("major faults", static_cast<double>(ru.ru_majflt - ru0.ru_majflt));
+            prof.set_counter("player 0 cells", static_cast<double>(census[0]));
+            prof.set_counter("player 1 cells", static_cast<double>(census[1]));
+
+            std::printf("\n--- tick %d ---\n", tick);
+            prof.report(stdout);
+            std::fflush(stdout);
+
+            ru0 = ru;
+            resolved_window = 0;
+            window_start = hl::Profiler::clock::now();
+        }
+    }
+
+    std::printf("\nresolved %lld pairs for %lld draws (%.3f%% of draws hit a live edge)\n", resolved,
+                pairs_per_tick * o.ticks, 100.0 * resolved / (static_cast<double>(pairs_per_tick) * o.ticks));
+    if (!o.activity_pgm.empty())
+        write_pgm(o.activity_pgm, arena.activity());
+    arena.close();
+    return 0;
+}
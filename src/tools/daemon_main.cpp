@@ -0,0 +1,794 @@
+// Local simulation daemon.
+//
+// Owns one worker pool and runs jobs submitted over a Unix domain socket, so
+// several sweeps, tournaments and replay renders can share the machine
+// without each tool spawning threads for every core. The protocol is one
+// command per line; every reply line starts with a keyword:
+//
+//   submit sweep [priority=P] [weight=W] [detach=1] a=LO:HI:STEP:HALF
+//                [b=AVG:HALF] [games=N] [chunk=N] [level=L] [seed=S] [max_ticks=M]
+//   submit tournament [priority=P] ai=NAME=SPEC ai=... [levels=L,L]
+//                [seed=S] [max_games=N] [max_seconds=S] [target_ci=E]
+//   submit render [priority=P] out=DIR [a=AVG:HALF] [b=AVG:HALF] [level=L]
+//                [seed=S] [every=K] [scale=N] [max_ticks=M]
+//   cancel ID | status | metrics | shutdown
+//
+//   ok id=ID                    job accepted
+//   progress id=ID ...          streamed while it runs
+//   result id=ID ...            one or more lines at the end
+//   done id=ID status=finished|cancelled
+//   job id=ID ... / ok jobs=N   status listing
+//   OpenMetrics text, # EOF, ok  metrics
+//   error MESSAGE
+//
+// Progress and results go to the connection that submitted the job. A job is
+// cancelled when that connection closes, unless submitted with detach=1.
+// Higher priorities run first; jobs of equal priority share the workers in
+// proportion to their weight. Sweeps are split into chunks of games, so they
+// interleave finely; a tournament or render is one task and holds one worker
+// until it finishes or is cancelled.
+//
+// handlordsd --client [--socket PATH] COMMAND... sends one command and prints
+// the replies until its job is done (Ctrl-C cancels it).
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "levels/Levels.h"
+#include "sim/JobScheduler.h"
+#include "sim/Tournament.h"
+#include "util/Metrics.h"
+
+namespace
+{
+    volatile std::sig_atomic_t g_signal = 0;
+
+    void on_signal(int sig) { g_signal = sig; }
+
+    void usage()
+    {
+        std::fprintf(stderr,
+                     "usage: handlordsd [--socket PATH] [--threads T] [--metrics-file PATH [--metrics-every S]]\n"
+                     "       handlordsd --client [--socket PATH] COMMAND...\n"
+                     "  --socket PATH        Unix socket (default /tmp/handlordsd.sock)\n"
+                     "  --threads T          worker threads (default: all cores)\n"
+                     "  --metrics-file PATH  also rewrite the metrics to PATH every S seconds (default 5)\n"
+                     "commands: submit sweep|tournament|render KEY=VALUE..., cancel ID, status, metrics, shutdown\n");
+    }
+
+    std::string format(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+    std::string format(const char *fmt, ...)
+    {
+        char buf[512];
+        va_list ap;
+        va_start(ap, fmt);
+        std::vsnprintf(buf, sizeof(buf), fmt, ap);
+        va_end(ap);
+        return buf;
+    }
+
+    bool write_all(int fd, const std::string &s)
+    {
+        size_t off = 0;
+        while (off < s.size())
+        {
+            ssize_t n = ::send(fd, s.data() + off, s.size() - off, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                return false;
+            off += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    // Buffered line reader; false at end of stream
+    struct LineReader
+    {
+        int fd{-1};
+        std::string buf;
+
+        bool next(std::string &line)
+        {
+            for (;;)
+            {
+                size_t nl = buf.find('\n');
+                if (nl != std::string::npos)
+                {
+                    line = buf.substr(0, nl);
+                    buf.erase(0, nl + 1);
+                    if (!line.empty() && line.back() == '\r')
+                        line.pop_back();
+                    return true;
+                }
+                char chunk[1024];
+                ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                    return false;
+                buf.append(chunk, static_cast<size_t>(n));
+            }
+        }
+    };
+
+    bool make_address(const std::string &path, sockaddr_un &addr)
+    {
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(addr.sun_path))
+            return false;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        return true;
+    }
+
+    // ----------------- Requests -----------------
+    struct Request
+    {
+        std::vector<std::string> words;                        // bare words, in order
+        std::vector<std::pair<std::string, std::string>> args; // KEY=VALUE, in order
+
+        const char *get(const char *key) const
+        {
+            for (const auto &a : args)
+            {
+                if (a.first == key)
+                    return a.second.c_str();
+            }
+            return nullptr;
+        }
+        long num(const char *key, long def) const
+        {
+            const char *v = get(key);
+            return v ? std::strtol(v, nullptr, 0) : def;
+        }
+        double real(const char *key, double def) const
+        {
+            const char *v = get(key);
+            return v ? std::atof(v) : def;
+        }
+    };
+
+    Request parse_request(const std::string &line)
+    {
+        Request r;
+        size_t i = 0;
+        while (i < line.size())
+        {
+            while (i < line.size() && (line[i] == ' ' || line[i] == '\t'))
+                ++i;
+            size_t j = i;
+            while (j < line.size() && line[j] != ' ' && line[j] != '\t')
+                ++j;
+            if (j > i)
+            {
+                std::string w = line.substr(i, j - i);
+                size_t eq = w.find('=');
+                if (eq != std::string::npos && eq > 0)
+                    r.args.emplace_back(w.substr(0, eq), w.substr(eq + 1));
+                else
+                    r.words.push_back(w);
+            }
+            i = j;
+        }
+        return r;
+    }
+
+    bool parse_albert(const char *s, hl::AlbertConfig &out)
+    {
+        int avg = 0, half = 0;
+        if (!s || std::sscanf(s, "%d:%d", &avg, &half) != 2 || avg <= 0 || half < 0)
+            return false;
+        out.rotation_average = avg;
+        out.rotation_half_interval = half;
+        return true;
+    }
+
+    // ----------------- Connections -----------------
+    // One client. Job callbacks hold a reference and write through it from
+    // worker threads, so writes are serialized and fail quietly once closed.
+    struct Connection
+    {
+        int fd{-1};
+        std::mutex write_mutex;
+        std::vector<int> owned; // jobs cancelled when the client goes away
+        hl::MetricsWindow metrics; // rates since this client's previous `metrics`
+
+        ~Connection()
+        {
+            if (fd >= 0)
+                ::close(fd);
+        }
+
+        void send(const std::string &line)
+        {
+            std::lock_guard<std::mutex> lock(write_mutex);
+            write_all(fd, line + "\n");
+        }
+    };
+
+    using ConnPtr = std::shared_ptr<Connection>;
+
+    // ----------------- Jobs -----------------
+    struct Sweep
+    {
+        std::vector<hl::AlbertConfig> configs;
+        hl::SideConfig opponent{};
+        int games{0};
+        int chunk{0};
+        int chunks{0}; // per config
+        int level{1};
+        uint64_t seed{1};
+        int max_ticks{6000};
+
+        std::mutex mutex;
+        std::vector<int> wins, losses, draws;
+        int tasks_done{0};
+    };
+
+    std::shared_ptr<hl::SimJob> make_sweep(const Request &r, const ConnPtr &conn, std::string &err)
+    {
+        auto sw = std::make_shared<Sweep>();
+        int lo = 0, hi = 0, step = 0, half = 0;
+        const char *a = r.get("a");
+        if (!a || std::sscanf(a, "%d:%d:%d:%d", &lo, &hi, &step, &half) != 4 || lo <= 0 || hi < lo ||
+            step <= 0 || half < 0)
+        {
+            err = "sweep needs a=LO:HI:STEP:HALF";
+            return nullptr;
+        }
+        for (int avg = lo; avg <= hi; avg += step)
+        {
+            hl::AlbertConfig c;
+            c.rotation_average = avg;
+            c.rotation_half_interval = half;
+            sw->configs.push_back(c);
+        }
+        if (r.get("b") && !parse_albert(r.get("b"), sw->opponent.albert))
+        {
+            err = "bad b=AVG:HALF";
+            return nullptr;
+        }
+        sw->games = static_cast<int>(r.num("games", 200));
+        sw->chunk = static_cast<int>(r.num("chunk", 25));
+        sw->level = static_cast<int>(r.num("level", 1));
+        sw->seed = static_cast<uint64_t>(r.num("seed", 1));
+        sw->max_ticks = static_cast<int>(r.num("max_ticks", 6000));
+        if (sw->games <= 0 || sw->chunk <= 0 || sw->level < 1 || sw->level > LEVEL_COUNT ||
+            sw->max_ticks <= 0 || sw->max_ticks >= 65000)
+        {
+            err = "bad games, chunk, level or max_ticks";
+            return nullptr;
+        }
+        sw->chunks = (sw->games + sw->chunk - 1) / sw->chunk;
+        const size_t n = sw->configs.size();
+        sw->wins.assign(n, 0);
+        sw->losses.assign(n, 0);
+        sw->draws.assign(n, 0);
+
+        auto job = std::make_shared<hl::SimJob>();
+        job->kind = "sweep";
+        job->tasks = static_cast<int>(n) * sw->chunks;
+        hl::SimJob *self = job.get();
+        job->run = [sw, conn, self](int task)
+        {
+            const int ci = task / sw->chunks;
+            const int g0 = (task % sw->chunks) * sw->chunk;
+            const int g1 = std::min(sw->games, g0 + sw->chunk);
+            int w = 0, l = 0, d = 0;
+            for (int g = g0; g < g1 && !self->cancelled; ++g)
+            {
+                // Every config meets the same seeds (common random numbers)
+                hl::MatchSpec spec;
+                spec.left.albert = sw->configs[ci];
+                spec.right = sw->opponent;
+                spec.level = sw->level;
+                spec.seed = sw->seed + static_cast<uint64_t>(g);
+                spec.max_ticks = sw->max_ticks;
+                const hl::MatchResult res = hl::run_match(spec);
+                (res.winner == 0 ? w : res.winner == 1 ? l : d)++;
+            }
+            int done;
+            {
+                std::lock_guard<std::mutex> lock(sw->mutex);
+                sw->wins[ci] += w;
+                sw->losses[ci] += l;
+                sw->draws[ci] += d;
+                done = ++sw->tasks_done;
+            }
+            conn->send(format("progress id=%d done=%d total=%d", self->id, done, self->tasks));
+        };
+        job->finish = [sw, conn, self](bool cancelled)
+        {
+            for (size_t i = 0; i < sw->configs.size(); ++i)
+            {
+                const int played = sw->wins[i] + sw->losses[i] + sw->draws[i];
+                if (!played)
+                    continue;
+                conn->send(format("result id=%d a=%d:%d games=%d wins=%d losses=%d draws=%d win_rate=%.4f",
+                                  self->id, sw->configs[i].rotation_average,
+                                  sw->configs[i].rotation_half_interval, played, sw->wins[i], sw->losses[i],
+                                  sw->draws[i], (sw->wins[i] + 0.5 * sw->draws[i]) / played));
+            }
+            conn->send(format("done id=%d status=%s", self->id, cancelled ? "cancelled" : "finished"));
+        };
+        return job;
+    }
+
+    std::shared_ptr<hl::SimJob> make_tournament(const Request &r, const ConnPtr &conn, std::string &err)
+    {
+        auto cfg = std::make_shared<hl::TournamentConfig>();
+        for (const auto &a : r.args)
+        {
+            if (a.first != "ai")
+                continue;
+            size_t eq = a.second.find('=');
+            hl::Entrant e;
+            if (eq == std::string::npos || eq == 0 || !hl::parse_side(a.second.substr(eq + 1), e.side))
+            {
+                err = "bad ai=NAME=SPEC";
+                return nullptr;
+            }
+            e.name = a.second.substr(0, eq);
+            cfg->entrants.push_back(e);
+        }
+        if (cfg->entrants.empty())
+            cfg->entrants = hl::default_entrants();
+        if (cfg->entrants.size() < 2)
+        {
+            err = "a tournament needs two entrants";
+            return nullptr;
+        }
+        if (const char *lv = r.get("levels"))
+        {
+            cfg->levels.clear();
+            for (const char *s = lv; *s;)
+            {
+                char *end = nullptr;
+                long v = std::strtol(s, &end, 10);
+                if (end == s || v < 1 || v > LEVEL_COUNT)
+                {
+                    err = "bad levels=L,L";
+                    return nullptr;
+                }
+                cfg->levels.push_back(static_cast<int>(v));
+                s = *end == ',' ? end + 1 : end;
+            }
+        }
+        cfg->seed = static_cast<uint64_t>(r.num("seed", 1));
+        cfg->max_games = static_cast<int>(r.num("max_games", cfg->max_games));
+        cfg->max_seconds = r.real("max_seconds", cfg->max_seconds);
+        cfg->target_ci = r.real("target_ci", cfg->target_ci);
+        cfg->initial_pairs = static_cast<int>(r.num("initial_pairs", cfg->initial_pairs));
+        cfg->round_pairs = static_cast<int>(r.num("round_pairs", cfg->round_pairs));
+        // The daemon's pool is the parallelism; the tournament runs inline
+        cfg->threads = 1;
+        if (cfg->max_games <= 0 || cfg->initial_pairs <= 0)
+        {
+            err = "bad max_games or initial_pairs";
+            return nullptr;
+        }
+
+        auto job = std::make_shared<hl::SimJob>();
+        job->kind = "tournament";
+        job->tasks = 1;
+        hl::SimJob *self = job.get();
+        cfg->cancel = &job->cancelled;
+        auto report = std::make_shared<hl::TournamentReport>();
+        job->run = [cfg, conn, self, report](int)
+        {
+            auto on_round = [&](const hl::TournamentProgress &p)
+            {
+                conn->send(format("progress id=%d round=%d games=%d max_ci=%.1f", self->id, p.round, p.games,
+                                  p.max_ci));
+            };
+            *report = hl::run_tournament(*cfg, on_round);
+        };
+        job->finish = [cfg, conn, self, report](bool cancelled)
+        {
+            const size_t n = report->ratings.elo.size();
+            std::vector<size_t> order(n);
+            for (size_t i = 0; i < n; ++i)
+                order[i] = i;
+            std::sort(order.begin(), order.end(), [&](size_t x, size_t y)
+                      { return report->ratings.elo[x] > report->ratings.elo[y]; });
+            for (size_t i : order)
+                conn->send(format("result id=%d entrant=%s elo=%.1f ci=%.1f", self->id,
+                                  cfg->entrants[i].name.c_str(), report->ratings.elo[i],
+                                  report->ratings.elo_ci[i]));
+            if (n)
+                conn->send(format("result id=%d games=%d seconds=%.1f converged=%d", self->id, report->games,
+                                  report->seconds, report->converged ? 1 : 0));
+            conn->send(format("done id=%d status=%s", self->id, cancelled ? "cancelled" : "finished"));
+        };
+        return job;
+    }
+
+    // Same palette as the GUI arena
+    bool write_frame(const std::string &path, const hl::GameState &gs, int scale)
+    {
+        static const uint8_t players[4][3] = {{80, 200, 120}, {220, 80, 80}, {80, 120, 220}, {220, 200, 80}};
+        static const uint8_t wall[3] = {80, 80, 80};
+        static const uint8_t empty[3] = {25, 25, 28};
+
+        std::FILE *f = std::fopen(path.c_str(), "wb");
+        if (!f)
+            return false;
+        const int w = hl::ARENA_W * scale, h = hl::ARENA_H * scale;
+        std::fprintf(f, "P6\n%d %d\n255\n", w, h);
+        std::vector<uint8_t> row(static_cast<size_t>(w) * 3);
+        for (int y = 0; y < h; ++y)
+        {
+            for (int x = 0; x < w; ++x)
+            {
+                const hl::Cell &c = gs.grid.at(x / scale, y / scale);
+                // One-pixel gap between cells once they are big enough
+                const bool gap = scale >= 3 && (x % scale == scale - 1 || y % scale == scale - 1);
+                const uint8_t *col = empty;
+                if (!gap && c.kind == hl::CellKind::Wall)
+                    col = wall;
+                else if (!gap && c.kind == hl::CellKind::Symbol)
+                    col = players[c.owner.v % 4];
+                std::memcpy(&row[static_cast<size_t>(x) * 3], col, 3);
+            }
+            std::fwrite(row.data(), 1, row.size(), f);
+        }
+        return std::fclose(f) == 0;
+    }
+
+    std::shared_ptr<hl::SimJob> make_render(const Request &r, const ConnPtr &conn, std::string &err)
+    {
+        const char *out = r.get("out");
+        auto spec = std::make_shared<hl::MatchSpec>();
+        if (!out || !*out)
+        {
+            err = "render needs out=DIR";
+            return nullptr;
+        }
+        if ((r.get("a") && !parse_albert(r.get("a"), spec->left.albert)) ||
+            (r.get("b") && !parse_albert(r.get("b"), spec->right.albert)))
+        {
+            err = "bad a=AVG:HALF or b=AVG:HALF";
+            return nullptr;
+        }
+        spec->level = static_cast<int>(r.num("level", 1));
+        spec->seed = static_cast<uint64_t>(r.num("seed", 1));
+        spec->max_ticks = static_cast<int>(r.num("max_ticks", 6000));
+        const int every = static_cast<int>(r.num("every", 15));
+        const int scale = static_cast<int>(r.num("scale", 2));
+        if (spec->level < 1 || spec->level > LEVEL_COUNT || spec->max_ticks <= 0 || spec->max_ticks >= 65000 ||
+            every <= 0 || scale <= 0 || scale > 16)
+        {
+            err = "bad level, max_ticks, every or scale";
+            return nullptr;
+        }
+        if (::mkdir(out, 0777) != 0 && errno != EEXIST)
+        {
+            err = std::string("cannot create ") + out + ": " + std::strerror(errno);
+            return nullptr;
+        }
+
+        auto job = std::make_shared<hl::SimJob>();
+        job->kind = "render";
+        job->tasks = 1;
+        hl::SimJob *self = job.get();
+        const std::string dir = out;
+        auto frames = std::make_shared<int>(0);
+        auto result = std::make_shared<hl::MatchResult>();
+        job->run = [spec, conn, self, dir, every, scale, frames, result](int)
+        {
+            hl::MatchSpec s = *spec;
+            bool ok = true;
+            s.on_tick = [&](const hl::GameState &gs)
+            {
+                if (self->cancelled)
+                    return false;
+                if (gs.tick % every != 0 && gs.phase == hl::Phase::Playing)
+                    return true;
+                const std::string path = dir + format("/frame_%05d.ppm", *frames);
+                if (!write_frame(path, gs, scale))
+                {
+                    conn->send("error cannot write " + path);
+                    ok = false;
+                    return false;
+                }
+                ++*frames;
+                conn->send(format("progress id=%d frame=%d tick=%d", self->id, *frames, gs.tick));
+                return true;
+            };
+            *result = hl::run_match(s);
+            if (!ok)
+                self->cancelled = true;
+        };
+        job->finish = [conn, self, dir, frames, result](bool cancelled)
+        {
+            conn->send(format("result id=%d frames=%d ticks=%d winner=%d dir=%s", self->id, *frames,
+                              result->ticks, result->winner, dir.c_str()));
+            conn->send(format("done id=%d status=%s", self->id, cancelled ? "cancelled" : "finished"));
+        };
+        return job;
+    }
+
+    // ----------------- Server -----------------
+    struct Server
+    {
+        explicit Server(hl::JobScheduler &s) : sched(s) {}
+
+        hl::JobScheduler &sched;
+        std::atomic<bool> stop{false};
+        std::mutex conns_mutex;
+        std::condition_variable conns_cv;
+        std::list<ConnPtr> conns; // one handler thread each
+
+        void handle(const ConnPtr &conn, const std::string &line)
+        {
+            const Request r = parse_request(line);
+            const std::string verb = r.words.empty() ? "" : r.words[0];
+            if (verb == "submit")
+            {
+                const std::string kind = r.words.size() > 1 ? r.words[1] : "";
+                std::string err;
+                std::shared_ptr<hl::SimJob> job;
+                if (kind == "sweep")
+                    job = make_sweep(r, conn, err);
+                else if (kind == "tournament")
+                    job = make_tournament(r, conn, err);
+                else if (kind == "render")
+                    job = make_render(r, conn, err);
+                else
+                    err = "unknown job kind '" + kind + "' (sweep, tournament, render)";
+                if (!job)
+                {
+                    conn->send("error " + err);
+                    return;
+                }
+                job->priority = static_cast<int>(r.num("priority", 0));
+                job->weight = std::max(0.01, r.real("weight", 1.0));
+                // Reply before any progress can be streamed
+                std::lock_guard<std::mutex> lock(conn->write_mutex);
+                const int id = stop ? 0 : sched.submit(job);
+                if (!id)
+                {
+                    write_all(conn->fd, "error shutting down\n");
+                    return;
+                }
+                if (!r.num("detach", 0))
+                    conn->owned.push_back(id);
+                write_all(conn->fd, format("ok id=%d\n", id));
+            }
+            else if (verb == "cancel" && r.words.size() == 2)
+            {
+                const int id = std::atoi(r.words[1].c_str());
+                conn->send(sched.cancel(id) ? format("ok id=%d", id) : format("error no job %d", id));
+            }
+            else if (verb == "status")
+            {
+                const auto jobs = sched.status();
+                for (const auto &j : jobs)
+                    conn->send(format("job id=%d kind=%s priority=%d tasks=%d done=%d running=%d cpu=%.2f%s",
+                                      j.id, j.kind.c_str(), j.priority, j.tasks, j.done, j.running,
+                                      j.cpu_seconds, j.cancelled ? " cancelled" : ""));
+                conn->send(format("ok jobs=%zu threads=%d", jobs.size(), sched.threads()));
+            }
+            else if (verb == "metrics")
+            {
+                std::lock_guard<std::mutex> lock(conn->write_mutex);
+                write_all(conn->fd, hl::Metrics::instance().exposition(conn->metrics) + "ok\n");
+            }
+            else if (verb == "shutdown")
+            {
+                conn->send("ok");
+                stop = true;
+            }
+            else
+                conn->send("error unknown command '" + line + "'");
+        }
+
+        void serve(ConnPtr conn)
+        {
+            LineReader in{conn->fd, {}};
+            std::string line;
+            while (!stop && in.next(line))
+            {
+                if (!line.empty())
+                    handle(conn, line);
+            }
+            // The client is gone: its attached jobs go with it. The socket
+            // closes once their callbacks have dropped the connection too.
+            for (int id : conn->owned)
+                sched.cancel(id);
+            ::shutdown(conn->fd, SHUT_RDWR);
+            std::lock_guard<std::mutex> lock(conns_mutex);
+            conns.remove(conn);
+            conns_cv.notify_all();
+        }
+    };
+
+    int run_daemon(const std::string &path, int threads, const std::string &metrics_file, double metrics_every)
+    {
+        sockaddr_un addr;
+        if (!make_address(path, addr))
+        {
+            std::fprintf(stderr, "socket path too long: %s\n", path.c_str());
+            return 1;
+        }
+        int lfd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (lfd < 0)
+        {
+            std::perror("socket");
+            return 1;
+        }
+        // A socket file nobody answers on is left over from a crash
+        int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (::connect(probe, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0)
+        {
+            std::fprintf(stderr, "handlordsd already running on %s\n", path.c_str());
+            ::close(probe);
+            ::close(lfd);
+            return 1;
+        }
+        ::close(probe);
+        ::unlink(path.c_str());
+        if (::bind(lfd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || ::listen(lfd, 16) != 0)
+        {
+            std::fprintf(stderr, "cannot listen on %s: %s\n", path.c_str(), std::strerror(errno));
+            ::close(lfd);
+            return 1;
+        }
+
+        std::signal(SIGINT, on_signal);
+        std::signal(SIGTERM, on_signal);
+        std::signal(SIGPIPE, SIG_IGN);
+
+        hl::JobScheduler sched(threads > 0 ? threads
+                                           : static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+        Server server(sched);
+        hl::MetricGauge depth("handlords_queue_depth", "Work items waiting in pool queues.",
+                              [&] { return static_cast<double>(sched.queued()); });
+        hl::MetricGauge jobs("handlords_jobs", "Daemon jobs queued or running.",
+                             [&] { return static_cast<double>(sched.active()); });
+        hl::MetricsFileWriter metrics;
+        std::string err;
+        if (!metrics_file.empty() && !metrics.start(metrics_file, metrics_every, err))
+            std::fprintf(stderr, "handlordsd: %s\n", err.c_str());
+        std::printf("handlordsd: %d worker(s) on %s\n", sched.threads(), path.c_str());
+        std::fflush(stdout);
+
+        while (!server.stop && !g_signal)
+        {
+            pollfd p{lfd, POLLIN, 0};
+            if (::poll(&p, 1, 200) <= 0)
+                continue;
+            int fd = ::accept(lfd, nullptr, nullptr);
+            if (fd < 0)
+                continue;
+            auto conn = std::make_shared<Connection>();
+            conn->fd = fd;
+            {
+                std::lock_guard<std::mutex> lock(server.conns_mutex);
+                server.conns.push_back(conn);
+            }
+            std::thread([&server, conn] { server.serve(conn); }).detach();
+        }
+
+        std::printf("handlordsd: shutting down (%d job(s) cancelled)\n", sched.active());
+        ::close(lfd);
+        ::unlink(path.c_str());
+        server.stop = true;
+        // Cancelled jobs still report "done" to their clients before those are cut off
+        sched.shutdown();
+        std::unique_lock<std::mutex> lock(server.conns_mutex);
+        for (const auto &c : server.conns)
+            ::shutdown(c->fd, SHUT_RDWR);
+        server.conns_cv.wait(lock, [&] { return server.conns.empty(); });
+        return 0;
+    }
+
+    // ----------------- Client -----------------
+    int run_client(const std::string &path, const std::string &command)
+    {
+        sockaddr_un addr;
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || !make_address(path, addr) ||
+            ::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+        {
+            std::fprintf(stderr, "cannot connect to %s: %s\n", path.c_str(), std::strerror(errno));
+            return 1;
+        }
+        if (!write_all(fd, command + "\n"))
+            return 1;
+
+        // A submit ends with its job's "done" line, anything else with ok/error
+        const bool submit = command.compare(0, 6, "submit") == 0;
+        LineReader in{fd, {}};
+        std::string line;
+        bool accepted = false;
+        int rc = 1;
+        while (in.next(line))
+        {
+            std::printf("%s\n", line.c_str());
+            std::fflush(stdout);
+            if (line.compare(0, 3, "ok ") == 0)
+                accepted = true;
+            // Once a job is running its errors are reported, then it ends
+            if (line.compare(0, 5, "error") == 0 && !accepted)
+                break;
+            if (submit && line.compare(0, 5, "done ") == 0)
+            {
+                rc = line.find("status=finished") != std::string::npos ? 0 : 3;
+                break;
+            }
+            if (!submit && line.compare(0, 2, "ok") == 0)
+            {
+                rc = 0;
+                break;
+            }
+        }
+        ::close(fd);
+        return rc;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string path = "/tmp/handlordsd.sock";
+    int threads = 0;
+    std::string metrics_file;
+    double metrics_every = 5.0;
+    bool client = false;
+    std::string command;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *arg = argv[i];
+        if (!command.empty() || (client && arg[0] != '-'))
+        {
+            command += command.empty() ? "" : " ";
+            command += arg;
+        }
+        else if (!std::strcmp(arg, "--client"))
+            client = true;
+        else if (!std::strcmp(arg, "--socket") && i + 1 < argc)
+            path = argv[++i];
+        else if (!std::strcmp(arg, "--threads") && i + 1 < argc)
+            threads = std::atoi(argv[++i]);
+        else if (!std::strcmp(arg, "--metrics-file") && i + 1 < argc)
+            metrics_file = argv[++i];
+        else if (!std::strcmp(arg, "--metrics-every") && i + 1 < argc)
+            metrics_every = std::atof(argv[++i]);
+        else
+        {
+            usage();
+            return 2;
+        }
+    }
+    if (client)
+    {
+        if (command.empty())
+        {
+            usage();
+            return 2;
+        }
+        return run_client(path, command);
+    }
+    return run_daemon(path, threads, metrics_file, metrics_every);
+}
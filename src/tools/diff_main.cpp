@@ -0,0 +1,244 @@
+// Cross-engine differential tester and golden determinism corpus.
+//
+// Runs randomized boards through the reference rules and every candidate
+// engine in lockstep, shrinking the first divergence to a single pair, then
+// replays the golden corpus of scripted games and checks their final hashes.
+// Exits non-zero on any mismatch.
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "sim/Batch.h"
+#include "sim/Differential.h"
+#include "util/Rng.h"
+
+namespace
+{
+    struct Options
+    {
+        int cases{300};
+        uint64_t seed{1};
+        int ticks{150};
+        int pairs{240};
+        int threads{0};
+        bool inject_bug{false};
+        bool single{false}; // --case: rerun one case by seed
+        uint64_t case_seed{0};
+        int players{2};
+        std::string corpus{"data/golden.txt"};
+        bool skip_corpus{false};
+        std::string write_corpus;
+    };
+
+    void usage()
+    {
+        std::fprintf(stderr,
+                     "usage: handlords_diff [options]\n"
+                     "  --cases N             randomized lockstep cases (default 300, 0 = none)\n"
+                     "  --seed S              base seed for the cases (default 1)\n"
+                     "  --ticks T             ticks per case (default 150)\n"
+                     "  --pairs P             pairs per tick (default 240)\n"
+                     "  --threads T           worker threads (default: all cores)\n"
+                     "  --case SEED           run only the case with this seed (from a repro line)\n"
+                     "  --players N           players for --case (default 2)\n"
+                     "  --inject-bug          add a deliberately broken engine (self-check)\n"
+                     "  --corpus PATH         golden corpus to check (default data/golden.txt)\n"
+                     "  --skip-corpus         do not check the golden corpus\n"
+                     "  --write-corpus PATH   regenerate the corpus from this build and exit\n");
+    }
+
+    bool parse_args(int argc, char **argv, Options &o)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char *arg = argv[i];
+            if (!std::strcmp(arg, "--inject-bug"))
+            {
+                o.inject_bug = true;
+                continue;
+            }
+            if (!std::strcmp(arg, "--skip-corpus"))
+            {
+                o.skip_corpus = true;
+                continue;
+            }
+            if (i + 1 >= argc)
+                return false;
+            const char *val = argv[++i];
+            if (!std::strcmp(arg, "--cases"))
+                o.cases = std::atoi(val);
+            else if (!std::strcmp(arg, "--seed"))
+                o.seed = std::strtoull(val, nullptr, 0);
+            else if (!std::strcmp(arg, "--ticks"))
+                o.ticks = std::atoi(val);
+            else if (!std::strcmp(arg, "--pairs"))
+                o.pairs = std::atoi(val);
+            else if (!std::strcmp(arg, "--case"))
+            {
+                o.single = true;
+                o.cases = 1;
+                o.case_seed = std::strtoull(val, nullptr, 0);
+            }
+            else if (!std::strcmp(arg, "--players"))
+                o.players = std::atoi(val);
+            else if (!std::strcmp(arg, "--threads"))
+                o.threads = std::atoi(val);
+            else if (!std::strcmp(arg, "--corpus"))
+                o.corpus = val;
+            else if (!std::strcmp(arg, "--write-corpus"))
+                o.write_corpus = val;
+            else
+                return false;
+        }
+        return o.cases >= 0 && o.ticks > 0 && o.pairs > 0 && o.players >= 2 && o.players <= 14;
+    }
+
+    int write_corpus(const std::string &path)
+    {
+        std::ofstream out(path);
+        if (!out)
+        {
+            std::fprintf(stderr, "cannot write %s\n", path.c_str());
+            return 1;
+        }
+        out << "# Golden determinism corpus for handlords_diff: level-1 games vs Albert,\n"
+               "# player 0 rotating after the listed ticks. Regenerate with\n"
+               "# handlords_diff --write-corpus only when a rules or RNG change is intended.\n";
+        int n = 0;
+        for (auto e : hl::default_golden_entries())
+        {
+            e.hash = hl::run_golden(e);
+            out << hl::format_golden(e) << "\n";
+            n++;
+        }
+        std::printf("wrote %d entries to %s\n", n, path.c_str());
+        return 0;
+    }
+
+    // Returns the number of failing entries, or -1 if the corpus is unreadable
+    int check_corpus(const std::string &path)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            std::fprintf(stderr, "cannot read corpus %s (run from the repo root or pass --corpus)\n", path.c_str());
+            return -1;
+        }
+        std::string line, err;
+        int lineno = 0, entries = 0, failures = 0;
+        std::vector<hl::GoldenEntry> checked;
+        while (std::getline(in, line))
+        {
+            lineno++;
+            if (line.empty() || line[0] == '#')
+                continue;
+            hl::GoldenEntry e;
+            if (!hl::parse_golden(line, e, err))
+            {
+                std::fprintf(stderr, "%s:%d: %s\n", path.c_str(), lineno, err.c_str());
+                return -1;
+            }
+            entries++;
+            checked.push_back(e);
+            static const char *modes[] = {"sequential", "batched", "sliced"};
+            for (int m = 0; m < 3; ++m)
+            {
+                const uint64_t h = hl::run_golden(e, m == 1, m == 2);
+                if (h != e.hash)
+                {
+                    failures++;
+                    std::printf("  GOLDEN MISMATCH %s:%d (%s): got %016" PRIx64 "\n    %s\n", path.c_str(), lineno,
+                                modes[m], h, line.c_str());
+                    break;
+                }
+            }
+        }
+        std::printf("golden corpus: %d/%d entries match\n", entries - failures, entries);
+
+        // Async AI replays: the first entries at a few latencies
+        int async_runs = 0, async_failures = 0;
+        for (size_t i = 0; i < checked.size() && i < 4; ++i)
+        {
+            for (int latency : {1, 3})
+            {
+                std::string detail;
+                async_runs++;
+                if (!hl::check_async_replay(checked[i], latency, detail))
+                {
+                    async_failures++;
+                    std::printf("  ASYNC AI REPLAY MISMATCH (seed %" PRIu64 ") %s\n", checked[i].seed, detail.c_str());
+                }
+            }
+        }
+        std::printf("async AI replay: %d/%d runs match\n", async_runs - async_failures, async_runs);
+        return failures + async_failures;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options o;
+    if (!parse_args(argc, argv, o))
+    {
+        usage();
+        return 2;
+    }
+    if (!o.write_corpus.empty())
+        return write_corpus(o.write_corpus);
+
+    bool ok = true;
+    if (o.cases > 0)
+    {
+        std::vector<hl::DiffCase> cases(o.cases);
+        hl::Rng64 rng{o.seed};
+        for (auto &c : cases)
+        {
+            c.seed = rng.next();
+            c.players = 2 + static_cast<int>(hl::Rng64::scale(rng.next(), 3));
+            c.ticks = o.ticks;
+            c.pairs = o.pairs;
+        }
+        if (o.single)
+        {
+            cases[0].seed = o.case_seed;
+            cases[0].players = o.players;
+        }
+
+        std::vector<char> passed(cases.size(), 1);
+        std::vector<hl::Divergence> found(cases.size());
+        hl::parallel_for(static_cast<int>(cases.size()), o.threads, [&](int i)
+                         {
+                             auto engines = hl::make_candidate_engines(o.inject_bug);
+                             passed[i] = hl::run_diff_case(cases[i], engines, found[i]); });
+
+        int failures = 0;
+        for (size_t i = 0; i < cases.size(); ++i)
+        {
+            if (passed[i])
+                continue;
+            const auto &d = found[i];
+            if (failures++ < 5)
+            {
+                std::printf("  DIVERGENCE %s (case %zu)\n", d.engine.c_str(), i);
+                std::printf("    first differs at tick %d, %s\n", d.tick,
+                            d.pair >= 0 ? ("pair " + std::to_string(d.pair)).c_str() : "after pairs");
+                std::printf("    %s\n", d.detail.c_str());
+                std::printf("    rerun: handlords_diff --case 0x%016" PRIx64 " --players %d --pairs %d --ticks %d%s\n",
+                            d.repro.seed, d.repro.players, d.repro.pairs, d.repro.ticks,
+                            o.inject_bug ? " --inject-bug" : "");
+            }
+        }
+        std::printf("lockstep: %d/%d cases match (%d ticks x %d pairs)\n", o.cases - failures, o.cases, o.ticks,
+                    o.pairs);
+        ok = failures == 0;
+    }
+
+    if (!o.skip_corpus)
+        ok = check_corpus(o.corpus) == 0 && ok;
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+// Exact win probabilities for tiny arenas.
+//
+// Enumerates every reachable ownership pattern of a W x H interior (up to
+// 24 cells), merges the patterns equal under the board's symmetries, and
+// solves the chain of pair draws under a fixed rotation schedule (see
+// src/sim/MarkovSolver.h).
+//   --check N    also play N Monte Carlo games through resolve_cells and
+//                report how far they land from the exact answer
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "sim/MarkovSolver.h"
+#include "sim/Stats.h"
+
+namespace
+{
+    struct Options
+    {
+        hl::TinyArenaSpec spec{};
+        double tol{1e-12};
+        int max_sweeps{100000};
+        int threads{0};
+        int check{0};
+        uint64_t seed{1};
+    };
+
+    void usage()
+    {
+        std::fprintf(stderr,
+                     "usage: handlords_markov [options]\n"
+                     "  --size WxH          interior size, at most %d cells (default 4x4)\n"
+                     "  --pairs K           pair draws per tick (default 0.25 per arena cell)\n"
+                     "  --rot P0:P1         rotate every P0 / P1 ticks (default 3:4)\n"
+                     "  --offset O0:O1      first rotations after P - O ticks (default 0:0)\n"
+                     "  --tol E             stop when a sweep changes no value by more (default 1e-12)\n"
+                     "  --max-sweeps N      give up after N schedule periods (default 100000)\n"
+                     "  --threads T         workers for large state spaces (default: all cores)\n"
+                     "  --check N           compare against N Monte Carlo games\n"
+                     "  --seed S            Monte Carlo seed (default 1)\n",
+                     hl::TinyArenaChain::MAX_CELLS);
+    }
+
+    bool parse_args(int argc, char **argv, Options &o)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char *arg = argv[i];
+            if (i + 1 >= argc)
+                return false;
+            const char *val = argv[++i];
+            if (!std::strcmp(arg, "--size"))
+            {
+                if (std::sscanf(val, "%dx%d", &o.spec.width, &o.spec.height) != 2)
+                    return false;
+            }
+            else if (!std::strcmp(arg, "--pairs"))
+                o.spec.pairs_per_tick = std::atoi(val);
+            else if (!std::strcmp(arg, "--rot"))
+            {
+                if (std::sscanf(val, "%d:%d", &o.spec.period[0], &o.spec.period[1]) != 2)
+                    return false;
+            }
+            else if (!std::strcmp(arg, "--offset"))
+            {
+                if (std::sscanf(val, "%d:%d", &o.spec.offset[0], &o.spec.offset[1]) != 2)
+                    return false;
+            }
+            else if (!std::strcmp(arg, "--tol"))
+                o.tol = std::atof(val);
+            else if (!std::strcmp(arg, "--max-sweeps"))
+                o.max_sweeps = std::atoi(val);
+            else if (!std::strcmp(arg, "--threads"))
+                o.threads = std::atoi(val);
+            else if (!std::strcmp(arg, "--check"))
+                o.check = std::atoi(val);
+            else if (!std::strcmp(arg, "--seed"))
+                o.seed = std::strtoull(val, nullptr, 0);
+            else
+                return false;
+        }
+        return o.tol > 0.0 && o.max_sweeps > 0 && o.check >= 0 && o.spec.pairs_per_tick >= 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options o;
+    if (!parse_args(argc, argv, o))
+    {
+        usage();
+        return 2;
+    }
+
+    using clock = std::chrono::steady_clock;
+    const auto t0 = clock::now();
+    hl::TinyArenaChain chain;
+    std::string err;
+    if (!chain.build(o.spec, err))
+    {
+        std::fprintf(stderr, "handlords_markov: %s\n", err.c_str());
+        return 2;
+    }
+    const auto t1 = clock::now();
+    std::printf("handlords_markov: %dx%d interior, %d pairs/tick, rotations every %d:%d (offset %d:%d)\n",
+                o.spec.width, o.spec.height, chain.pairs_per_tick(), o.spec.period[0], o.spec.period[1],
+                o.spec.offset[0], o.spec.offset[1]);
+    std::printf("  states      %zu reachable (%d symmetries, 2^%d masks)\n", chain.states(), chain.symmetries(),
+                chain.cells());
+    std::printf("  schedule    %d-tick period\n", chain.phases());
+
+    const bool converged = chain.solve(o.tol, o.max_sweeps, o.threads);
+    const auto t2 = clock::now();
+    const uint32_t start = chain.start_mask();
+    std::printf("  solved      %d sweeps, residual %.2e%s\n", chain.sweeps(), chain.residual(),
+                converged ? "" : " (not converged)");
+    std::printf("  time        %.3f s enumerate, %.3f s solve\n",
+                std::chrono::duration<double>(t1 - t0).count(), std::chrono::duration<double>(t2 - t1).count());
+    std::printf("\n  P(left wins)    %.12f\n", chain.win_probability(start));
+    std::printf("  expected ticks  %.6f\n", chain.expected_ticks(start));
+
+    if (o.check > 0)
+    {
+        const int max_ticks = 1000000;
+        const hl::TinyArenaSample mc = hl::sample_tiny_arena(o.spec, o.check, o.seed, max_ticks, o.threads);
+        const double zw = mc.win_ci > 0.0 ? (mc.win - chain.win_probability(start)) / (mc.win_ci / hl::Z95) : 0.0;
+        const double zt = mc.ticks_ci > 0.0 ? (mc.ticks - chain.expected_ticks(start)) / (mc.ticks_ci / hl::Z95) : 0.0;
+        std::printf("\nMonte Carlo (%d games through resolve_cells):\n", o.check);
+        std::printf("  P(left wins)    %.4f +/- %.4f   z %+.2f\n", mc.win, mc.win_ci, zw);
+        std::printf("  expected ticks  %.2f +/- %.2f   z %+.2f\n", mc.ticks, mc.ticks_ci, zt);
+        if (mc.timeouts)
+            std::printf("  %d games hit %d ticks\n", mc.timeouts, max_ticks);
+        if (std::abs(zw) > 4.0 || std::abs(zt) > 4.0)
+        {
+            std::printf("  MISMATCH: Monte Carlo is more than 4 standard errors from the exact answer\n");
+            return 1;
+        }
+    }
+    return converged ? 0 : 1;
+}
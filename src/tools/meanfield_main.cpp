@@ -0,0 +1,184 @@
+// Instant balance estimates from the mean-field engine.
+//
+// Answers "what if Albert's average were 40?" without playing real games:
+// level 1 is reduced to territory, frontier and pieces per tick (see
+// src/sim/MeanField.h), so an estimate takes about a millisecond.
+//   --calibrate N     also play N exact games per matchup, refit the
+//                     frontier constants and report model against engine
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "sim/MeanField.h"
+#include "sim/Stats.h"
+
+namespace
+{
+    struct Options
+    {
+        hl::AlbertConfig a{};
+        hl::AlbertConfig b{};
+        hl::GameConfig cfg{};
+        hl::MeanFieldParams params{};
+        int runs{400};
+        uint64_t seed{1};
+        int max_ticks{6000};
+        int calibrate{0};
+        int threads{0};
+    };
+
+    bool parse_config(const char *s, hl::AlbertConfig &out)
+    {
+        int avg = 0, half = 0;
+        if (std::sscanf(s, "%d:%d", &avg, &half) != 2 || avg <= 0 || half < 0)
+            return false;
+        out.rotation_average = avg;
+        out.rotation_half_interval = half;
+        return true;
+    }
+
+    void usage()
+    {
+        std::fprintf(stderr,
+                     "usage: handlords_meanfield [options]\n"
+                     "  --a AVG:HALF        player 0's Albert config (default 58:43)\n"
+                     "  --b AVG:HALF        player 1's Albert config (default 58:43)\n"
+                     "  --runs N            reduced games per estimate (default 400)\n"
+                     "  --seed S            model RNG seed (default 1)\n"
+                     "  --max-ticks M       timeout, scored as a draw (default 6000)\n"
+                     "  --pairs-per-cell R  pair budget R per open cell instead of 240 per tick\n"
+                     "  --pairs-per-edge R  pair budget R per frontier edge instead of 240 per tick\n"
+                     "  --frontier MAX:SCALE:RELAX  frontier constants (default from the last calibration)\n"
+                     "  --calibrate N       compare against N exact games per matchup\n"
+                     "  --threads T         exact-engine workers for --calibrate (default: all cores)\n");
+    }
+
+    bool parse_args(int argc, char **argv, Options &o)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char *arg = argv[i];
+            if (i + 1 >= argc)
+                return false;
+            const char *val = argv[++i];
+            if (!std::strcmp(arg, "--a"))
+            {
+                if (!parse_config(val, o.a))
+                    return false;
+            }
+            else if (!std::strcmp(arg, "--b"))
+            {
+                if (!parse_config(val, o.b))
+                    return false;
+            }
+            else if (!std::strcmp(arg, "--runs"))
+                o.runs = std::atoi(val);
+            else if (!std::strcmp(arg, "--seed"))
+                o.seed = std::strtoull(val, nullptr, 0);
+            else if (!std::strcmp(arg, "--max-ticks"))
+                o.max_ticks = std::atoi(val);
+            else if (!std::strcmp(arg, "--pairs-per-cell"))
+            {
+                o.cfg.pair_rate = hl::PairRate::PerOpenCell;
+                o.cfg.pairs_per_open_cell = std::atof(val);
+                if (o.cfg.pairs_per_open_cell <= 0.0)
+                    return false;
+            }
+            else if (!std::strcmp(arg, "--pairs-per-edge"))
+            {
+                o.cfg.pair_rate = hl::PairRate::PerFrontier;
+                o.cfg.pairs_per_frontier_edge = std::atof(val);
+                if (o.cfg.pairs_per_frontier_edge <= 0.0)
+                    return false;
+            }
+            else if (!std::strcmp(arg, "--frontier"))
+            {
+                hl::MeanFieldParams &p = o.params;
+                if (std::sscanf(val, "%lf:%lf:%lf", &p.frontier_max, &p.frontier_scale, &p.relax) != 3 ||
+                    p.frontier_max <= 0.0 || p.frontier_scale <= 0.0 || p.relax <= 0.0 || p.relax > 1.0)
+                    return false;
+            }
+            else if (!std::strcmp(arg, "--calibrate"))
+                o.calibrate = std::atoi(val);
+            else if (!std::strcmp(arg, "--threads"))
+                o.threads = std::atoi(val);
+            else
+                return false;
+        }
+        return o.runs > 0 && o.max_ticks > 0 && o.calibrate >= 0;
+    }
+
+    void print_calibration(const hl::CalibrationReport &rep, int games, int runs)
+    {
+        const hl::MeanFieldParams &p = rep.fitted;
+        std::printf("\ncalibration: %d exact games vs %d model runs per matchup\n", games, runs);
+        std::printf("  fitted frontier  --frontier %.1f:%.0f:%.2f\n\n", p.frontier_max, p.frontier_scale, p.relax);
+        std::printf("  %-13s  %-17s  %-17s  %6s  %-13s  %-13s  %9s\n", "matchup", "exact score", "model score",
+                    "z", "exact length", "model length", "speedup");
+        for (const hl::CalibrationRow &r : rep.rows)
+        {
+            char name[32];
+            std::snprintf(name, sizeof(name), "%d:%d/%d:%d", r.left.rotation_average, r.left.rotation_half_interval,
+                          r.right.rotation_average, r.right.rotation_half_interval);
+            const double se = std::sqrt((r.exact_ci * r.exact_ci + r.mf_ci * r.mf_ci)) / hl::Z95;
+            const double z = se > 0.0 ? (r.mf_score - r.exact_score) / se : 0.0;
+            std::printf("  %-13s  %.3f +/- %.3f    %.3f +/- %.3f    %+6.2f  %5.0f (sd %3.0f)  %5.0f (sd %3.0f)  %8.0fx\n",
+                        name, r.exact_score, r.exact_ci, r.mf_score, r.mf_ci, z, r.exact_ticks, r.exact_sd,
+                        r.mf_ticks, r.mf_sd, r.mf_us_per_game > 0.0 ? r.exact_us_per_game / r.mf_us_per_game : 0.0);
+        }
+        std::printf("\n  z = model minus exact score in standard errors; |z| > 2 is a miss.\n"
+                    "  Exact times include the frontier probe the fit needs.\n");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options o;
+    if (!parse_args(argc, argv, o))
+    {
+        usage();
+        return 2;
+    }
+
+    hl::MeanFieldSpec spec;
+    spec.left = o.a;
+    spec.right = o.b;
+    spec.cfg = o.cfg;
+    spec.params = o.params;
+    spec.runs = o.runs;
+    spec.seed = o.seed;
+    spec.max_ticks = o.max_ticks;
+    const hl::MeanFieldResult r = hl::run_mean_field(spec);
+
+    std::printf("handlords_meanfield: Albert %d:%d vs %d:%d, %d runs\n", o.a.rotation_average,
+                o.a.rotation_half_interval, o.b.rotation_average, o.b.rotation_half_interval, o.runs);
+    std::printf("  left score   %.3f +/- %.3f (95%%)\n", r.left_score, r.left_ci);
+    std::printf("  game length  mean %.1f, sd %.1f ticks (%.1f%% timeouts)\n", r.mean_ticks, r.sd_ticks,
+                100.0 * r.timeouts);
+    std::printf("  time         %.0f us (%.2f us per game)\n", 1e6 * r.seconds, 1e6 * r.seconds / o.runs);
+
+    if (o.calibrate > 0)
+    {
+        const hl::AlbertConfig base{};
+        std::vector<std::pair<hl::AlbertConfig, hl::AlbertConfig>> matchups = {
+            {base, base},
+            {{40, 20}, base},
+            {{25, 10}, base},
+            {{120, 20}, base},
+            {{80, 20}, {40, 20}},
+        };
+        auto same = [](const hl::AlbertConfig &x, const hl::AlbertConfig &y)
+        { return x.rotation_average == y.rotation_average && x.rotation_half_interval == y.rotation_half_interval; };
+        bool listed = false;
+        for (const auto &[l, r] : matchups)
+            listed = listed || (same(l, o.a) && same(r, o.b));
+        if (!listed)
+            matchups.insert(matchups.begin(), {o.a, o.b});
+        const hl::CalibrationReport rep =
+            hl::calibrate_mean_field(matchups, o.cfg, o.calibrate, o.runs, o.seed, o.threads);
+        print_calibration(rep, o.calibrate, o.runs);
+    }
+    return 0;
+}
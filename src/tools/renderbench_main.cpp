@@ -0,0 +1,276 @@
+// Offscreen benchmark of the PC build's windows.
+//
+// Draws the arena, debug and tuning windows (and optionally the game wall)
+// for synthetic boards into SDL's software renderer on a plain surface, so
+// it needs no display, window or GPU. Per scenario it reports CPU time per
+// frame to build the ImGui frame ("ui") and to rasterize it ("draw"), and
+// the vertices, indices and draw calls the frame generated.
+//   --repeat/--out record repeated runs for handlords_benchcmp, as
+//   handlords_bench does
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <SDL.h>
+
+#include "imgui.h"
+#include "backends/imgui_impl_sdlrenderer2.h"
+
+#include "levels/Levels.h"
+#include "sim/BenchCompare.h"
+#include "ui/Views.h"
+#include "util/Rng.h"
+
+namespace
+{
+    struct Scenario
+    {
+        const char *name;
+        int width, height; // display
+        int players;       // owners spread over the board; 0 = no symbols at all
+        bool arena_fills;  // stretch the arena window over the display
+        bool wall;         // also draw a 256-game wall
+    };
+
+    // The arena is fixed at 40x24 cells, so "large" means more pixels per cell
+    const Scenario SCENARIOS[] = {
+        {"empty", 1400, 800, 0, false, false},
+        {"two-player", 1400, 800, 2, false, false},
+        {"fifteen-player", 1400, 800, 15, false, false},
+        {"two-player-4k", 3840, 2160, 2, true, false},
+        {"game-wall-256", 1400, 800, 2, false, true},
+    };
+
+    struct Options
+    {
+        int frames{300};
+        int warmup{30};
+        int repeat{1};
+        std::string only;
+        std::string out;
+    };
+
+    struct Frames
+    {
+        std::vector<double> ui, draw; // seconds per frame
+        int vertices{0}, indices{0}, draw_calls{0}; // of the last frame
+    };
+
+    double seconds_since(std::chrono::steady_clock::time_point t0)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    double quantile(std::vector<double> v, double q)
+    {
+        if (v.empty())
+            return 0.0;
+        std::sort(v.begin(), v.end());
+        return v[std::min(v.size() - 1, static_cast<size_t>(q * v.size()))];
+    }
+
+    // Level 1's walls; its two halves, or `players` owners in a 5 x 3 patchwork
+    hl::GameState make_board(const Scenario &sc)
+    {
+        hl::GameState gs;
+        gs.players = {hl::PlayerState{hl::PlayerId{0}, hl::Piece::Rock},
+                      hl::PlayerState{hl::PlayerId{1}, hl::Piece::Scissors}};
+        gs.players[1].ai = hl::AiKind::Albert;
+        load_level(gs, 1);
+        if (sc.players == 2)
+            return gs;
+
+        for (int i = 2; i < sc.players; ++i)
+            gs.players.push_back(hl::PlayerState{hl::PlayerId{static_cast<uint8_t>(i)}, hl::Piece::Rock});
+        hl::Rng64 rng{1};
+        for (int y = 0; y < hl::ARENA_H; ++y)
+        {
+            for (int x = 0; x < hl::ARENA_W; ++x)
+            {
+                hl::Cell &c = gs.grid.at(x, y);
+                if (c.kind == hl::CellKind::Wall)
+                    continue;
+                if (sc.players == 0)
+                {
+                    c.kind = hl::CellKind::Empty;
+                    continue;
+                }
+                const int owner = (x * 5 / hl::ARENA_W + 5 * (y * 3 / hl::ARENA_H)) % sc.players;
+                c.kind = hl::CellKind::Symbol;
+                c.owner = hl::PlayerId{static_cast<uint8_t>(owner)};
+                c.piece = static_cast<hl::Piece>(hl::Rng64::scale(rng.next(), 3));
+            }
+        }
+        return gs;
+    }
+
+    bool run_scenario(const Scenario &sc, const Options &o, Frames &out, std::string &err)
+    {
+        SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, sc.width, sc.height, 32, SDL_PIXELFORMAT_RGBA32);
+        SDL_Renderer *ren = surface ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+        if (!ren)
+        {
+            err = std::string("software renderer: ") + SDL_GetError();
+            if (surface)
+                SDL_FreeSurface(surface);
+            return false;
+        }
+        ImGui::CreateContext();
+        ImGuiIO &io = ImGui::GetIO();
+        io.IniFilename = nullptr;
+        io.DisplaySize = ImVec2(static_cast<float>(sc.width), static_cast<float>(sc.height));
+        ImGui::StyleColorsDark();
+        ImGui_ImplSDLRenderer2_Init(ren);
+
+        hl::GameState gs = make_board(sc);
+        bool slice_ticks = true, async_ai = false, game_wall = sc.wall;
+        WallView wall;
+        wall.games = hl::GameWall::MAX_GAMES;
+        wall.running = false; // stepped below, outside the timed region
+
+        out = Frames{};
+        for (int f = 0; f < o.warmup + o.frames; ++f)
+        {
+            if (sc.wall && wall.wall.games() > 0)
+                wall.wall.step(1, 0);
+            io.DeltaTime = 1.0f / 60.0f;
+
+            const auto t0 = std::chrono::steady_clock::now();
+            ImGui_ImplSDLRenderer2_NewFrame();
+            ImGui::NewFrame();
+            draw_grid_imgui(gs, "Arena", nullptr, sc.arena_fills);
+            draw_debug_ui(gs, slice_ticks, async_ai, game_wall);
+            draw_tuning_ui(gs);
+            if (sc.wall)
+                draw_game_wall(wall, ren, 0.0, nullptr);
+            ImGui::Render();
+            const double ui = seconds_since(t0);
+
+            const auto t1 = std::chrono::steady_clock::now();
+            SDL_SetRenderDrawColor(ren, 20, 20, 24, 255);
+            SDL_RenderClear(ren);
+            ImDrawData *dd = ImGui::GetDrawData();
+            ImGui_ImplSDLRenderer2_RenderDrawData(dd, ren);
+            SDL_RenderPresent(ren);
+            const double draw = seconds_since(t1);
+
+            if (f < o.warmup)
+                continue;
+            out.ui.push_back(ui);
+            out.draw.push_back(draw);
+            out.vertices = dd->TotalVtxCount;
+            out.indices = dd->TotalIdxCount;
+            out.draw_calls = 0;
+            for (int n = 0; n < dd->CmdListsCount; ++n)
+                out.draw_calls += dd->CmdLists[n]->CmdBuffer.Size;
+        }
+
+        if (wall.tex)
+            SDL_DestroyTexture(wall.tex);
+        ImGui_ImplSDLRenderer2_Shutdown();
+        ImGui::DestroyContext();
+        SDL_DestroyRenderer(ren);
+        SDL_FreeSurface(surface);
+        return true;
+    }
+
+    void usage()
+    {
+        std::fprintf(stderr, "usage: handlords_renderbench [options]\n"
+                             "  --frames N     timed frames per scenario (default 300)\n"
+                             "  --warmup N     untimed frames first (default 30)\n"
+                             "  --scenario S   only scenarios whose name contains S\n"
+                             "  --repeat R     run every scenario R times (default 1)\n"
+                             "  --out PATH     write every repetition to PATH for handlords_benchcmp\n");
+    }
+
+    bool parse_args(int argc, char **argv, Options &o)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char *arg = argv[i];
+            if (i + 1 >= argc)
+                return false;
+            const char *val = argv[++i];
+            if (!std::strcmp(arg, "--frames"))
+                o.frames = std::atoi(val);
+            else if (!std::strcmp(arg, "--warmup"))
+                o.warmup = std::atoi(val);
+            else if (!std::strcmp(arg, "--scenario"))
+                o.only = val;
+            else if (!std::strcmp(arg, "--repeat"))
+                o.repeat = std::atoi(val);
+            else if (!std::strcmp(arg, "--out"))
+                o.out = val;
+            else
+                return false;
+        }
+        return o.frames > 0 && o.warmup >= 0 && o.repeat > 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options o;
+    if (!parse_args(argc, argv, o))
+    {
+        usage();
+        return 2;
+    }
+
+    std::printf("handlords_renderbench: SDL software renderer, %d frames per scenario (%d warm-up)\n", o.frames,
+                o.warmup);
+    std::printf("%-15s  %-9s  %8s  %8s  %8s  %8s  %8s  %8s  %5s\n", "scenario", "display", "ui p50", "ui p99",
+                "draw p50", "draw p99", "vertices", "indices", "calls");
+
+    std::vector<hl::BenchSeries> series;
+    for (const Scenario &sc : SCENARIOS)
+    {
+        if (!o.only.empty() && std::string(sc.name).find(o.only) == std::string::npos)
+            continue;
+        hl::BenchSeries ui{std::string("render/") + sc.name + "/ui", "frames/s", {}};
+        hl::BenchSeries draw{std::string("render/") + sc.name + "/draw", "frames/s", {}};
+        for (int r = 0; r < o.repeat; ++r)
+        {
+            Frames fr;
+            std::string err;
+            if (!run_scenario(sc, o, fr, err))
+            {
+                std::fprintf(stderr, "handlords_renderbench: %s\n", err.c_str());
+                return 1;
+            }
+            double ui_s = 0.0, draw_s = 0.0;
+            for (size_t i = 0; i < fr.ui.size(); ++i)
+            {
+                ui_s += fr.ui[i];
+                draw_s += fr.draw[i];
+            }
+            ui.samples.push_back(fr.ui.size() / ui_s);
+            draw.samples.push_back(fr.draw.size() / draw_s);
+            char display[16];
+            std::snprintf(display, sizeof(display), "%dx%d", sc.width, sc.height);
+            std::printf("%-15s  %-9s  %5.3f ms  %5.3f ms  %5.3f ms  %5.3f ms  %8d  %8d  %5d\n", sc.name, display,
+                        1e3 * quantile(fr.ui, 0.5), 1e3 * quantile(fr.ui, 0.99), 1e3 * quantile(fr.draw, 0.5),
+                        1e3 * quantile(fr.draw, 0.99), fr.vertices, fr.indices, fr.draw_calls);
+        }
+        series.push_back(ui);
+        series.push_back(draw);
+    }
+
+    if (!o.out.empty())
+    {
+        std::string err;
+        const std::string comment = "handlords_renderbench --frames " + std::to_string(o.frames) + " --repeat " +
+                                    std::to_string(o.repeat);
+        if (!hl::write_bench_results(o.out, series, comment, err))
+        {
+            std::fprintf(stderr, "handlords_renderbench: %s\n", err.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
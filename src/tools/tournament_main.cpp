@@ -0,0 +1,161 @@
+// Headless round-robin tournament between AIs.
+//
+// Plays every AI pairing on every level in mirrored pairs, spends further
+// rounds on the closest pairings, and stops once all Bradley-Terry Elo
+// ratings are known to within --target-ci (or a budget runs out).
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "levels/Levels.h"
+#include "sim/Tournament.h"
+
+namespace
+{
+    void usage()
+    {
+        std::fprintf(stderr,
+                     "usage: handlords_tournament [options]\n"
+                     "  --ai NAME=SPEC      add an entrant; SPEC is albert[:AVG:HALF] or idle\n"
+                     "                      (default roster when none given)\n"
+                     "  --levels L[,L..]    levels to play (default: all %d)\n"
+                     "  --seed S            base seed (default 1)\n"
+                     "  --threads T         worker threads (default: all cores)\n"
+                     "  --max-ticks M       timeout, scored as a draw (default 6000)\n"
+                     "  --initial-pairs N   mirrored pairs per pairing in round 0 (default 16)\n"
+                     "  --round-pairs N     mirrored pairs per adaptive round\n"
+                     "  --max-games N       game budget (default 40000)\n"
+                     "  --max-seconds S     time budget (default 300)\n"
+                     "  --target-ci E       stop when every 95%% Elo CI is below +/-E (default 25)\n",
+                     LEVEL_COUNT);
+    }
+
+    bool parse_levels(const char *s, std::vector<int> &out)
+    {
+        out.clear();
+        while (*s)
+        {
+            char *end = nullptr;
+            long v = std::strtol(s, &end, 10);
+            if (end == s || v < 1 || v > LEVEL_COUNT)
+                return false;
+            out.push_back(static_cast<int>(v));
+            s = *end == ',' ? end + 1 : end;
+        }
+        return !out.empty();
+    }
+
+    bool parse_args(int argc, char **argv, hl::TournamentConfig &cfg)
+    {
+        cfg.levels.clear();
+        for (int l = 1; l <= LEVEL_COUNT; ++l)
+            cfg.levels.push_back(l);
+
+        for (int i = 1; i < argc; ++i)
+        {
+            const char *arg = argv[i];
+            if (i + 1 >= argc)
+                return false;
+            const char *val = argv[++i];
+
+            if (!std::strcmp(arg, "--ai"))
+            {
+                const char *eq = std::strchr(val, '=');
+                hl::Entrant e;
+                if (!eq || eq == val || !hl::parse_side(eq + 1, e.side))
+                    return false;
+                e.name.assign(val, eq);
+                cfg.entrants.push_back(e);
+            }
+            else if (!std::strcmp(arg, "--levels"))
+            {
+                if (!parse_levels(val, cfg.levels))
+                    return false;
+            }
+            else if (!std::strcmp(arg, "--seed"))
+                cfg.seed = std::strtoull(val, nullptr, 0);
+            else if (!std::strcmp(arg, "--threads"))
+                cfg.threads = std::atoi(val);
+            else if (!std::strcmp(arg, "--max-ticks"))
+                cfg.max_ticks = std::atoi(val);
+            else if (!std::strcmp(arg, "--initial-pairs"))
+                cfg.initial_pairs = std::atoi(val);
+            else if (!std::strcmp(arg, "--round-pairs"))
+                cfg.round_pairs = std::atoi(val);
+            else if (!std::strcmp(arg, "--max-games"))
+                cfg.max_games = std::atoi(val);
+            else if (!std::strcmp(arg, "--max-seconds"))
+                cfg.max_seconds = std::atof(val);
+            else if (!std::strcmp(arg, "--target-ci"))
+                cfg.target_ci = std::atof(val);
+            else
+                return false;
+        }
+        if (cfg.entrants.empty())
+            cfg.entrants = hl::default_entrants();
+        return cfg.entrants.size() >= 2 && cfg.initial_pairs > 0 && cfg.max_games > 0 &&
+               cfg.max_ticks > 0 && cfg.max_ticks < 65000;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    hl::TournamentConfig cfg;
+    if (!parse_args(argc, argv, cfg))
+    {
+        usage();
+        return 2;
+    }
+
+    const int n = static_cast<int>(cfg.entrants.size());
+    std::printf("handlords_tournament: %d entrants, %zu level(s), seed %llu\n", n, cfg.levels.size(),
+                static_cast<unsigned long long>(cfg.seed));
+
+    auto on_round = [&](const hl::TournamentProgress &p)
+    {
+        std::printf("round %3d  games %7d  %8.0f games/s  max CI +/-%.1f Elo\n", p.round, p.games,
+                    p.seconds > 0.0 ? p.games / p.seconds : 0.0, p.max_ci);
+        std::fflush(stdout);
+    };
+    hl::TournamentReport rep = hl::run_tournament(cfg, on_round);
+
+    std::printf("\n%s after %d games, %.1f s (%.0f ticks/s)\n\n",
+                rep.converged ? "converged" : "budget exhausted", rep.games, rep.seconds,
+                rep.seconds > 0.0 ? rep.ticks / rep.seconds : 0.0);
+
+    std::vector<int> order(n);
+    for (int i = 0; i < n; ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int x, int y)
+              { return rep.ratings.elo[x] > rep.ratings.elo[y]; });
+
+    std::vector<double> points(n, 0.0);
+    std::vector<int> played(n, 0);
+    for (const auto &p : rep.pairings)
+    {
+        points[p.a] += p.score_a;
+        points[p.b] += p.games - p.score_a;
+        played[p.a] += p.games;
+        played[p.b] += p.games;
+    }
+
+    std::printf("rank  %-16s %8s %8s %8s %7s\n", "entrant", "elo", "ci95", "games", "score");
+    for (int r = 0; r < n; ++r)
+    {
+        const int i = order[r];
+        std::printf("%4d  %-16s %+8.1f %8.1f %8d %6.1f%%\n", r + 1, cfg.entrants[i].name.c_str(),
+                    rep.ratings.elo[i], rep.ratings.elo_ci[i], played[i],
+                    played[i] ? 100.0 * points[i] / played[i] : 0.0);
+    }
+
+    std::printf("\npairings (score of first entrant)\n");
+    for (const auto &p : rep.pairings)
+    {
+        std::printf("  L%d  %-16s vs %-16s %6.1f%%  (%d games)\n", p.level, cfg.entrants[p.a].name.c_str(),
+                    cfg.entrants[p.b].name.c_str(), p.games ? 100.0 * p.score_a / p.games : 0.0, p.games);
+    }
+    return rep.converged ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+// Win-probability tables for the Table AI.
+//
+// Builds the 3 KB table the Table AI looks up every tick from batch games
+// (see src/ai/WinTable.h), and measures how much playing strength it keeps
+// compared to the Rollout AI, which plays both of its choices out every
+// few ticks.
+//   --build N      tabulate N Albert-vs-Albert games and write the table
+//   --strength N   play Albert, Table and Rollout against the same Albert,
+//                  then Table against Rollout, N mirrored games each (the
+//                  default, with N = 200)
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "sim/WinTableFarm.h"
+
+namespace
+{
+    struct Options
+    {
+        int build{0};
+        int strength{0};
+        std::string out{"data/wintable.txt"};
+        std::string table{"data/wintable.txt"};
+        hl::AlbertConfig opponent{};
+        hl::RolloutConfig rollout{};
+        uint64_t seed{1};
+        int max_ticks{6000};
+        int threads{0};
+    };
+
+    void usage()
+    {
+        std::fprintf(stderr,
+                     "usage: handlords_wintable [options]\n"
+                     "  --build N           tabulate N games and write the table to --out\n"
+                     "  --out PATH          where --build writes (default data/wintable.txt)\n"
+                     "  --strength N        games per contender against --opponent (default 200)\n"
+                     "  --table PATH        table --strength plays with (default data/wintable.txt)\n"
+                     "  --opponent AVG:HALF Albert config every contender faces (default 58:43)\n"
+                     "  --rollouts K        Rollout AI: rollouts per choice (default 8)\n"
+                     "  --horizon H         Rollout AI: ticks per rollout (default 40)\n"
+                     "  --think T           Rollout AI: decide every T ticks (default 5)\n"
+                     "  --seed S            first seed (default 1)\n"
+                     "  --max-ticks M       timeout, scored as a draw (default 6000)\n"
+                     "  --threads T         worker threads (default: all cores)\n");
+    }
+
+    bool parse_args(int argc, char **argv, Options &o)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char *arg = argv[i];
+            if (i + 1 >= argc)
+                return false;
+            const char *val = argv[++i];
+            if (!std::strcmp(arg, "--build"))
+                o.build = std::atoi(val);
+            else if (!std::strcmp(arg, "--out"))
+                o.out = val;
+            else if (!std::strcmp(arg, "--strength"))
+                o.strength = std::atoi(val);
+            else if (!std::strcmp(arg, "--table"))
+                o.table = val;
+            else if (!std::strcmp(arg, "--opponent"))
+            {
+                if (std::sscanf(val, "%d:%d", &o.opponent.rotation_average, &o.opponent.rotation_half_interval) !=
+                        2 ||
+                    o.opponent.rotation_average <= 0 || o.opponent.rotation_half_interval < 0)
+                    return false;
+            }
+            else if (!std::strcmp(arg, "--rollouts"))
+                o.rollout.rollouts = std::atoi(val);
+            else if (!std::strcmp(arg, "--horizon"))
+                o.rollout.horizon = std::atoi(val);
+            else if (!std::strcmp(arg, "--think"))
+                o.rollout.think_every = std::atoi(val);
+            else if (!std::strcmp(arg, "--seed"))
+                o.seed = std::strtoull(val, nullptr, 0);
+            else if (!std::strcmp(arg, "--max-ticks"))
+                o.max_ticks = std::atoi(val);
+            else if (!std::strcmp(arg, "--threads"))
+                o.threads = std::atoi(val);
+            else
+                return false;
+        }
+        if (o.build == 0 && o.strength == 0)
+            o.strength = 200;
+        return o.build >= 0 && o.strength >= 0 && o.max_ticks > 0 && o.rollout.rollouts > 0 &&
+               o.rollout.horizon > 0 && o.rollout.think_every > 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options o;
+    if (!parse_args(argc, argv, o))
+    {
+        usage();
+        return 2;
+    }
+
+    std::string err;
+    hl::WinTable table;
+    if (o.build > 0)
+    {
+        hl::WinTableBuildSpec spec;
+        spec.games = o.build;
+        spec.seed = o.seed;
+        spec.max_ticks = o.max_ticks;
+        spec.threads = o.threads;
+        const hl::WinTableBuildReport rep = hl::build_win_table(spec);
+        std::printf("handlords_wintable: %d games, %llu positions in %.1f s\n", o.build,
+                    static_cast<unsigned long long>(rep.samples), rep.seconds);
+        std::printf("  buckets     %d, %d never reached, %d with under 100 positions\n", hl::WinTable::SIZE,
+                    rep.empty, rep.sparse);
+        std::printf("  brier       %.4f (quantized table against each position's result)\n", rep.brier);
+        const std::string note = "built from " + std::to_string(o.build) + " games, seed " + std::to_string(o.seed);
+        if (!rep.table.save(o.out, note, err))
+        {
+            std::fprintf(stderr, "handlords_wintable: %s\n", err.c_str());
+            return 1;
+        }
+        std::printf("  wrote       %s\n", o.out.c_str());
+        table = rep.table;
+    }
+    else if (!table.load(o.table, err))
+    {
+        std::fprintf(stderr, "handlords_wintable: %s\n", err.c_str());
+        return 1;
+    }
+
+    if (o.strength > 0)
+    {
+        hl::StrengthSpec spec;
+        spec.table = &table;
+        spec.opponent = o.opponent;
+        spec.rollout = o.rollout;
+        spec.games = o.strength;
+        spec.seed = o.seed;
+        spec.max_ticks = o.max_ticks;
+        spec.threads = o.threads;
+        hl::AiMeter meter;
+        const std::vector<hl::StrengthRow> rows = hl::measure_win_table(spec, meter);
+
+        std::printf("\nstrength against Albert %d:%d (last row: head to head), %d mirrored games per row\n",
+                    o.opponent.rotation_average, o.opponent.rotation_half_interval, 2 * ((o.strength + 1) / 2));
+        std::printf("  %-18s  %-15s  %9s  %8s\n", "contender", "score", "length", "time");
+        for (const hl::StrengthRow &r : rows)
+            std::printf("  %-18s  %.3f +/- %.3f  %5.0f tks  %6.1f s\n", r.name.c_str(), r.score, r.ci, r.mean_ticks,
+                        r.seconds);
+        const double base = rows[0].score, edge = rows[2].score - base;
+        if (edge > 0.0)
+            std::printf("\n  table keeps %.0f%% of the rollout's edge over the baseline\n",
+                        100.0 * (rows[1].score - base) / edge);
+        else
+            std::printf("\n  the rollout has no edge over the baseline here; nothing to retain\n");
+        std::printf("  head to head the table scores %.3f +/- %.3f against the rollout (0.5 = nothing lost)\n",
+                    rows[3].score, rows[3].ci);
+        std::printf("\ncost per AI update:\n");
+        meter.report(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,426 @@
+#include "ui/Views.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "imgui.h"
+
+#include "ai/AsyncAi.h"
+
+// ----------------- Rendering -----------------
+void draw_grid_imgui(const hl::GameState &gs, const char *title, bool *open, bool fill)
+{
+    // Set up the Arena window to be large and prominent - FirstUseEver allows user to move/resize
+    const ImVec2 display = ImGui::GetIO().DisplaySize;
+    const ImGuiCond cond = fill ? ImGuiCond_Always : ImGuiCond_FirstUseEver;
+    ImGui::SetNextWindowPos(ImVec2(10, 10), cond);
+    ImGui::SetNextWindowSize(fill ? ImVec2(display.x - 20.0f, display.y - 20.0f) : ImVec2(1000, 700), cond);
+    
+    ImGui::Begin(title, open, ImGuiWindowFlags_NoCollapse);
+    const ImVec2 avail = ImGui::GetContentRegionAvail();
+
+    // Show debug info about window size
+    ImGui::Text("Window size: %.0f x %.0f", avail.x, avail.y);
+    ImGui::Text("Window pos: %.0f, %.0f", ImGui::GetWindowPos().x, ImGui::GetWindowPos().y);
+    ImGui::Text("Cursor pos: %.0f, %.0f", ImGui::GetCursorScreenPos().x, ImGui::GetCursorScreenPos().y);
+
+    // Compute cell size to fit grid while preserving aspect
+    const float cell_w = avail.x / hl::ARENA_W;
+    const float cell_h = avail.y / hl::ARENA_H;
+    const float cell = std::max(8.0f, std::min(cell_w, cell_h)); // Minimum 8 pixels per cell
+
+    ImGui::Text("Cell size: %.1f pixels", cell);
+
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImDrawList *dl = ImGui::GetWindowDrawList();
+
+    auto color_for_player = [](uint8_t pid) -> ImU32
+    {
+        // Simple palette: up to 4 players
+        static const ImU32 k[] = {
+            IM_COL32(80, 200, 120, 255), // human - greenish
+            IM_COL32(220, 80, 80, 255),  // opponent 1 - red
+            IM_COL32(80, 120, 220, 255), // opponent 2 - blue
+            IM_COL32(220, 200, 80, 255), // opponent 3 - yellow
+        };
+        return k[pid % 4];
+    };
+
+    const ImU32 wall_col = IM_COL32(80, 80, 80, 255);
+    const ImU32 empty_bg = IM_COL32(25, 25, 28, 255);
+
+    // Background
+    dl->AddRectFilled(origin, ImVec2(origin.x + cell * hl::ARENA_W, origin.y + cell * hl::ARENA_H), empty_bg);
+
+    // Cells
+    for (int y = 0; y < hl::ARENA_H; ++y)
+    {
+        for (int x = 0; x < hl::ARENA_W; ++x)
+        {
+            const auto &c = gs.grid.at(x, y);
+            ImVec2 p0(origin.x + x * cell, origin.y + y * cell);
+            ImVec2 p1(p0.x + cell - 1.0f, p0.y + cell - 1.0f);
+            switch (c.kind)
+            {
+            case hl::CellKind::Empty:
+                break;
+            case hl::CellKind::Wall:
+                dl->AddRectFilled(p0, p1, wall_col);
+                break;
+            case hl::CellKind::Symbol:
+            {
+                ImU32 col = color_for_player(c.owner.v);
+                dl->AddRectFilled(p0, p1, col);
+                
+                // Add text character to show piece type
+                const char* piece_char = "R"; // Default to Rock
+                if (c.piece == hl::Piece::Paper)
+                    piece_char = "P";
+                else if (c.piece == hl::Piece::Scissors)
+                    piece_char = "S";
+                
+                // Calculate text position (centered in cell)
+                float font_size = std::max(8.0f, cell * 0.6f);
+                ImVec2 text_pos(p0.x + cell * 0.5f - font_size * 0.3f, p0.y + cell * 0.5f - font_size * 0.5f);
+                
+                // Add white text with black outline for visibility
+                ImU32 text_color = IM_COL32(255, 255, 255, 255);
+                ImU32 outline_color = IM_COL32(0, 0, 0, 255);
+                
+                // Simple outline effect by drawing text at offset positions
+                for (int dx = -1; dx <= 1; dx++) {
+                    for (int dy = -1; dy <= 1; dy++) {
+                        if (dx != 0 || dy != 0) {
+                            dl->AddText(ImVec2(text_pos.x + dx, text_pos.y + dy), outline_color, piece_char);
+                        }
+                    }
+                }
+                dl->AddText(text_pos, text_color, piece_char);
+            }
+            break;
+            }
+        }
+    }
+
+    ImGui::End();
+}
+
+// ----------------- Debug UI -----------------
+void draw_debug_ui(hl::GameState &gs, bool &slice_ticks, bool &async_ai, bool &game_wall)
+{
+    // Position the debug window to the right of the arena - FirstUseEver allows user to move/resize
+    ImGui::SetNextWindowPos(ImVec2(1020, 10), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(300, 400), ImGuiCond_FirstUseEver);
+    
+    ImGui::Begin("Game State");
+
+    const char *phase_names[] = {"Ready", "Playing", "Lost", "Won", "GameWon"};
+    ImGui::Text("Phase: %s", phase_names[static_cast<int>(gs.phase)]);
+    ImGui::Text("Tick: %d", gs.tick);
+    ImGui::Text("Level: %d", gs.current_level);
+    ImGui::Text("RNG: 0x%04X", gs.rng16);
+    ImGui::Text("Battles this tick: %d", gs.last_battles);
+    
+    // RNG selection checkbox
+    ImGui::Separator();
+    ImGui::Checkbox("Use System RNG", &gs.use_system_rng);
+    if (!gs.use_system_rng)
+    {
+        // One step per draw correlates x, y and direction; see handlords_rngaudit
+        int stride = gs.lfsr_stride == 16 ? 2 : gs.lfsr_stride == 8 ? 1 : 0;
+        ImGui::Text("LFSR steps per draw:");
+        ImGui::SameLine();
+        ImGui::RadioButton("1", &stride, 0);
+        ImGui::SameLine();
+        ImGui::RadioButton("8", &stride, 1);
+        ImGui::SameLine();
+        ImGui::RadioButton("16", &stride, 2);
+        gs.lfsr_stride = static_cast<uint8_t>(stride == 2 ? 16 : stride == 1 ? 8 : 1);
+        if (gs.lfsr_stride == 1)
+            ImGui::Text("(1 step: only 240 of 960 cells drawn)");
+    }
+    ImGui::Checkbox("Sparse sampling", &gs.sparse_sampling);
+    ImGui::Text("Active blocks: %d / %d", gs.activity.active_count(), gs.activity.tile_count());
+    ImGui::Checkbox("Spread ticks over frames", &slice_ticks);
+    if (gs.slice.open)
+        ImGui::Text("Tick pairs done: %d / %d", gs.slice.done, gs.slice.total);
+    ImGui::Checkbox("Async AI (decisions 2 ticks late)", &async_ai);
+    if (gs.async_ai)
+        ImGui::Text("AI decisions: %lld, missed: %zu", gs.async_ai->decisions(), gs.async_ai->misses().size());
+    ImGui::Checkbox("Game wall (headless games)", &game_wall);
+
+    ImGui::Separator();
+    ImGui::Text("Players:");
+    for (size_t i = 0; i < gs.players.size(); ++i)
+    {
+        const auto &p = gs.players[i];
+        const char *piece_names[] = {"Rock", "Paper", "Scissors"};
+        ImGui::Text("Player %d: %s (losses: %d)",
+                    p.id.v, piece_names[static_cast<int>(p.current)], p.tick_losses);
+    }
+    
+    // Count symbols for each player
+    ImGui::Separator();
+    ImGui::Text("Symbol counts:");
+    std::vector<int> counts(std::max<size_t>(4, gs.players.size()), 0);
+    for (int y = 0; y < hl::ARENA_H; ++y) {
+        for (int x = 0; x < hl::ARENA_W; ++x) {
+            const auto &c = gs.grid.at(x, y);
+            if (c.kind == hl::CellKind::Symbol && c.owner.v < counts.size()) {
+                counts[c.owner.v]++;
+            }
+        }
+    }
+    for (size_t i = 0; i < gs.players.size(); ++i) {
+        ImGui::Text("Player %zu: %d symbols", i, counts[i]);
+    }
+
+    if (gs.phase == hl::Phase::Ready)
+    {
+        ImGui::Separator();
+        ImGui::Text("Press SPACE to start!");
+    }
+    else if (gs.phase == hl::Phase::Playing)
+    {
+        ImGui::Separator();
+        ImGui::Text("Press SPACE to rotate your piece!");
+    }
+    else if (gs.phase == hl::Phase::Won)
+    {
+        ImGui::Separator();
+        ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "YOU WON!");
+        ImGui::Text("Press SPACE to restart level");
+    }
+    else if (gs.phase == hl::Phase::Lost)
+    {
+        ImGui::Separator();
+        ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "YOU LOST!");
+        ImGui::Text("Press SPACE to restart level");
+    }
+
+    // Enhanced pair statistics
+    ImGui::Separator();
+    ImGui::Text("Per-tick statistics:");
+    ImGui::Text("Battles: %d", gs.last_battles);
+    ImGui::Text("Same player pairs: %d", gs.last_same_player);
+    ImGui::Text("Wall/empty pairs: %d", gs.last_wall_empty);
+    ImGui::Text("Total attempts: %d", gs.last_attempts);
+
+    // Legend for the arena graphics
+    ImGui::Separator();
+    ImGui::Text("Arena Legend:");
+    ImGui::Text("Dark gray = Walls (borders)");
+    ImGui::Text("Black = Empty space");
+    ImGui::TextColored(ImVec4(0.31f, 0.78f, 0.47f, 1.0f), "Green = Your territory (Player 0)");
+    ImGui::TextColored(ImVec4(0.86f, 0.31f, 0.31f, 1.0f), "Red = Opponent territory (Player 1)");
+    ImGui::Separator();
+    ImGui::Text("Symbol characters:");
+    ImGui::Text("R = Rock");
+    ImGui::Text("P = Paper");
+    ImGui::Text("S = Scissors");
+
+    ImGui::End();
+}
+
+// ----------------- Tuning UI -----------------
+void draw_tuning_ui(hl::GameState &gs)
+{
+    // Position the tuning window to the left of other windows
+    ImGui::SetNextWindowPos(ImVec2(10, 450), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(350, 300), ImGuiCond_FirstUseEver);
+    
+    ImGui::Begin("Game Tuning");
+
+    // Combat statistics section
+    ImGui::Text("Combat Performance (per 15 ticks):");
+    ImGui::Separator();
+    
+    // Calculate combats per 15 ticks (1 second at 15 Hz)
+    static int combat_history[15] = {0}; // Ring buffer for last 15 ticks
+    static int history_index = 0;
+    
+    // Update history
+    combat_history[history_index] = gs.last_battles;
+    history_index = (history_index + 1) % 15;
+    
+    // Calculate total combats in last 15 ticks
+    int total_combats = 0;
+    for (int i = 0; i < 15; i++) {
+        total_combats += combat_history[i];
+    }
+    
+    ImGui::Text("Combats per second: %d", total_combats);
+    ImGui::Text("Current tick battles: %d", gs.last_battles);
+    ImGui::Text("Efficiency: %.1f%%", gs.last_attempts > 0 ? (float)gs.last_battles / gs.last_attempts * 100.0f : 0.0f);
+    
+    ImGui::Separator();
+    
+    // Game parameters section
+    ImGui::Text("Game Parameters:");
+    int rate = static_cast<int>(gs.cfg.pair_rate);
+    ImGui::RadioButton("Fixed", &rate, 0);
+    ImGui::SameLine();
+    ImGui::RadioButton("Per open cell", &rate, 1);
+    ImGui::SameLine();
+    ImGui::RadioButton("Per frontier edge", &rate, 2);
+    gs.cfg.pair_rate = static_cast<hl::PairRate>(rate);
+    if (gs.cfg.pair_rate == hl::PairRate::PerOpenCell)
+        ImGui::InputDouble("Pairs per open cell", &gs.cfg.pairs_per_open_cell, 0.01, 0.1, "%.3f");
+    else if (gs.cfg.pair_rate == hl::PairRate::PerFrontier)
+        ImGui::InputDouble("Pairs per frontier edge", &gs.cfg.pairs_per_frontier_edge, 0.5, 5.0, "%.2f");
+    else
+        ImGui::SliderInt("Pairs per tick", &gs.cfg.pairs_per_tick, 50, 500);
+    ImGui::Text("Next tick: %d pairs (%d open cells, %u frontier edges)", pair_budget(gs), gs.open_cells,
+                gs.activity.live_edges());
+    ImGui::SliderInt("Ticks per second", &gs.cfg.ticks_per_second, 5, 30);
+    
+    if (ImGui::Button("Reset to Default")) {
+        gs.cfg = hl::GameConfig{};
+    }
+    
+    ImGui::Separator();
+    
+    // Albert AI section
+    ImGui::Text("Albert AI (Player 1):");
+    
+    if (gs.players.size() > 1) {
+        auto &albert = gs.players[1];
+
+        // Configuration controls
+        ImGui::SliderInt("Rotation Average", &albert.albert.rotation_average, 10, 200);
+        ImGui::SliderInt("Half Interval Size", &albert.albert.rotation_half_interval, 5, 100);
+        
+        // Display current interval range
+        int min_interval = std::max(1, albert.albert.rotation_average - albert.albert.rotation_half_interval);
+        int max_interval = albert.albert.rotation_average + albert.albert.rotation_half_interval;
+        ImGui::Text("Current interval range: %d - %d ticks", min_interval, max_interval);
+        
+        
+        ImGui::Text("Current piece: %s", 
+                   albert.current == hl::Piece::Rock ? "Rock" :
+                   albert.current == hl::Piece::Paper ? "Paper" : "Scissors");
+        
+        ImGui::Text("Last rotation tick: %d", albert.last_rot_tick);
+        ImGui::Text("Next rotation in: %d ticks", 
+                   albert.rot_period > 0 ? 
+                   (int)albert.rot_period - (int)(gs.tick - albert.last_rot_tick) : 0);
+        
+        // Manual controls for testing
+        if (ImGui::Button("Force Albert Rotation")) {
+            request_rotation(gs, albert);
+            
+            // Reset rotation period to get new random interval with current config
+            albert.rot_period = 0;
+        }
+        
+        ImGui::SameLine();
+        if (ImGui::Button("Reset Albert Timer")) {
+            albert.rot_period = 0; // Will reinitialize on next AI update
+        }
+        
+        if (ImGui::Button("Reset Albert Config")) {
+            albert.albert = hl::AlbertConfig{};
+            albert.rot_period = 0; // Will reinitialize with new config
+        }
+        
+        // Display AI parameters (read-only for now)
+        ImGui::Text("Rotation interval: 15-100 ticks (random)");
+        ImGui::Text("Current interval: %d ticks", albert.rot_period);
+    }
+
+    ImGui::End();
+}
+
+// ----------------- Game Wall -----------------
+static void restart_wall(WallView &v)
+{
+    v.wall.start(v.source == 0 ? hl::tournament_matchups() : hl::sweep_matchups(), v.games, 1);
+    v.watched = -1;
+    v.acc = 0.0;
+}
+
+void draw_game_wall(WallView &v, SDL_Renderer *ren, double dt, bool *open)
+{
+    ImGui::SetNextWindowPos(ImVec2(370, 450), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(640, 420), ImGuiCond_FirstUseEver);
+    ImGui::Begin("Game Wall", open);
+
+    const char *sources[] = {"Tournament roster", "Albert sweep"};
+    bool restart = v.wall.games() == 0;
+    restart |= ImGui::Combo("Games from", &v.source, sources, 2);
+    ImGui::SliderInt("Games", &v.games, hl::GameWall::MIN_GAMES, hl::GameWall::MAX_GAMES);
+    restart |= ImGui::IsItemDeactivatedAfterEdit(); // not on every frame of a drag
+    if (restart)
+        restart_wall(v);
+    ImGui::Checkbox("Running", &v.running);
+    ImGui::SameLine();
+    ImGui::SliderInt("Ticks per second", &v.ticks_per_second, 1, 240);
+
+    if (v.running)
+    {
+        v.acc += dt * v.ticks_per_second;
+        const int ticks = std::min(static_cast<int>(v.acc), v.ticks_per_second); // no catch-up spiral
+        v.acc -= static_cast<int>(v.acc);
+        if (!v.pool)
+            v.pool = std::make_unique<hl::JobScheduler>(
+                static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+        v.wall.step(ticks, *v.pool);
+    }
+
+    // One upload for all thumbnails that moved
+    const int w = v.wall.atlas_width(), h = v.wall.atlas_height();
+    if (w != v.tex_w || h != v.tex_h)
+    {
+        if (v.tex)
+            SDL_DestroyTexture(v.tex);
+        v.tex = SDL_CreateTexture(ren, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, w, h);
+        SDL_SetTextureScaleMode(v.tex, SDL_ScaleModeNearest);
+        v.tex_w = w;
+        v.tex_h = h;
+        v.wall.paint();
+        SDL_UpdateTexture(v.tex, nullptr, v.wall.atlas().data(), w * 4);
+    }
+    else if (v.wall.paint())
+        SDL_UpdateTexture(v.tex, nullptr, v.wall.atlas().data(), w * 4);
+
+    const ImVec2 avail = ImGui::GetContentRegionAvail();
+    const float scale = std::max(1.0f, std::min(avail.x / w, avail.y / h));
+    const ImVec2 p0 = ImGui::GetCursorScreenPos();
+    const ImVec2 p1(p0.x + w * scale, p0.y + h * scale);
+    ImGui::InvisibleButton("thumbnails", ImVec2(p1.x - p0.x, p1.y - p0.y));
+    ImDrawList *dl = ImGui::GetWindowDrawList();
+    dl->AddImage(reinterpret_cast<ImTextureID>(v.tex), p0, p1);
+
+    if (ImGui::IsItemHovered())
+    {
+        const ImVec2 m = ImGui::GetMousePos();
+        const int i = v.wall.game_at(static_cast<int>((m.x - p0.x) / scale), static_cast<int>((m.y - p0.y) / scale));
+        if (i >= 0)
+        {
+            int t[3];
+            v.wall.tally(i % v.wall.matchups(), t); // game i plays matchup i % count
+            ImGui::SetTooltip("#%d %s\ntick %d, game %d in this slot\nmatchup so far: %d-%d, %d timeouts", i,
+                              v.wall.matchup(i).label.c_str(), v.wall.game(i).tick, v.wall.played(i) + 1, t[0],
+                              t[1], t[2]);
+            if (ImGui::IsItemClicked())
+                v.watched = i;
+        }
+    }
+    if (v.watched >= 0)
+    {
+        const float tw = hl::GameWall::THUMB_W * scale, th = hl::GameWall::THUMB_H * scale;
+        const int cols = w / hl::GameWall::THUMB_W;
+        const ImVec2 q0(p0.x + (v.watched % cols) * tw, p0.y + (v.watched / cols) * th);
+        dl->AddRect(q0, ImVec2(q0.x + tw, q0.y + th), IM_COL32(255, 255, 255, 255));
+    }
+    ImGui::End();
+
+    if (v.watched >= 0)
+    {
+        bool keep = true;
+        draw_grid_imgui(v.wall.game(v.watched), "Arena (game wall)", &keep);
+        if (!keep)
+            v.watched = -1;
+    }
+}
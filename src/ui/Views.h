@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+
+#include <SDL.h>
+
+#include "core/Game.h"
+#include "sim/GameWall.h"
+
+// ----------------- ImGui Views -----------------
+// The PC build's windows, shared with handlords_renderbench, which draws
+// them offscreen. Each call adds one ImGui window to the current frame.
+
+// The arena, one rectangle and letter per cell; `fill` sizes the window to
+// the display every frame instead of 1000x700 on first use
+void draw_grid_imgui(const hl::GameState &gs, const char *title = "Arena", bool *open = nullptr, bool fill = false);
+
+// Phase, RNG and sampler switches, players and per-tick counters
+void draw_debug_ui(hl::GameState &gs, bool &slice_ticks, bool &async_ai, bool &game_wall);
+
+// Pair budget, tick rate and Albert's tuning
+void draw_tuning_ui(hl::GameState &gs);
+
+// Headless games as thumbnails of one texture, drawn as a single quad
+struct WallView
+{
+    hl::GameWall wall;
+    SDL_Texture *tex{nullptr};
+    int tex_w{0}, tex_h{0};
+    int source{0}; // 0 = tournament roster, 1 = Albert sweep
+    int games{64};
+    int ticks_per_second{15};
+    bool running{true};
+    double acc{0.0};
+    int watched{-1}; // game shown in the full arena view
+    std::unique_ptr<hl::JobScheduler> pool; // steps the games; made on first use
+};
+
+// Steps the wall by dt seconds of its tick rate, uploads the thumbnails
+// that moved and draws them; a clicked game opens in its own arena window
+void draw_game_wall(WallView &v, SDL_Renderer *ren, double dt, bool *open);
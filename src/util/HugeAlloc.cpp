@@ -0,0 +1,83 @@
+#include "util/HugeAlloc.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace hl
+{
+    static constexpr size_t HUGE_PAGE = size_t(2) << 20;
+    static std::atomic<size_t> g_mapped_bytes{0};
+
+    size_t huge_mapped_bytes() { return g_mapped_bytes.load(std::memory_order_relaxed); }
+
+    HugeBuffer::HugeBuffer(size_t bytes) : size_(bytes)
+    {
+        if (bytes == 0)
+            return;
+#if defined(__linux__)
+        // Only worth it past one huge page; small buffers stay on the heap
+        if (bytes >= HUGE_PAGE)
+        {
+            const size_t len = (bytes + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE;
+            void *p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p != MAP_FAILED)
+            {
+#if defined(MADV_HUGEPAGE)
+                huge_ = madvise(p, len, MADV_HUGEPAGE) == 0;
+#endif
+                data_ = static_cast<uint8_t *>(p);
+                mapped_ = len;
+                g_mapped_bytes += len;
+                return;
+            }
+        }
+#endif
+        data_ = static_cast<uint8_t *>(std::calloc(bytes, 1));
+        if (!data_)
+            throw std::bad_alloc();
+    }
+
+    HugeBuffer::~HugeBuffer() { release(); }
+
+    HugeBuffer::HugeBuffer(HugeBuffer &&other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)),
+          mapped_(std::exchange(other.mapped_, 0)), huge_(std::exchange(other.huge_, false))
+    {
+    }
+
+    HugeBuffer &HugeBuffer::operator=(HugeBuffer &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            mapped_ = std::exchange(other.mapped_, 0);
+            huge_ = std::exchange(other.huge_, false);
+        }
+        return *this;
+    }
+
+    void HugeBuffer::release()
+    {
+        if (!data_)
+            return;
+#if defined(__linux__)
+        if (mapped_)
+        {
+            munmap(data_, mapped_);
+            g_mapped_bytes -= mapped_;
+            data_ = nullptr;
+            return;
+        }
+#endif
+        std::free(data_);
+        data_ = nullptr;
+    }
+}
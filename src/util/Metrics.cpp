@@ -0,0 +1,403 @@
+#include "util/Metrics.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+#include "util/HugeAlloc.h"
+
+namespace hl
+{
+    static const uint32_t TICK_BOUNDS[METRIC_TICK_BUCKETS - 1] = {100, 200, 400, 800, 1600, 3200, 6400};
+    static const double TASK_BOUNDS[METRIC_TASK_BUCKETS - 1] = {0.001, 0.01, 0.1, 1.0, 10.0};
+
+    // Single writer: a relaxed load and store, no read-modify-write
+    static inline void bump(std::atomic<uint64_t> &a, uint64_t v)
+    {
+        a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+    }
+
+    struct alignas(64) Metrics::Shard
+    {
+        std::array<std::atomic<uint64_t>, METRIC_COUNTER_COUNT> c{};
+        std::array<std::atomic<uint64_t>, METRIC_TICK_BUCKETS> game_ticks{};
+        std::array<std::atomic<uint64_t>, METRIC_TASK_BUCKETS> task_seconds{};
+        std::string worker; // guarded by the registry mutex
+
+        MetricValues read() const
+        {
+            MetricValues v;
+            for (int i = 0; i < METRIC_COUNTER_COUNT; ++i)
+                v.c[i] = c[i].load(std::memory_order_relaxed);
+            for (int i = 0; i < METRIC_TICK_BUCKETS; ++i)
+                v.game_ticks[i] = game_ticks[i].load(std::memory_order_relaxed);
+            for (int i = 0; i < METRIC_TASK_BUCKETS; ++i)
+                v.task_seconds[i] = task_seconds[i].load(std::memory_order_relaxed);
+            return v;
+        }
+    };
+
+    // Hands a thread's shard back to the registry when the thread exits
+    struct ShardOwner
+    {
+        Metrics::Shard *shard{nullptr};
+        ~ShardOwner()
+        {
+            if (shard)
+                Metrics::instance().retire(shard);
+        }
+    };
+
+    static thread_local ShardOwner t_shard;
+
+    MetricValues &MetricValues::operator+=(const MetricValues &o)
+    {
+        for (int i = 0; i < METRIC_COUNTER_COUNT; ++i)
+            c[i] += o.c[i];
+        for (int i = 0; i < METRIC_TICK_BUCKETS; ++i)
+            game_ticks[i] += o.game_ticks[i];
+        for (int i = 0; i < METRIC_TASK_BUCKETS; ++i)
+            task_seconds[i] += o.task_seconds[i];
+        return *this;
+    }
+
+    Metrics &Metrics::instance()
+    {
+        static Metrics *m = new Metrics();
+        return *m;
+    }
+
+    Metrics::Metrics() : start_(std::chrono::steady_clock::now()) {}
+
+    Metrics::Shard &Metrics::local()
+    {
+        if (!t_shard.shard)
+        {
+            t_shard.shard = new Shard();
+            std::lock_guard<std::mutex> lock(mutex_);
+            live_.push_back(t_shard.shard);
+        }
+        return *t_shard.shard;
+    }
+
+    void Metrics::retire(Shard *s)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = std::find_if(retired_.begin(), retired_.end(), [&](const auto &w) { return w.first == s->worker; });
+        if (it == retired_.end())
+            retired_.emplace_back(s->worker, s->read());
+        else
+            it->second += s->read();
+        live_.erase(std::remove(live_.begin(), live_.end(), s), live_.end());
+        delete s;
+    }
+
+    void Metrics::add(MetricCounter c, uint64_t v) { bump(local().c[c], v); }
+
+    void Metrics::game(uint32_t ticks, uint64_t rng_draws)
+    {
+        Shard &s = local();
+        bump(s.c[METRIC_GAMES], 1);
+        bump(s.c[METRIC_TICKS], ticks);
+        bump(s.c[METRIC_RNG_DRAWS], rng_draws);
+        int b = 0;
+        while (b < METRIC_TICK_BUCKETS - 1 && ticks > TICK_BOUNDS[b])
+            ++b;
+        bump(s.game_ticks[b], 1);
+    }
+
+    void Metrics::task(double seconds)
+    {
+        Shard &s = local();
+        bump(s.c[METRIC_TASKS], 1);
+        bump(s.c[METRIC_BUSY_NS], static_cast<uint64_t>(seconds * 1e9));
+        int b = 0;
+        while (b < METRIC_TASK_BUCKETS - 1 && seconds > TASK_BOUNDS[b])
+            ++b;
+        bump(s.task_seconds[b], 1);
+    }
+
+    void Metrics::set_worker(const std::string &name)
+    {
+        Shard &s = local();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (s.worker == name)
+            return;
+        // Counts so far stay with the old name
+        auto it = std::find_if(retired_.begin(), retired_.end(), [&](const auto &w) { return w.first == s.worker; });
+        MetricValues v = s.read();
+        if (it == retired_.end())
+            retired_.emplace_back(s.worker, v);
+        else
+            it->second += v;
+        for (auto &a : s.c)
+            a.store(0, std::memory_order_relaxed);
+        for (auto &a : s.game_ticks)
+            a.store(0, std::memory_order_relaxed);
+        for (auto &a : s.task_seconds)
+            a.store(0, std::memory_order_relaxed);
+        s.worker = name;
+    }
+
+    int Metrics::add_gauge(const std::string &name, const std::string &help, std::function<double()> fn)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        gauges_.push_back(Gauge{next_gauge_, name, help, std::move(fn)});
+        return next_gauge_++;
+    }
+
+    void Metrics::remove_gauge(int id)
+    {
+        // Waits for an exposition that may be reading the gauge
+        std::lock_guard<std::mutex> lock(mutex_);
+        gauges_.erase(std::remove_if(gauges_.begin(), gauges_.end(), [&](const Gauge &g) { return g.id == id; }),
+                      gauges_.end());
+    }
+
+    MetricValues Metrics::totals(std::vector<std::pair<std::string, MetricValues>> &workers)
+    {
+        workers = retired_;
+        for (const Shard *s : live_)
+        {
+            auto it = std::find_if(workers.begin(), workers.end(), [&](const auto &w) { return w.first == s->worker; });
+            if (it == workers.end())
+                workers.emplace_back(s->worker, s->read());
+            else
+                it->second += s->read();
+        }
+        MetricValues t;
+        for (const auto &w : workers)
+            t += w.second;
+        std::sort(workers.begin(), workers.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+        return t;
+    }
+
+    static void family(std::string &out, const char *name, const char *type, const char *help)
+    {
+        out += "# TYPE ";
+        out += name;
+        out += " ";
+        out += type;
+        out += "\n# HELP ";
+        out += name;
+        out += " ";
+        out += help;
+        out += "\n";
+    }
+
+    static void sample(std::string &out, const std::string &name, const std::string &labels, double v)
+    {
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), " %.17g\n", v);
+        out += name;
+        if (!labels.empty())
+            out += "{" + labels + "}";
+        out += buf;
+    }
+
+    static void sample(std::string &out, const std::string &name, const std::string &labels, uint64_t v)
+    {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), " %" PRIu64 "\n", v);
+        out += name;
+        if (!labels.empty())
+            out += "{" + labels + "}";
+        out += buf;
+    }
+
+    static std::string worker_label(const std::string &name)
+    {
+        return "worker=\"" + (name.empty() ? std::string("other") : name) + "\"";
+    }
+
+    std::string Metrics::exposition(MetricsWindow &window)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto now = std::chrono::steady_clock::now();
+        const auto since = window.last == std::chrono::steady_clock::time_point{} ? start_ : window.last;
+        const double dt = std::chrono::duration<double>(now - since).count();
+        std::vector<std::pair<std::string, MetricValues>> workers;
+        const MetricValues t = totals(workers);
+        // Unnamed threads only get a series once they run pool work
+        workers.erase(std::remove_if(workers.begin(), workers.end(), [](const auto &w)
+                                     { return w.first.empty() && !w.second.c[METRIC_TASKS]; }),
+                      workers.end());
+
+        std::string out;
+        family(out, "handlords_games", "counter", "Games finished (won, lost or timed out).");
+        sample(out, "handlords_games_total", "", t.c[METRIC_GAMES]);
+        family(out, "handlords_ticks", "counter", "Ticks played by finished games.");
+        sample(out, "handlords_ticks_total", "", t.c[METRIC_TICKS]);
+        family(out, "handlords_rng_draws", "counter", "Game RNG draws made by finished games.");
+        sample(out, "handlords_rng_draws_total", "", t.c[METRIC_RNG_DRAWS]);
+
+        const double inv = dt > 0.0 ? 1.0 / dt : 0.0;
+        family(out, "handlords_games_per_second", "gauge",
+               "Games finished per second since this consumer's previous exposition.");
+        sample(out, "handlords_games_per_second", "", (t.c[METRIC_GAMES] - window.totals.c[METRIC_GAMES]) * inv);
+        family(out, "handlords_ticks_per_second", "gauge",
+               "Ticks of finished games per second since this consumer's previous exposition.");
+        sample(out, "handlords_ticks_per_second", "", (t.c[METRIC_TICKS] - window.totals.c[METRIC_TICKS]) * inv);
+
+        family(out, "handlords_worker_tasks", "counter", "Work items a worker took from its pool's shared queue.");
+        for (const auto &w : workers)
+            sample(out, "handlords_worker_tasks_total", worker_label(w.first), w.second.c[METRIC_TASKS]);
+        family(out, "handlords_worker_busy_seconds", "counter", "Time a worker spent running work items.");
+        for (const auto &w : workers)
+            sample(out, "handlords_worker_busy_seconds_total", worker_label(w.first),
+                   w.second.c[METRIC_BUSY_NS] * 1e-9);
+        family(out, "handlords_worker_utilization", "gauge",
+               "Busy fraction of a worker since this consumer's previous exposition.");
+        std::vector<std::pair<std::string, uint64_t>> busy;
+        for (const auto &w : workers)
+        {
+            uint64_t before = 0;
+            for (const auto &b : window.busy)
+            {
+                if (b.first == w.first)
+                    before = b.second;
+            }
+            const uint64_t ns = w.second.c[METRIC_BUSY_NS];
+            busy.emplace_back(w.first, ns);
+            if (!w.first.empty())
+                sample(out, "handlords_worker_utilization", worker_label(w.first),
+                       std::min(1.0, (ns - std::min(ns, before)) * 1e-9 * inv));
+        }
+
+        family(out, "handlords_game_ticks", "histogram", "Length of finished games in ticks.");
+        uint64_t cum = 0;
+        for (int b = 0; b < METRIC_TICK_BUCKETS; ++b)
+        {
+            cum += t.game_ticks[b];
+            const std::string le = b < METRIC_TICK_BUCKETS - 1 ? std::to_string(TICK_BOUNDS[b]) : "+Inf";
+            sample(out, "handlords_game_ticks_bucket", "le=\"" + le + "\"", cum);
+        }
+        sample(out, "handlords_game_ticks_count", "", cum);
+        sample(out, "handlords_game_ticks_sum", "", t.c[METRIC_TICKS]);
+
+        family(out, "handlords_task_seconds", "histogram", "Time to run one pool work item.");
+        cum = 0;
+        for (int b = 0; b < METRIC_TASK_BUCKETS; ++b)
+        {
+            cum += t.task_seconds[b];
+            char le[32];
+            if (b < METRIC_TASK_BUCKETS - 1)
+                std::snprintf(le, sizeof(le), "le=\"%g\"", TASK_BOUNDS[b]);
+            else
+                std::snprintf(le, sizeof(le), "le=\"+Inf\"");
+            sample(out, "handlords_task_seconds_bucket", le, cum);
+        }
+        sample(out, "handlords_task_seconds_count", "", cum);
+        sample(out, "handlords_task_seconds_sum", "", t.c[METRIC_BUSY_NS] * 1e-9);
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+        const struct mallinfo2 mi = mallinfo2();
+        family(out, "handlords_heap_in_use_bytes", "gauge", "malloc bytes in use.");
+        sample(out, "handlords_heap_in_use_bytes", "", static_cast<uint64_t>(mi.uordblks + mi.hblkhd));
+        family(out, "handlords_heap_free_bytes", "gauge", "malloc bytes held in free chunks.");
+        sample(out, "handlords_heap_free_bytes", "", static_cast<uint64_t>(mi.fordblks));
+        family(out, "handlords_heap_mmapped_bytes", "gauge", "malloc bytes in separately mmap'd chunks.");
+        sample(out, "handlords_heap_mmapped_bytes", "", static_cast<uint64_t>(mi.hblkhd));
+#endif
+        family(out, "handlords_huge_buffer_bytes", "gauge", "Bytes mmap'd by huge-page arena buffers.");
+        sample(out, "handlords_huge_buffer_bytes", "", static_cast<uint64_t>(huge_mapped_bytes()));
+#if defined(__linux__)
+        if (std::FILE *f = std::fopen("/proc/self/statm", "r"))
+        {
+            long pages = 0, rss = 0;
+            if (std::fscanf(f, "%ld %ld", &pages, &rss) == 2)
+            {
+                family(out, "handlords_resident_bytes", "gauge", "Resident set size.");
+                sample(out, "handlords_resident_bytes", "",
+                       static_cast<uint64_t>(rss) * static_cast<uint64_t>(sysconf(_SC_PAGESIZE)));
+            }
+            std::fclose(f);
+        }
+#endif
+        family(out, "handlords_uptime_seconds", "gauge", "Seconds since the metrics registry started.");
+        sample(out, "handlords_uptime_seconds", "", std::chrono::duration<double>(now - start_).count());
+
+        // Gauges of one name are summed (e.g. the queues of concurrent pools)
+        std::vector<const Gauge *> done;
+        for (const auto &g : gauges_)
+        {
+            if (std::any_of(done.begin(), done.end(), [&](const Gauge *d) { return d->name == g.name; }))
+                continue;
+            double v = 0.0;
+            for (const auto &h : gauges_)
+            {
+                if (h.name == g.name)
+                    v += h.fn();
+            }
+            family(out, g.name.c_str(), "gauge", g.help.c_str());
+            sample(out, g.name, "", v);
+            done.push_back(&g);
+        }
+        out += "# EOF\n";
+
+        window.last = now;
+        window.totals = t;
+        window.busy = std::move(busy);
+        return out;
+    }
+
+    bool Metrics::write_file(const std::string &path, MetricsWindow &window, std::string &err)
+    {
+        const std::string text = exposition(window);
+        const std::string tmp = path + ".tmp";
+        std::FILE *f = std::fopen(tmp.c_str(), "w");
+        if (!f)
+        {
+            err = "cannot write " + tmp;
+            return false;
+        }
+        const bool ok = std::fwrite(text.data(), 1, text.size(), f) == text.size();
+        if (std::fclose(f) != 0 || !ok || std::rename(tmp.c_str(), path.c_str()) != 0)
+        {
+            err = "cannot write " + path;
+            return false;
+        }
+        return true;
+    }
+
+    bool MetricsFileWriter::start(const std::string &path, double interval_s, std::string &err)
+    {
+        stop();
+        path_ = path;
+        interval_s_ = std::max(0.1, interval_s);
+        if (!Metrics::instance().write_file(path_, window_, err))
+            return false;
+        stop_ = false;
+        thread_ = std::thread([this]
+                              {
+                                  std::unique_lock<std::mutex> lock(mutex_);
+                                  const auto period = std::chrono::duration<double>(interval_s_);
+                                  while (!cv_.wait_for(lock, period, [this] { return stop_; }))
+                                  {
+                                      std::string e;
+                                      Metrics::instance().write_file(path_, window_, e);
+                                  } });
+        return true;
+    }
+
+    void MetricsFileWriter::stop()
+    {
+        if (!thread_.joinable())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+        std::string err;
+        Metrics::instance().write_file(path_, window_, err);
+    }
+}
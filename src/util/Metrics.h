@@ -0,0 +1,142 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ----------------- Live Metrics -----------------
+// Process-wide counters in OpenMetrics text format. Every thread counts into
+// its own cache-line-sized shard with plain relaxed stores (one writer, no
+// locked instructions); shards are only summed when an exposition is built.
+// Nothing is counted per pair: games add their ticks and RNG draws once, when
+// they end, and pool workers once per work item.
+namespace hl
+{
+    enum MetricCounter
+    {
+        METRIC_GAMES,
+        METRIC_TICKS,     // ticks of finished games
+        METRIC_RNG_DRAWS, // game RNG draws of finished games
+        METRIC_TASKS,     // work items taken from a pool's queue
+        METRIC_BUSY_NS,   // time spent running them
+        METRIC_COUNTER_COUNT
+    };
+
+    constexpr int METRIC_TICK_BUCKETS = 8; // game length: 100 .. 6400 ticks, +Inf
+    constexpr int METRIC_TASK_BUCKETS = 6; // work item time: 1 ms .. 10 s, +Inf
+
+    struct MetricValues
+    {
+        std::array<uint64_t, METRIC_COUNTER_COUNT> c{};
+        std::array<uint64_t, METRIC_TICK_BUCKETS> game_ticks{};
+        std::array<uint64_t, METRIC_TASK_BUCKETS> task_seconds{};
+
+        MetricValues &operator+=(const MetricValues &o);
+    };
+
+    // One consumer's rate window (a metrics file, a socket client). Each keeps
+    // its own, so consumers do not reset each other's rates; a fresh window
+    // measures from registry start.
+    struct MetricsWindow
+    {
+        std::chrono::steady_clock::time_point last{};
+        MetricValues totals;
+        std::vector<std::pair<std::string, uint64_t>> busy; // per worker, in ns
+    };
+
+    class Metrics
+    {
+    public:
+        // The process registry (never destroyed, so exiting threads can retire)
+        static Metrics &instance();
+
+        // Calling thread's counters
+        void add(MetricCounter c, uint64_t v);
+        void game(uint32_t ticks, uint64_t rng_draws);
+        void task(double seconds);
+
+        // Per-worker series ("batch/3", "sched/0") for the calling thread;
+        // unnamed threads only count towards the totals
+        void set_worker(const std::string &name);
+
+        // Gauges read at exposition time; gauges sharing a name are summed
+        int add_gauge(const std::string &name, const std::string &help, std::function<double()> fn);
+        void remove_gauge(int id);
+
+        // The whole exposition, ending in "# EOF". Rates and utilization
+        // cover the time since the previous call with the same window.
+        std::string exposition(MetricsWindow &window);
+        // Writes it to path through a temporary file, so readers never see a
+        // half-written one
+        bool write_file(const std::string &path, MetricsWindow &window, std::string &err);
+
+        struct Shard;
+
+    private:
+        Metrics();
+        Shard &local();
+        void retire(Shard *s);
+        MetricValues totals(std::vector<std::pair<std::string, MetricValues>> &workers);
+
+        friend struct ShardOwner;
+
+        std::mutex mutex_;
+        std::vector<Shard *> live_;
+        std::vector<std::pair<std::string, MetricValues>> retired_; // by worker name; "" = unnamed
+        struct Gauge
+        {
+            int id{0};
+            std::string name, help;
+            std::function<double()> fn;
+        };
+        std::vector<Gauge> gauges_;
+        int next_gauge_{1};
+
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    // Scoped gauge registration
+    class MetricGauge
+    {
+    public:
+        MetricGauge(const std::string &name, const std::string &help, std::function<double()> fn)
+            : id_(Metrics::instance().add_gauge(name, help, std::move(fn)))
+        {
+        }
+        ~MetricGauge() { Metrics::instance().remove_gauge(id_); }
+        MetricGauge(const MetricGauge &) = delete;
+        MetricGauge &operator=(const MetricGauge &) = delete;
+
+    private:
+        int id_;
+    };
+
+    // Rewrites a metrics file every interval (and once more when stopped)
+    class MetricsFileWriter
+    {
+    public:
+        MetricsFileWriter() = default;
+        ~MetricsFileWriter() { stop(); }
+        MetricsFileWriter(const MetricsFileWriter &) = delete;
+        MetricsFileWriter &operator=(const MetricsFileWriter &) = delete;
+
+        bool start(const std::string &path, double interval_s, std::string &err);
+        void stop();
+
+    private:
+        std::string path_;
+        double interval_s_{5.0};
+        MetricsWindow window_;
+        std::thread thread_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool stop_{false};
+    };
+}
@@ -0,0 +1,130 @@
+#include "util/PerfCounters.h"
+
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace hl
+{
+    PerfCounters::~PerfCounters() { close(); }
+
+    const char *PerfCounters::name(int event)
+    {
+        static const char *names[PERF_EVENT_COUNT] = {"cycles", "instructions", "L1d misses", "LLC misses",
+                                                      "branch misses"};
+        return names[event];
+    }
+
+    bool PerfCounters::available() const
+    {
+        for (int fd : fds_)
+        {
+            if (fd >= 0)
+                return true;
+        }
+        return false;
+    }
+
+#if defined(__linux__)
+    static int open_event(uint32_t type, uint64_t config)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        // Kernel and hypervisor counting needs perf_event_paranoid < 2
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    bool PerfCounters::open(std::string &err)
+    {
+        close();
+        static const struct
+        {
+            uint32_t type;
+            uint64_t config;
+        } events[PERF_EVENT_COUNT] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        };
+
+        err.clear();
+        int first_errno = 0;
+        for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+        {
+            fds_[i] = open_event(events[i].type, events[i].config);
+            if (fds_[i] < 0)
+            {
+                if (!first_errno)
+                    first_errno = errno;
+                err += err.empty() ? "unavailable: " : ", ";
+                err += name(i);
+                continue;
+            }
+            ioctl(fds_[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fds_[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+        if (!available())
+        {
+            err = std::string("perf_event_open: ") + std::strerror(first_errno);
+            if (first_errno == EACCES || first_errno == EPERM)
+                err += " (see /proc/sys/kernel/perf_event_paranoid)";
+            else if (first_errno == ENOENT || first_errno == EOPNOTSUPP)
+                err += " (no hardware PMU exposed, e.g. in a VM)";
+            return false;
+        }
+        return true;
+    }
+
+    void PerfCounters::close()
+    {
+        for (int &fd : fds_)
+        {
+            if (fd >= 0)
+                ::close(fd);
+            fd = -1;
+        }
+    }
+
+    PerfSample PerfCounters::read() const
+    {
+        PerfSample s;
+        for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+        {
+            uint64_t buf[3]; // value, time enabled, time running
+            if (fds_[i] < 0 || ::read(fds_[i], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf)))
+                continue;
+            // Scale up counts the kernel only sampled part of the time
+            s.v[i] = buf[2] && buf[2] < buf[1]
+                         ? static_cast<uint64_t>(static_cast<double>(buf[0]) * buf[1] / buf[2])
+                         : buf[0];
+        }
+        return s;
+    }
+#else
+    bool PerfCounters::open(std::string &err)
+    {
+        err = "hardware counters are only supported on Linux";
+        return false;
+    }
+
+    void PerfCounters::close() {}
+
+    PerfSample PerfCounters::read() const { return PerfSample{}; }
+#endif
+}
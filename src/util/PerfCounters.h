@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+// ----------------- Hardware Counters -----------------
+namespace hl
+{
+    enum PerfEvent
+    {
+        PERF_CYCLES,
+        PERF_INSTRUCTIONS,
+        PERF_L1D_MISSES, // L1 data-cache read misses
+        PERF_LLC_MISSES,
+        PERF_BRANCH_MISSES,
+        PERF_EVENT_COUNT
+    };
+
+    struct PerfSample
+    {
+        std::array<uint64_t, PERF_EVENT_COUNT> v{};
+
+        PerfSample operator-(const PerfSample &o) const
+        {
+            PerfSample d;
+            for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+                d.v[i] = v[i] - o.v[i];
+            return d;
+        }
+        PerfSample &operator+=(const PerfSample &o)
+        {
+            for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+                v[i] += o.v[i];
+            return *this;
+        }
+    };
+
+    // User-space hardware counters for the calling thread (perf_event_open on
+    // Linux). Each event is opened on its own, so a CPU or VM without, say, an
+    // LLC event still reports the rest. Counts are scaled when the kernel
+    // multiplexes them. Where nothing can be opened (no PMU, perf_event_paranoid,
+    // seccomp, other OSes) available() is false and read() returns zeros.
+    class PerfCounters
+    {
+    public:
+        PerfCounters() = default;
+        ~PerfCounters();
+        PerfCounters(const PerfCounters &) = delete;
+        PerfCounters &operator=(const PerfCounters &) = delete;
+
+        // Opens and starts the counters. Returns true if at least one event
+        // opened; err then lists the events that did not, otherwise why none did.
+        bool open(std::string &err);
+        void close();
+
+        bool available() const;
+        bool has(int event) const { return fds_[event] >= 0; }
+        PerfSample read() const;
+
+        static const char *name(int event);
+
+    private:
+        std::array<int, PERF_EVENT_COUNT> fds_{{-1, -1, -1, -1, -1}};
+    };
+}
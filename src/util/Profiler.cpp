@@ -0,0 +1,142 @@
+#include "util/Profiler.h"
+
+#include <algorithm>
+
+namespace hl
+{
+    Profiler::Profiler() = default;
+    Profiler::~Profiler() = default;
+
+    bool Profiler::enable_hw_counters(std::string &err)
+    {
+        if (!perf_)
+            perf_ = std::make_unique<PerfCounters>();
+        const bool ok = perf_->open(err);
+        perf_error_ = err;
+        return ok;
+    }
+
+    int Profiler::phase(const char *name)
+    {
+        for (size_t i = 0; i < phases_.size(); ++i)
+        {
+            if (phases_[i].name == name)
+                return static_cast<int>(i);
+        }
+        Phase p;
+        p.name = name;
+        phases_.push_back(p);
+        return static_cast<int>(phases_.size() - 1);
+    }
+
+    void Profiler::add_time(int phase, double seconds)
+    {
+        Phase &p = phases_[phase];
+        p.total += seconds;
+        p.this_tick += seconds;
+        p.calls++;
+    }
+
+    void Profiler::add_counts(int phase, const PerfSample &delta) { phases_[phase].hw += delta; }
+
+    void Profiler::set_counter(const char *name, double value, const char *unit)
+    {
+        for (auto &c : counters_)
+        {
+            if (c.name == name)
+            {
+                c.value = value;
+                c.unit = unit;
+                return;
+            }
+        }
+        counters_.push_back(Counter{name, value, unit});
+    }
+
+    void Profiler::end_tick()
+    {
+        for (auto &p : phases_)
+        {
+            if (p.window.size() < WINDOW)
+                p.window.push_back(static_cast<float>(p.this_tick));
+            else
+                p.window[ticks_ % WINDOW] = static_cast<float>(p.this_tick);
+            p.this_tick = 0.0;
+        }
+        ticks_++;
+    }
+
+    std::vector<Profiler::PhaseStats> Profiler::phase_stats() const
+    {
+        std::vector<PhaseStats> out;
+        for (const auto &p : phases_)
+        {
+            PhaseStats s;
+            s.name = p.name;
+            s.total = p.total;
+            s.calls = p.calls;
+            s.hw = p.hw;
+            if (!p.window.empty())
+            {
+                std::vector<float> v(p.window);
+                std::sort(v.begin(), v.end());
+                s.p50 = v[v.size() / 2];
+                s.p99 = v[std::min(v.size() - 1, v.size() * 99 / 100)];
+                s.max = v.back();
+            }
+            out.push_back(s);
+        }
+        return out;
+    }
+
+    void Profiler::report(std::FILE *out) const
+    {
+        std::fprintf(out, "%-14s %10s %10s %10s %10s %10s\n", "phase", "total ms", "mean us", "p50 us",
+                     "p99 us", "max us");
+        for (const auto &s : phase_stats())
+        {
+            std::fprintf(out, "%-14s %10.1f %10.1f %10.1f %10.1f %10.1f\n", s.name.c_str(), s.total * 1e3,
+                         ticks_ ? s.total * 1e6 / ticks_ : 0.0, s.p50 * 1e6, s.p99 * 1e6, s.max * 1e6);
+        }
+        if (hw_counters())
+        {
+            std::fprintf(out, "%-14s %10s %10s %6s %10s %10s %10s   (per tick)\n", "phase", "kcycles", "kinstr",
+                         "IPC", "L1d miss", "LLC miss", "br miss");
+            const double per = ticks_ ? 1.0 / ticks_ : 0.0;
+            auto col = [&](const PerfSample &hw, int e, double scale)
+            {
+                if (perf_->has(e))
+                    std::fprintf(out, " %10.1f", hw.v[e] * per * scale);
+                else
+                    std::fprintf(out, " %10s", "-");
+            };
+            for (const auto &s : phase_stats())
+            {
+                std::fprintf(out, "%-14s", s.name.c_str());
+                col(s.hw, PERF_CYCLES, 1e-3);
+                col(s.hw, PERF_INSTRUCTIONS, 1e-3);
+                if (s.hw.v[PERF_CYCLES] && perf_->has(PERF_INSTRUCTIONS))
+                    std::fprintf(out, " %6.2f", static_cast<double>(s.hw.v[PERF_INSTRUCTIONS]) / s.hw.v[PERF_CYCLES]);
+                else
+                    std::fprintf(out, " %6s", "-");
+                col(s.hw, PERF_L1D_MISSES, 1.0);
+                col(s.hw, PERF_LLC_MISSES, 1.0);
+                col(s.hw, PERF_BRANCH_MISSES, 1.0);
+                std::fprintf(out, "\n");
+            }
+            if (!perf_error_.empty())
+                std::fprintf(out, "hw counters %s\n", perf_error_.c_str());
+        }
+        else if (perf_)
+            std::fprintf(out, "hw counters unavailable: %s\n", perf_error_.c_str());
+        for (const auto &c : counters_)
+            std::fprintf(out, "%-28s %14.1f %s\n", c.name.c_str(), c.value, c.unit.c_str());
+    }
+
+    void Profiler::reset()
+    {
+        phases_.clear();
+        counters_.clear();
+        ticks_ = 0;
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "util/PerfCounters.h"
+
+// ----------------- Profiler -----------------
+namespace hl
+{
+    // Per-tick phase timer plus named counters. Phases accumulate time
+    // between begin/end (or a Scope) and end_tick() closes the tick, keeping
+    // a window of recent per-tick times for percentiles. With hardware
+    // counters enabled, each Scope also adds its counter deltas to the phase.
+    class Profiler
+    {
+    public:
+        Profiler();
+        ~Profiler();
+
+        using clock = std::chrono::steady_clock;
+        static constexpr size_t WINDOW = 4096; // ticks kept for percentiles
+
+        // Returns the id of phase `name`, registering it on first use
+        int phase(const char *name);
+
+        void add_time(int phase, double seconds);
+        void add_counts(int phase, const PerfSample &delta);
+
+        // Opens hardware counters for the calling thread; phases must then be
+        // timed on that thread. Returns false with the reason when they are not
+        // permitted, and the profiler keeps timing only.
+        bool enable_hw_counters(std::string &err);
+        bool hw_counters() const { return perf_ && perf_->available(); }
+
+        // Times a phase; a null profiler makes it a no-op
+        class Scope
+        {
+        public:
+            Scope(Profiler &p, int phase) : Scope(&p, phase) {}
+            Scope(Profiler *p, int phase) : p_(p), phase_(phase)
+            {
+                if (!p_)
+                    return;
+                if (p_->hw_counters())
+                    c0_ = p_->perf_->read();
+                t0_ = clock::now();
+            }
+            ~Scope()
+            {
+                if (!p_)
+                    return;
+                p_->add_time(phase_, std::chrono::duration<double>(clock::now() - t0_).count());
+                if (p_->hw_counters())
+                    p_->add_counts(phase_, p_->perf_->read() - c0_);
+            }
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+
+        private:
+            Profiler *p_;
+            int phase_;
+            clock::time_point t0_;
+            PerfSample c0_;
+        };
+
+        // Gauge-style counter, overwritten on each call
+        void set_counter(const char *name, double value, const char *unit = "");
+
+        void end_tick();
+        int ticks() const { return ticks_; }
+
+        // Phase table (total, mean/p50/p99/max per tick), the hardware counters
+        // per tick and IPC for each phase, then the gauge counters
+        void report(std::FILE *out) const;
+        void reset();
+
+        struct PhaseStats
+        {
+            std::string name;
+            double total{0.0};
+            long long calls{0};
+            double p50{0.0}, p99{0.0}, max{0.0}; // per tick, seconds
+            PerfSample hw;                       // totals, zero without counters
+        };
+        std::vector<PhaseStats> phase_stats() const;
+
+    private:
+        struct Phase
+        {
+            std::string name;
+            double total{0.0};
+            double this_tick{0.0};
+            long long calls{0};
+            std::vector<float> window; // ring of per-tick times
+            PerfSample hw;
+        };
+        struct Counter
+        {
+            std::string name;
+            double value{0.0};
+            std::string unit;
+        };
+
+        std::vector<Phase> phases_;
+        std::vector<Counter> counters_;
+        int ticks_{0};
+        std::unique_ptr<PerfCounters> perf_;
+        std::string perf_error_;
+    };
+}
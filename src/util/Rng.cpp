@@ -0,0 +1,70 @@
+#include "util/Rng.h"
+
+uint16_t lfsr16_step(uint16_t &s)
+{
+    // taps: 16,14,13,11 (poly 0xB400)
+    uint16_t bit = ((s >> 0) ^ (s >> 2) ^ (s >> 3) ^ (s >> 5)) & 1u;
+    s = (s >> 1) | (bit << 15);
+    return s;
+}
+
+namespace
+{
+    // k steps of a linear register: state = lo[low byte] ^ hi[high byte]
+    struct LfsrJump
+    {
+        uint16_t lo[256];
+        uint16_t hi[256];
+    };
+
+    constexpr uint16_t lfsr16_advance(uint16_t s, int steps)
+    {
+        for (int i = 0; i < steps; ++i)
+        {
+            const uint16_t bit = ((s >> 0) ^ (s >> 2) ^ (s >> 3) ^ (s >> 5)) & 1u;
+            s = static_cast<uint16_t>((s >> 1) | (bit << 15));
+        }
+        return s;
+    }
+
+    constexpr LfsrJump make_jump(int steps)
+    {
+        LfsrJump j{};
+        for (int b = 0; b < 256; ++b)
+        {
+            j.lo[b] = lfsr16_advance(static_cast<uint16_t>(b), steps);
+            j.hi[b] = lfsr16_advance(static_cast<uint16_t>(b << 8), steps);
+        }
+        return j;
+    }
+
+    // Built at compile time: 1 KB of read-only data each
+    constexpr LfsrJump JUMP8 = make_jump(8);
+    constexpr LfsrJump JUMP16 = make_jump(16);
+}
+
+uint16_t lfsr16_step8(uint16_t &s)
+{
+    s = JUMP8.lo[s & 0xFF] ^ JUMP8.hi[s >> 8];
+    return s;
+}
+
+uint16_t lfsr16_step16(uint16_t &s)
+{
+    s = JUMP16.lo[s & 0xFF] ^ JUMP16.hi[s >> 8];
+    return s;
+}
+
+uint32_t rngu(hl::GameState &gs)
+{
+    gs.rng_draws++;
+    if (gs.use_system_rng) {
+        return gs.system_rng() & 0xFFFF; // Return 16-bit value like LFSR
+    } else if (gs.lfsr_stride == 16) {
+        return lfsr16_step16(gs.rng16);
+    } else if (gs.lfsr_stride == 8) {
+        return lfsr16_step8(gs.rng16);
+    } else {
+        return lfsr16_step(gs.rng16);
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+#include "core/Game.h"
+
+// ----------------- Utility -----------------
+// 16-bit Fibonacci LFSR, taps 16,14,13,11 (poly 0xB400)
+uint16_t lfsr16_step(uint16_t &s);
+
+// The same LFSR advanced 8 or 16 steps per call through two byte-indexed
+// tables, so successive draws are not one-bit shifts of each other. Every
+// stride is coprime to the period, so each keeps all 65535 states.
+uint16_t lfsr16_step8(uint16_t &s);
+uint16_t lfsr16_step16(uint16_t &s);
+
+// Returns 0..65535 and advances the game RNG
+uint32_t rngu(hl::GameState &gs);
+
+namespace hl
+{
+    // splitmix64: for engines whose arenas outgrow 16-bit coordinates
+    struct Rng64
+    {
+        uint64_t s{0x9E3779B97F4A7C15ull};
+
+        uint64_t next()
+        {
+            uint64_t z = (s += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        // Uniform in [0, n) from the high 32 bits (multiply-shift, no division)
+        static uint32_t scale(uint64_t r, uint32_t n)
+        {
+            return static_cast<uint32_t>(((r >> 32) * n) >> 32);
+        }
+    };
+}